@@ -0,0 +1,75 @@
+/**
+ *  \file       FileBin_AddrIndex.h
+ *  \brief      Address to symbol reverse lookup
+ *
+ *  \version    1.0
+ *  \date       Oct 18, 2026
+ *  \author     Xavier Descarrega - DEVE embedded designs <info@deve.tech>
+ *
+ *  \copyright  MIT License
+ *
+ *              Copyright (c) 2026 Xavier Descarrega
+ *
+ *              Permission is hereby granted, free of charge, to any person obtaining a copy
+ *              of this software and associated documentation files (the "Software"), to deal
+ *              in the Software without restriction, including without limitation the rights
+ *              to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *              copies of the Software, and to permit persons to whom the Software is
+ *              furnished to do so, subject to the following conditions:
+ *
+ *              The above copyright notice and this permission notice shall be included in all
+ *              copies or substantial portions of the Software.
+ *
+ *              THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *              IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *              FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *              AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ *              LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *              OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *              SOFTWARE.
+ *
+ */
+
+#ifndef FILEBIN_ADDRINDEX_H
+#define FILEBIN_ADDRINDEX_H
+
+#include <cstdint>
+#include <vector>
+#include "FileBin_SymbolIndex.h"
+
+#define FILEBIN_ADDRINDEX_NONE 0xFFFFFFFFu
+
+typedef struct
+{
+    uint32_t Id; /* Innermost symbol index entry holding the address, FILEBIN_ADDRINDEX_NONE if none */
+    uint32_t ElemIdx; /* Element of a scalar array leaf, 0 otherwise */
+    uint32_t Offset; /* Byte offset inside that element */
+} FileBin_AddrIndex_ResultType;
+
+/*
+ * Symbol ranges (variables, members, array elements) are nested, so they are flattened once into
+ * disjoint segments that each know their innermost symbol. A lookup is a predecessor search over the
+ * segment starts, kept in Eytzinger (BFS) order so that the search walks the array without branches.
+ */
+class FileBin_AddrIndex
+{
+    private:
+
+        const FileBin_SymbolIndex* Index = nullptr;
+        std::vector<uint32_t> Eytzinger; /* Segment starts in BFS order, slot 0 unused */
+        std::vector<uint32_t> EytzingerPrevId; /* Symbol of the segment preceding the one of every slot */
+        uint32_t LastId = FILEBIN_ADDRINDEX_NONE; /* Symbol of the last segment */
+
+        void BuildEytzinger(const std::vector<uint32_t>& SegStart, const std::vector<uint32_t>& SegId, uint32_t& Src, uint32_t Slot);
+
+    public:
+
+        /* Index must outlive this object */
+        void Build(const FileBin_SymbolIndex& Index);
+        void Clear();
+
+        uint32_t Segments() const;
+        FileBin_AddrIndex_ResultType Find(uint32_t Addr) const;
+};
+
+#endif // FILEBIN_ADDRINDEX_H
@@ -0,0 +1,85 @@
+/**
+ *  \file       FileBin_BlockStore.h
+ *  \brief      Content-hashed copy-on-write blocks shared between memory images
+ *
+ *  \version    1.0
+ *  \date       Oct 18, 2026
+ *  \author     Xavier Descarrega - DEVE embedded designs <info@deve.tech>
+ *
+ *  \copyright  MIT License
+ *
+ *              Copyright (c) 2026 Xavier Descarrega
+ *
+ *              Permission is hereby granted, free of charge, to any person obtaining a copy
+ *              of this software and associated documentation files (the "Software"), to deal
+ *              in the Software without restriction, including without limitation the rights
+ *              to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *              copies of the Software, and to permit persons to whom the Software is
+ *              furnished to do so, subject to the following conditions:
+ *
+ *              The above copyright notice and this permission notice shall be included in all
+ *              copies or substantial portions of the Software.
+ *
+ *              THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *              IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *              FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *              AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ *              LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *              OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *              SOFTWARE.
+ *
+ */
+
+#ifndef FILEBIN_BLOCKSTORE_H
+#define FILEBIN_BLOCKSTORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#define LIBPARSER_BLOCKSTORE_BYTES (1u << 12) /* Block size, a power of two */
+
+/* Fixed-size piece of a memory image, aligned to its size in the address space */
+typedef struct
+{
+    uint64_t Hash; /* Of Byte, set when interned */
+    bool isShared; /* Interned: other images may hold it, never written again */
+    uint8_t Byte[LIBPARSER_BLOCKSTORE_BYTES];
+} FileBin_BlockType;
+
+typedef std::shared_ptr<FileBin_BlockType> FileBin_BlockPtr;
+
+/*
+ * Index of the resident blocks by content. Images of the same application mostly hold the same bytes,
+ * interning their blocks keeps a single copy of each distinct one. The index only holds weak references,
+ * a block is freed with the last image using it.
+ */
+class FileBin_BlockStore
+{
+    private:
+
+        std::mutex Lock;
+        std::unordered_multimap<uint64_t, std::weak_ptr<FileBin_BlockType>> Index;
+        size_t PurgeAt = 1024; /* Index size at which entries of freed blocks are dropped */
+
+    public:
+
+        /* Zero filled block only the caller holds */
+        static FileBin_BlockPtr NewBlock(void);
+        /* Private copy of Block, to be written by the caller */
+        static FileBin_BlockPtr Clone(const FileBin_BlockType& Block);
+        /* A shared block, or one that is still referenced elsewhere, is cloned before being written */
+        static bool IsWritable(const FileBin_BlockPtr& Block);
+
+        /* Replaces each private block by a resident one with the same content, the others become resident. Thread safe */
+        void Intern(FileBin_BlockPtr *pBlock, size_t Count);
+        /* Distinct blocks currently held by some image */
+        size_t Resident(void);
+
+        /* Store shared by all the memory images */
+        static FileBin_BlockStore& Shared(void);
+};
+
+#endif // FILEBIN_BLOCKSTORE_H
@@ -37,6 +37,15 @@
 #include <cstdint>
 #include <vector>
 #include <unordered_map>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <condition_variable>
+#include "FileBin_MappedFile.h"
+#include "FileBin_LineTable.h"
+#include "FileBin_ELF.h"
 
 typedef enum
 {
@@ -52,6 +61,9 @@ typedef enum
     FILEBIN_DWARF_ELEMENT_MEMBER,
     FILEBIN_DWARF_ELEMENT_VARIABLE,
     FILEBIN_DWARF_ELEMENT_CONSTANT,
+    FILEBIN_DWARF_ELEMENT_SCOPE, /* Function or lexical block, only holds types and static variables */
+    FILEBIN_DWARF_ELEMENT_UNION,
+    FILEBIN_DWARF_ELEMENT_POINTER,
 } FileBin_DWARF_ElementType;
 
 typedef enum
@@ -77,6 +89,7 @@ struct FileBin_DWARF_AbbrevAttr
 {
     uint64_t attribute;
     uint64_t form;
+    int64_t implicitConst; /* Value of DW_FORM_implicit_const, stored in the abbrev instead of the DIE */
 };
 
 struct FileBin_DWARF_Abbrev
@@ -85,6 +98,10 @@ struct FileBin_DWARF_Abbrev
     uint32_t tag;           // DW_TAG_*
     bool hasChildren;       // DW_CHILDREN_yes/no
     std::vector<FileBin_DWARF_AbbrevAttr> attributes;
+    int32_t fixedSize;      // Bytes of the attributes without DW_FORM_addr ones, -1 if a form has a variable size
+    uint8_t addrCnt;        // DW_FORM_addr attributes, each one is AddrSize bytes
+    int32_t siblingIdx;     // Index of DW_AT_sibling in attributes, -1 if absent
+    int32_t locationIdx;    // Index of DW_AT_location in attributes, -1 if absent
 };
 
 /* This will store the set of Dwarf abbrev contained in a specific abbrev offset */
@@ -98,6 +115,48 @@ struct TreeElementType;
 struct TypeDefType;
 struct FileBin_VarInfoType;
 
+/* Bitfield access, the field is ((little endian load of Bytes at Addr) >> Shift) masked to Width bits */
+typedef struct
+{
+    uint8_t Bytes; /* Storage unit loaded/stored as a whole, 0 for plain symbols */
+    uint8_t Shift;
+    uint8_t Width;
+    bool isSigned;
+} FileBin_DWARF_BitFieldType;
+
+inline uint64_t FileBin_DWARF_BitFieldMask(const FileBin_DWARF_BitFieldType& bf)
+{
+    return (bf.Width >= 64) ? ~0ull : ((1ull << bf.Width) - 1);
+}
+
+inline uint64_t FileBin_DWARF_BitFieldLoad(const uint8_t* raw, size_t len)
+{
+    uint64_t v = 0;
+    for (size_t i = 0; (i < len) && (i < 8); i++)
+    {
+        v |= static_cast<uint64_t>(raw[i]) << (i * 8);
+    }
+    return v;
+}
+
+/* Field value of a storage unit, signed fields are sign extended */
+inline int64_t FileBin_DWARF_BitFieldGet(const FileBin_DWARF_BitFieldType& bf, uint64_t unit)
+{
+    uint64_t v = (unit >> bf.Shift) & FileBin_DWARF_BitFieldMask(bf);
+    if (bf.isSigned && (bf.Width < 64) && (v >> (bf.Width - 1)))
+    {
+        v |= ~FileBin_DWARF_BitFieldMask(bf);
+    }
+    return static_cast<int64_t>(v);
+}
+
+/* Storage unit with the field replaced, the other bits are kept */
+inline uint64_t FileBin_DWARF_BitFieldSet(const FileBin_DWARF_BitFieldType& bf, uint64_t unit, int64_t value)
+{
+    uint64_t mask = FileBin_DWARF_BitFieldMask(bf) << bf.Shift;
+    return (unit & ~mask) | ((static_cast<uint64_t>(value) << bf.Shift) & mask);
+}
+
 typedef struct FileBin_VarInfoType
 {
     uint32_t Addr;
@@ -105,12 +164,38 @@ typedef struct FileBin_VarInfoType
     FileBin_DWARF_VarInfoLenType DataType;
     struct FileBin_VarInfoType *next = nullptr;
     struct FileBin_VarInfoType *child = nullptr;
+    struct FileBin_VarInfoType *childLast = nullptr; /* Tail of the child list, keeps appends O(1) */
     std::vector<uint8_t> data;
     FileBin_DWARF_ElementType elementType;
     bool isQualifier;
+    bool isShared = false; /* Part of a type layout shared between instances, Addr is relative to the owning instance */
     std::vector<uint32_t> Size;
+    uint32_t DeclFile = 0; /* Variables only, file index of the CU line table (see FileBin_LineTable::FileOf) */
+    uint32_t DeclLine = 0;
+    FileBin_DWARF_BitFieldType BitField = {}; /* Bitfield members only, Addr is the storage unit */
 } FileBin_DWARF_VarInfoType;
 
+/* Type expanded once per CU and referenced by every variable/member of that type */
+typedef struct
+{
+    FileBin_DWARF_VarInfoType* root;
+    FileBin_DWARF_VarInfoLenType DataType;
+    std::vector<uint32_t> Size;
+    uint8_t symbolSize;
+} FileBin_DWARF_TypeLayoutType;
+
+/* Absolute address of a symbol, base is the absolute address of the instance owning a shared node */
+inline uint32_t FileBin_DWARF_SymbolAddr(const FileBin_DWARF_VarInfoType* node, uint32_t base)
+{
+    return node->isShared ? (base + node->Addr) : node->Addr;
+}
+
+/* Base to be passed down when visiting the children of node */
+inline uint32_t FileBin_DWARF_SymbolChildBase(const FileBin_DWARF_VarInfoType* node, uint32_t base)
+{
+    return node->isQualifier ? base : FileBin_DWARF_SymbolAddr(node, base);
+}
+
 typedef struct
 {
     uint32_t Length_Bytes;
@@ -118,10 +203,21 @@ typedef struct
     uint32_t AbrevOffset;
     uint32_t Offset;
     uint32_t AddrSize;
+    uint8_t HeaderSize; /* Bytes from unit_length to the first DIE, depends on the DWARF version */
     FileBin_DWARF_CompileUnitDataType* AbbrevInfo;
     std::unordered_map<uint32_t, TreeElementType*> typeList; // <-- now TypeDefType is known
     std::unordered_map<uint32_t, TreeElementType*> varDeclaration; // <-- now TypeDefType is known
+    std::unordered_map<uint32_t, FileBin_DWARF_TypeLayoutType> typeLayout; /* Resolved types by type offset */
+    std::vector<FileBin_DWARF_VarInfoType*> typeLayoutNodes; /* Nodes owned by typeLayout */
+    std::recursive_mutex typeLayoutLock;
+    bool isResident = false; /* DIE and symbol trees currently built */
+    uint32_t pinCnt = 0; /* Pinned CUs are never evicted */
+    bool isLoading = false; /* Being rebuilt by AcquireCU outside CacheLock */
+    uint64_t residentBytes = 0;
     uint8_t UnitType; //DWARF5
+    bool hasStmtList = false; /* DW_AT_stmt_list, offset of the CU line program in .debug_line */
+    uint32_t stmtList = 0;
+    std::string compDir;
 } FileBin_DWARF_CompileUnitType;
 
 typedef struct TreeElementType
@@ -136,9 +232,39 @@ typedef struct TreeElementType
     std::vector<uint32_t> Size; /* Size of the element in memory (in bytes) */
     uint32_t Location;
     bool isDeclaration; //is just a forward declaration, not the actual definition
+    bool isCompleted = false; /* Declaration with a DW_AT_specification definition in the same CU */
+    bool hasLocation = false; /* Addr comes from a plain DW_OP_addr expression */
+    std::vector<uint8_t> linkageName; /* DW_AT_linkage_name, mangled name of the .symtab entry */
+    uint32_t DeclFile = 0;
+    uint32_t DeclLine = 0;
+    uint32_t BitSize = 0; /* Members only, DW_AT_bit_size, 0 for plain members */
+    int32_t BitOffset = 0; /* DW_AT_data_bit_offset from the struct start, or DW_AT_bit_offset from the MSB of the storage unit (negative when packed) */
+    bool isDataBitOffset = false;
     //struct TreeElementType* specification = nullptr; // points to declaration if this is a definition
 } TreeElementType;
 
+/* Parse progress, CUs are counted once their symbols are resolved */
+typedef struct
+{
+    uint32_t InfoBytesDone;
+    uint32_t InfoBytesTotal;
+    uint32_t CUDone;
+    uint32_t CUTotal;
+    uint32_t SymbolCnt;
+} FileBin_DWARF_ProgressType;
+
+typedef std::function<void(const FileBin_DWARF_ProgressType&)> FileBin_DWARF_ProgressCb;
+
+/* CU tree cache counters of the current file, hits/misses only count AcquireCU calls. Also published as the
+   dwarf.cache_hits / dwarf.cache_misses / dwarf.cache_evictions load statistics */
+typedef struct
+{
+    uint64_t Hits;
+    uint64_t Misses;
+    uint64_t Evictions;
+    uint64_t ResidentBytes;
+    uint64_t BudgetBytes; /* 0: unlimited, every CU stays resident */
+} FileBin_DWARF_CacheStatsType;
 
 class FileBin_DWARF
 {
@@ -147,33 +273,105 @@ class FileBin_DWARF
         std::unordered_map<uint32_t, FileBin_DWARF_CompileUnitDataType> AbbrevOffsetCache;
         std::vector<FileBin_DWARF_CompileUnitType*> CompilationUnit; /* Array of Compilation Units (DWARF top-most level DIE) extracted from abbrev */
         const uint8_t* fileBase;
+        FileBin_MappedFile File; /* Stays mapped after Parse, evicted CUs are rebuilt from it */
+        FileBin_LineTable LineTable;
+
+        std::vector<TreeElementType*> CUTreeNode; /* Per-CU entry of DataRoot */
+        std::vector<FileBin_DWARF_VarInfoType*> CUSymbolNode; /* Per-CU entry of SymbolRoot */
+        std::mutex CacheLock;
+        std::condition_variable CacheLoaded; /* Signalled when a CU leaves isLoading */
+        std::list<uint32_t> CacheLRU; /* Resident CUs, most recently used first */
+        std::vector<std::list<uint32_t>::iterator> CacheLRUPos;
+        FileBin_DWARF_CacheStatsType CacheStats;
+
+        std::vector<FileBin_ELF_SymbolType> Symtab; /* Object symbols of the ELF, see SetSymbolTable */
+        std::unordered_map<std::string, uint32_t> SymtabIndex; /* Global name, or file '\0' name for locals, to Symtab index */
+        std::vector<int32_t> SymtabOwner; /* CU patching the symbol, -1: none, -2: DWARF locates it */
+        bool SymtabScanned = false; /* Owners are final, loaded CUs are patched */
+
+        int32_t SymtabFind(const TreeElementType* node, const std::string& cuFile, std::string& key) const;
+        void SymtabScanCU(uint32_t Idx);
+        void SymtabPatchCU(uint32_t Idx);
+
+        void SymbolResolveCU(uint32_t Idx, bool isParallel);
+        void MeasureCU(uint32_t Idx);
+        void BuildCU(uint32_t Idx, bool isParallel);
+        void PublishCU(uint32_t Idx);
+        void LoadCU(uint32_t Idx);
+        void UnloadCU(uint32_t Idx);
+        void CacheEnforceBudget();
 
         inline uint64_t FileBin_DWARF_ReadULEB128(const uint8_t*& ptr);
         inline int64_t FileBin_DWARF_ReadSLEB128(const uint8_t*& ptr);
 
 
+        std::atomic<bool> CancelRequest;
+        std::mutex ProgressLock;
+        FileBin_DWARF_ProgressCb ProgressCallback;
+        std::chrono::steady_clock::duration ProgressInterval;
+        std::chrono::steady_clock::time_point ProgressLast;
+        uint32_t ProgressInfoTotal;
+        std::atomic<uint32_t> ProgressTick; /* Also counted by CUs rebuilt concurrently in AcquireCU */
+        std::atomic<uint32_t> ProgressInfoBytes;
+        std::atomic<uint32_t> ProgressCUDone;
+        std::atomic<uint32_t> ProgressSymbolCnt;
+
+        void ReportProgress(bool Force);
+
         void Reset();
         void DeleteTree(TreeElementType* node);
         void FreeTree(TreeElementType* node);
         void FreeSymTree(FileBin_DWARF_VarInfoType* node);
+        void FreeCompileUnit(FileBin_DWARF_CompileUnitType* cu);
 
     public:
 
         FileBin_DWARF_VarInfoType* SymbolRoot;
         uint32_t InfoOffset;
         uint32_t StrOffset;
+        uint32_t LineStrOffset;
         TreeElementType *DataRoot; /* data extracred from .debug_info thanks to CompilationUnit */
 
         FileBin_DWARF();
+        ~FileBin_DWARF();
+
+        /* Returns 0 on success, 1 if the file cannot be opened, 2 if cancelled. LineLen 0 skips the line table */
+        uint8_t Parse(std::string file_name, uint32_t Offset, uint32_t Len, uint32_t InfoOffset, uint32_t InfoLen, uint32_t StrOffset,
+                      uint32_t LineOffset = 0, uint32_t LineLen = 0, uint32_t LineStrOffset = 0);
+
+        /* Callback runs on the parsing threads, at most once per interval plus once at start and end */
+        void SetProgressCallback(FileBin_DWARF_ProgressCb Callback, uint32_t IntervalMs = 100);
+        /* Thread safe, aborts the running Parse at the next CU / DIE batch / variable range */
+        void Cancel();
+        bool IsCancelled() const;
+
+        /* Applies to the next Parse, variables without a usable DW_AT_location take address and size from .symtab */
+        void SetSymbolTable(const std::vector<FileBin_ELF_SymbolType>& Symbols);
+
+        /* Bounded memory mode, CU trees beyond the budget are evicted (LRU) and rebuilt on AcquireCU */
+        void SetMemoryBudget(uint64_t Bytes);
+        FileBin_DWARF_CacheStatsType GetCacheStats();
+        uint32_t GetCUCount() const;
+        TreeElementType* GetCUTree(uint32_t Idx) const;
+        /* Makes the CU resident and pins it, the returned node and its children stay valid until ReleaseCU */
+        FileBin_DWARF_VarInfoType* AcquireCU(uint32_t Idx);
+        void ReleaseCU(uint32_t Idx);
 
-        uint8_t Parse(std::string file_name, uint32_t Offset, uint32_t Len, uint32_t InfoOffset, uint32_t InfoLen, uint32_t StrOffset);
+        /* Address to source line of every CU, unit indices follow GetCUCount */
+        const FileBin_LineTable& GetLineTable() const;
 
         void ParseAllAbbrvSectionHeader(const uint8_t* fileData, uint32_t AbbrevOffset, uint32_t InfoOffset, uint32_t InfoLen);
         FileBin_DWARF_CompileUnitDataType* ParseAbbrevOffset(const uint8_t* abbrevPtr);
         TreeElementType* ParseDIE(const uint8_t*& ptr, const uint8_t* fileBase, uint32_t cuOffset, uint32_t infoLen, FileBin_DWARF_CompileUnitType* cu,TreeElementType* parent);
         std::vector<uint8_t> ReadAttributeValue(const uint8_t*& ptr, uint32_t form, uint8_t addrSize, const uint8_t* fileBase);
+        void SkipAttributeValue(const uint8_t*& ptr, uint32_t form, uint8_t addrSize, const uint8_t* fileBase);
+        void SkipDIE(const uint8_t*& ptr, const FileBin_DWARF_Abbrev& abbrev, const uint8_t* cuStart, const uint8_t* sectionEnd, FileBin_DWARF_CompileUnitType* cu);
+        bool IsStaticVariableDIE(const uint8_t* ptr, const FileBin_DWARF_Abbrev& abbrev, FileBin_DWARF_CompileUnitType* cu);
+        std::vector<uint8_t> ReadDIEName(const uint8_t* cuStart, const uint8_t* sectionEnd, uint32_t dieOffset, FileBin_DWARF_CompileUnitType* cu);
 
         uint8_t SymbolResolveType(TreeElementType* node, FileBin_DWARF_VarInfoType* parent);
+        FileBin_DWARF_TypeLayoutType* SymbolTypeLayout(FileBin_DWARF_CompileUnitType* cu, uint32_t typeOffset);
+        FileBin_DWARF_VarInfoType* SymbolResolveVariable(TreeElementType* node);
         void SymbolTraverse(TreeElementType* node, FileBin_DWARF_VarInfoType *parent);
 
         void PrintAllAbbrevInfo() const;
@@ -36,6 +36,7 @@
 extern "C" {
     #include "FileBin_ELF_Def.h"
 }
+#include "FileBin_MappedFile.h"
 #include <vector>
 #include <string>
 #include <cstdint>  // for uint32_t, uint16_t, etc.
@@ -46,6 +47,16 @@ typedef struct
     std::string Name;
 } SectionInfoType;
 
+/* Data object from .symtab, used to locate variables DWARF gives no address for */
+typedef struct
+{
+    std::string Name;
+    std::string File; /* STT_FILE in effect for local symbols, empty for global ones */
+    uint32_t Addr;
+    uint32_t Size;
+    bool isLocal;
+} FileBin_ELF_SymbolType;
+
 struct SectionMapEntry {
     uint32_t vaStart;    // section virtual address
     uint32_t vaEnd;      // vaStart + sh_size
@@ -64,18 +75,26 @@ class FileBin_ELF
         bool debugInfoInfoFound = false;
         bool debugInfoStrFound = false;
         uint32_t AbbrevOffset = 0, AbbrevLen = 0, InfoOffset = 0, StrOffset = 0, InfoLen = 0;
+        uint32_t LineOffset = 0, LineLen = 0, LineStrOffset = 0; /* LineLen 0: no .debug_line */
         std::vector<SectionInfoType> SectionNameStr;
         Elf32_Shdr string_section;
-        const Elf32_Shdr *symbol_section_header, *symbol_string_section_header;
+        const Elf32_Shdr *symbol_section_header = nullptr, *symbol_string_section_header = nullptr; /* Into SectionHeader */
+        std::vector<Elf32_Shdr> SectionHeader; /* Copied, does not depend on the mapping layout */
+        std::vector<Elf32_Phdr> ProgramHeader; /* Copied as well */
         std::vector<SectionMapEntry> sectionMap;
+        std::vector<FileBin_ELF_SymbolType> ObjectSymbols;
+        FileBin_MappedFile File; /* Stays mapped after Parse, symbol values are read from it */
+
+        void ParseSymbolTable(void);
 
     public:
 
         std::vector<SectionMapEntry> buildSectionMap(const std::vector<Elf32_Shdr>& section_headers);
-        const SectionMapEntry* findSectionForVA( uint32_t va);
+        const SectionMapEntry* findSectionForVA( uint32_t va) const;
 
+        /* Thread safe, copies the initial value of a symbol from the mapped file */
         std::vector<uint8_t> readSymbolFromELF(uint32_t symbolVA,
-                                               uint32_t symbolSize);
+                                               uint32_t symbolSize) const;
         FileBin_ELF(void);
         uint8_t Parse(const std::string& file_name);
         std::string GetStr_ElfClass(const Elf32_Ehdr* elf_header) const;
@@ -90,7 +109,12 @@ class FileBin_ELF
         uint32_t GetInfoOffset(void) const;
         uint32_t GetInfoLen(void) const;
         uint32_t GetStrOffset(void) const;
+        uint32_t GetLineOffset(void) const;
+        uint32_t GetLineLen(void) const;
+        uint32_t GetLineStrOffset(void) const;
         uint32_t GetRODataOffset(void) const;
+        uint32_t GetLoadAddress(void) const; /* Lowest PT_LOAD LMA, 0 without loadable segments */
+        const std::vector<FileBin_ELF_SymbolType>& GetObjectSymbols(void) const;
         void PrintElfHeader(const Elf32_Ehdr* elf_header) const;
 
         void Print(void) const;
@@ -0,0 +1,84 @@
+/**
+ *  \file       FileBin_ELFSet.h
+ *  \brief      Concurrent loading of several ELF and DWARF files
+ *
+ *  \version    1.0
+ *  \date       Oct 18, 2026
+ *  \author     Xavier Descarrega - DEVE embedded designs <info@deve.tech>
+ *
+ *  \copyright  MIT License
+ *
+ *              Copyright (c) 2026 Xavier Descarrega
+ *
+ *              Permission is hereby granted, free of charge, to any person obtaining a copy
+ *              of this software and associated documentation files (the "Software"), to deal
+ *              in the Software without restriction, including without limitation the rights
+ *              to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *              copies of the Software, and to permit persons to whom the Software is
+ *              furnished to do so, subject to the following conditions:
+ *
+ *              The above copyright notice and this permission notice shall be included in all
+ *              copies or substantial portions of the Software.
+ *
+ *              THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *              IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *              FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *              AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ *              LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *              OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *              SOFTWARE.
+ *
+ */
+
+#ifndef FILEBIN_ELFSET_H
+#define FILEBIN_ELFSET_H
+
+#include "FileBin_ELF.h"
+#include "FileBin_DWARF.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+typedef struct
+{
+    std::string FileName;
+    FileBin_ELF* ELF;
+    FileBin_DWARF* DWARF; /* Parsed only when the ELF carries DWARF sections */
+    uint8_t ELFResult;    /* FileBin_ELF::Parse result, 0 on success */
+    uint8_t DWARFResult;  /* FileBin_DWARF::Parse result, 0 on success or when skipped */
+} FileBin_ELFSet_EntryType;
+
+/*
+ * Owns one ELF/DWARF parser pair per file, e.g. the firmware variants of a release compared side by
+ * side. Each file is a task of the shared pool, its CUs are resolved by nested ParallelFor calls
+ * so small and large files balance over the same workers.
+ */
+class FileBin_ELFSet
+{
+    private:
+
+        std::vector<FileBin_ELFSet_EntryType> Entry;
+        std::mutex EntryLock; /* Held by Clear, Cancel and while Load publishes a new list */
+        std::atomic<bool> CancelRequest{false}; /* Files not started yet are skipped */
+
+    public:
+
+        FileBin_ELFSet() = default;
+        ~FileBin_ELFSet();
+
+        FileBin_ELFSet(const FileBin_ELFSet&) = delete;
+        FileBin_ELFSet& operator=(const FileBin_ELFSet&) = delete;
+
+        /* Replaces the current set, returns the number of files that failed to parse */
+        uint32_t Load(const std::vector<std::string>& FileNames, uint64_t MemoryBudgetBytes = 0);
+        /* Cancels the DWARF parsing of every file and skips the files not started, thread safe */
+        void Cancel();
+        void Clear();
+
+        uint32_t Size() const;
+        const FileBin_ELFSet_EntryType& Get(uint32_t Idx) const;
+};
+
+#endif // FILEBIN_ELFSET_H
@@ -0,0 +1,78 @@
+/**
+ *  \file       FileBin_HexCodec.h
+ *  \brief      ASCII hex record payload codec
+ *
+ *  \version    1.0
+ *  \date       Oct 18, 2026
+ *  \author     Xavier Descarrega - DEVE embedded designs <info@deve.tech>
+ *
+ *  \copyright  MIT License
+ *
+ *              Copyright (c) 2026 Xavier Descarrega
+ *
+ *              Permission is hereby granted, free of charge, to any person obtaining a copy
+ *              of this software and associated documentation files (the "Software"), to deal
+ *              in the Software without restriction, including without limitation the rights
+ *              to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *              copies of the Software, and to permit persons to whom the Software is
+ *              furnished to do so, subject to the following conditions:
+ *
+ *              The above copyright notice and this permission notice shall be included in all
+ *              copies or substantial portions of the Software.
+ *
+ *              THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *              IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *              FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *              AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ *              LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *              OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *              SOFTWARE.
+ *
+ */
+
+#ifndef FILEBIN_HEXCODEC_H
+#define FILEBIN_HEXCODEC_H
+
+#include <cstdint>
+
+#define FILEBIN_HEXCODEC_INVALID 0xFFu
+
+/*
+ * Hex digit pairs of a record (Intel HEX, later S-record) to bytes. Both digit cases are accepted,
+ * every digit is validated and the modulo 256 sum needed by the record checksums comes out of the
+ * same pass. Long payloads go through an SSE2 (or AVX2 when the CPU has it) kernel. Encoding is
+ * table driven, two uppercase digits per byte.
+ */
+class FileBin_HexCodec
+{
+    public:
+
+        /* Digit value for '0'-'9', 'A'-'F', 'a'-'f', FILEBIN_HEXCODEC_INVALID otherwise */
+        static const uint8_t NibbleTable[256];
+
+        /* Src holds 2 * Count digits. Sum gets the decoded bytes added. False on a non hex digit, Dst is then undefined */
+        static bool Decode(const uint8_t* Src, uint32_t Count, uint8_t* Dst, uint32_t* Sum);
+
+        static inline bool DecodeByte(const uint8_t* Src, uint8_t* Dst)
+        {
+            uint8_t hi = NibbleTable[Src[0]];
+            uint8_t lo = NibbleTable[Src[1]];
+            *Dst = static_cast<uint8_t>((hi << 4) | lo);
+            return ((hi | lo) & 0xF0u) == 0;
+        }
+
+        /* "000102...FF", the two digits of byte b start at 2 * b */
+        static const char DigitTable[513];
+
+        /* Writes 2 * Count digits, returns the end of them. Sum gets the encoded bytes added */
+        static uint8_t* Encode(const uint8_t* Src, uint32_t Count, uint8_t* Dst, uint32_t* Sum);
+
+        static inline uint8_t* EncodeByte(uint8_t Byte, uint8_t* Dst)
+        {
+            Dst[0] = static_cast<uint8_t>(DigitTable[2 * Byte]);
+            Dst[1] = static_cast<uint8_t>(DigitTable[(2 * Byte) + 1]);
+            return Dst + 2;
+        }
+};
+
+#endif // FILEBIN_HEXCODEC_H
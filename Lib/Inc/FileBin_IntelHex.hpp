@@ -1,17 +1,30 @@
 #ifndef LIB_INTELHEX_H
 #define LIB_INTELHEX_H
 
+#include <cstring>
 #include <iostream>
+#include <map>
+#include <type_traits>
 #include <vector>
 #include <QByteArray>
+#include "FileBin_HexCodec.h"
+#include "FileBin_BlockStore.h"
 
 using namespace std;
 
+/* Target memory is little endian, values are only byte swapped on a big endian host */
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+#define FILEBIN_INTELHEX_HOST_SWAP 1
+#else
+#define FILEBIN_INTELHEX_HOST_SWAP 0
+#endif
+
 typedef enum
 {
     LIB_FIRMWAREBIN__UNKNOWN = 0u,
     LIB_FIRMWAREBIN_BIN,
     LIB_FIRMWAREBIN_HEX,
+    LIB_FIRMWAREBIN_SREC, /* Motorola S-record, S19/S28/S37 */
     LIB_FIRMWAREBIN__LENGTH,
 } Lib_FirwareBinType;
 
@@ -25,53 +38,22 @@ class FileBin_IntelHex_Record
 
         static int8_t Lib_IntelHex_AsciiToNum(uint8_t Number)
         {
-            switch (Number) {
-                    case 48: return 0;
-                    case 49: return 1;
-                    case 50: return 2;
-                    case 51: return 3;
-                    case 52: return 4;
-                    case 53: return 5;
-                    case 54: return 6;
-                    case 55: return 7;
-                    case 56: return 8;
-                    case 57: return 9;
-                    case 65: return 10;
-                    case 66: return 11;
-                    case 67: return 12;
-                    case 68: return 13;
-                    case 69: return 14;
-                    case 70: return 15;
-                }
-                return -1;
+            uint8_t value = FileBin_HexCodec::NibbleTable[Number];
+            return (value == FILEBIN_HEXCODEC_INVALID) ? -1 : static_cast<int8_t>(value);
         }
 
         static uint8_t Lib_IntelHex_NumToAscii(uint8_t Number)
         {
-            switch (Number) {
-                  case 0:  return 48;
-                  case 1:  return 49;
-                  case 2:  return 50;
-                  case 3:  return 51;
-                  case 4:  return 52;
-                  case 5:  return 53;
-                  case 6:  return 54;
-                  case 7:  return 55;
-                  case 8:  return 56;
-                  case 9:  return 57;
-                  case 10:  return 65;
-                  case 11:  return 66;
-                  case 12:  return 67;
-                  case 13:  return 68;
-                  case 14:  return 69;
-                  case 15:  return 70;
-                }
-                return -1;
+            return (Number < 16u) ? static_cast<uint8_t>(FileBin_HexCodec::DigitTable[(2u * Number) + 1u]) : 0xFFu;
         }
 
         FileBin_IntelHex_Record();
 
         bool Parse(uint8_t *pBuffer, uint16_t Length);
+        /* Start code, byte count, address and type, checks Length covers the whole record. Data is left untouched */
+        bool ParseHeader(const uint8_t *pBuffer, size_t Length, uint32_t *pSum);
+        /* Decodes the ByteCount payload bytes into pData and verifies the checksum, Sum comes from ParseHeader */
+        bool ParseData(const uint8_t *pBuffer, uint8_t *pData, uint32_t Sum);
 
 };
 
@@ -82,38 +64,126 @@ class FileBin_IntelHex_Page
 
         uint32_t BaseAddress;
         uint32_t Length_Bytes;
-        vector<uint8_t> Byte;
+        /* Block k starts k blocks above BaseAddress rounded down to a block, bytes outside the extent are 0 */
+        vector<FileBin_BlockPtr> Block;
+
+        /* Offsets are from BaseAddress. Bytes from Offset to the end of its block, *pAvail of them */
+        const uint8_t* Data(uint32_t Offset, uint32_t *pAvail) const;
+        /* Same for writing, a block shared with another image is replaced by a private copy first */
+        uint8_t* MutableData(uint32_t Offset, uint32_t *pAvail);
+        /* [Offset, Offset + Length) must lie within the extent */
+        void Read(uint32_t Offset, uint32_t Length, uint8_t *pDst) const;
+        void Write(uint32_t Offset, uint32_t Length, const uint8_t *pSrc);
+        /* Zeroed private blocks for Length_Bytes from BaseAddress */
+        void Allocate(void);
 };
 
+#define LIBPARSER_INTELHEX_DIRTY_SECTOR (1u << 12) /* Default granularity of the dirty ranges, a power of two */
+
 class FileBin_IntelHex_Memory
 {
     public:
+        /* Programmed bytes only: extents ordered by address that neither overlap nor touch, gaps are unprogrammed.
+           Loaded images keep their blocks in the shared store, a copy of the memory shares them until written */
         vector<FileBin_IntelHex_Page> Page;
+        uint32_t PageHit = 0; /* Extent of the last GetMemPageOffset */
+        /* Sectors changed since the load (or ClearDirty): start -> end, neither overlapping nor touching */
+        map<uint32_t, uint64_t> Dirty;
+        uint32_t DirtySector = LIBPARSER_INTELHEX_DIRTY_SECTOR;
+        /* Image the dirty sectors are relative to, shares the unchanged blocks with Page */
+        vector<FileBin_IntelHex_Page> BasePage;
 
         FileBin_IntelHex_Memory(void);
 
-        bool Load(const char *filePathAbs, Lib_FirwareBinType FirmwareBinType);
-        bool Save(string filename);
+        /* LIB_FIRMWAREBIN__UNKNOWN detects the type from the content, then from the extension.
+           BaseAddress places a raw binary, record files carry their own addresses */
+        bool Load(const char *filePathAbs, Lib_FirwareBinType FirmwareBinType, uint32_t BaseAddress = 0);
+        /* Intel HEX text already in memory, records are decoded in place into the pages */
+        bool LoadHex(const uint8_t *pBuffer, size_t Length);
+        /* Motorola S-record text already in memory, S1/S2/S3 data records may be mixed */
+        bool LoadSRec(const uint8_t *pBuffer, size_t Length);
+        /* Raw image copied as a single extent at BaseAddress, it must end within the 32-bit address space */
+        bool LoadBin(const uint8_t *pBuffer, size_t Length, uint32_t BaseAddress);
+        /* Intel HEX text of the programmed extents with RecordBytes (1..255) per data record, gaps are not written */
+        bool SaveHex(vector<uint8_t> *pText, uint32_t RecordBytes = 16, bool isParallel = true);
+        /* S1/S2/S3 records by the highest address, RecordBytes up to 252/251/250 */
+        bool SaveSRec(vector<uint8_t> *pText, uint32_t RecordBytes = 16, bool isParallel = true);
+        /* S-record for an S-record extension (see TypeFromExtension), Intel HEX otherwise */
+        bool Save(string filename, uint32_t RecordBytes = 16, bool isParallel = true);
+
+        /* Sector size (a power of two) the dirty ranges are widened to, the ranges already marked are widened as well */
+        bool SetDirtySector(uint32_t Bytes);
+        void MarkDirty(uint32_t Address, uint64_t Length);
+        /* The current image becomes the base of the next delta */
+        void ClearDirty(void);
+        /* FNV-1a (64-bit) of the base image: for each extent its address and length (32-bit little-endian), then its bytes */
+        uint64_t BaseHash(void) const;
+        /* Programmed bytes of the dirty sectors as an image of their own, sharing the blocks of this one */
+        void DirtyImage(FileBin_IntelHex_Memory *pDelta) const;
+        /* "FBP1", BaseHash (8 bytes), range count (4), then each range: address (4), length (4) and bytes. Little-endian */
+        bool SavePatch(vector<uint8_t> *pData);
+        /* Dirty sectors only: a binary patch for a .bin extension, otherwise partial S-record or Intel HEX as Save */
+        bool SaveDelta(string filename, uint32_t RecordBytes = 16, bool isParallel = true);
+
+        static Lib_FirwareBinType TypeFromExtension(const char *filePathAbs);
+        /* From the first record of the content, the extension only decides for an empty file */
+        static Lib_FirwareBinType DetectType(const char *filePathAbs, const uint8_t *pBuffer, size_t Length);
         void Clear(void);
+        /* False (and an error message) if Address is not programmed */
         bool GetMemPageOffset(uint32_t *pPage, uint32_t *pOffset, uint32_t Address);
+        /* Tells unprogrammed memory apart from programmed zeroes, without the error message */
+        bool IsProgrammed(uint32_t Address, uint32_t Length);
+
+
+        /* Programmed bytes [Address, Address + Length), false (and an error message) unless all of them are */
+        bool MemRead(uint32_t Address, uint64_t Length, uint8_t *pDst);
+        bool MemWrite(uint32_t Address, uint64_t Length, const uint8_t *pSrc);
+        /* Writes within extent PageIdx, only blocks whose bytes change are written (cloned if shared) and marked dirty */
+        void Update(uint32_t PageIdx, uint32_t Offset, uint32_t Length, const uint8_t *pSrc);
+        /* Interns the private blocks in the shared store, identical blocks of other images are reused */
+        void Share(void);
 
+        /* Typed access, bounds are checked once per call and a failed Read gives 0 */
+        template <typename T> T Read(uint32_t Address)
+        {
+            T value = T();
+            this->ReadArray<T>(Address, 1, &value);
+            return value;
+        }
+
+        template <typename T> bool Write(uint32_t Address, T Value)
+        {
+            return this->WriteArray<T>(Address, 1, &Value);
+        }
+
+        /* Count consecutive values, e.g. a whole map, copied with a single lookup */
+        template <typename T> bool ReadArray(uint32_t Address, uint32_t Count, T *pValue)
+        {
+            static_assert(std::is_arithmetic<T>::value, "memory holds arithmetic values only");
+            if (!this->MemRead(Address, (uint64_t)Count * sizeof(T), reinterpret_cast<uint8_t *>(pValue)))
+            {
+                return false;
+            }
+
+#if FILEBIN_INTELHEX_HOST_SWAP
+            SwapArray(reinterpret_cast<uint8_t *>(pValue), Count, sizeof(T));
+#endif
+            return true;
+        }
+
+        template <typename T> bool WriteArray(uint32_t Address, uint32_t Count, const T *pValue)
+        {
+            static_assert(std::is_arithmetic<T>::value, "memory holds arithmetic values only");
+#if FILEBIN_INTELHEX_HOST_SWAP
+            vector<T> value(pValue, pValue + Count);
+            SwapArray(reinterpret_cast<uint8_t *>(value.data()), Count, sizeof(T));
+            pValue = value.data();
+#endif
+            return this->MemWrite(Address, (uint64_t)Count * sizeof(T), reinterpret_cast<const uint8_t *>(pValue));
+        }
 
-        uint8_t ReadMem_uint8(uint8_t *buffer, uint32_t Length, uint32_t Address);
-        int8_t ReadMem_sint8(uint8_t *buffer, uint32_t Length, uint32_t Address);
-        uint16_t ReadMem_uint16(uint8_t *buffer, uint32_t Length, uint32_t Address);
-        int16_t ReadMem_sint16(uint8_t *buffer, uint32_t Length, uint32_t Address);
-        uint32_t ReadMem_uint32(uint32_t Address);
-        int32_t ReadMem_sint32(uint8_t *buffer, uint32_t Length, uint32_t Address);
-        float ReadMem_float32(uint8_t *buffer, uint32_t Length, uint32_t Address);
-
-        void WriteMem_float32(uint32_t Address, float value);
-        void WriteMem_uint16(uint32_t Address, uint16_t value);
-        void WriteMem_sint16(uint32_t Address, int16_t value);
-        void WriteMem_boolean(uint32_t Address, uint8_t value);
-        void WriteMem_uint8(uint32_t Address, uint8_t value);
-        void WriteMem_sint8(uint32_t Address, int8_t value);
-        void WriteMem_sint32(uint32_t Address, int32_t value);
-        void WriteMem_uint32(uint32_t Address, uint32_t value);
+        /* Reverses the bytes of each of the Count values of Size bytes */
+        static void SwapArray(uint8_t *pData, uint32_t Count, uint32_t Size);
 };
 
 
@@ -0,0 +1,86 @@
+/**
+ *  \file       FileBin_LeafTable.h
+ *  \brief      Flat structure-of-arrays table of every calibratable scalar
+ *
+ *  \version    1.0
+ *  \date       Oct 18, 2026
+ *  \author     Xavier Descarrega - DEVE embedded designs <info@deve.tech>
+ *
+ *  \copyright  MIT License
+ *
+ *              Copyright (c) 2026 Xavier Descarrega
+ *
+ *              Permission is hereby granted, free of charge, to any person obtaining a copy
+ *              of this software and associated documentation files (the "Software"), to deal
+ *              in the Software without restriction, including without limitation the rights
+ *              to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *              copies of the Software, and to permit persons to whom the Software is
+ *              furnished to do so, subject to the following conditions:
+ *
+ *              The above copyright notice and this permission notice shall be included in all
+ *              copies or substantial portions of the Software.
+ *
+ *              THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *              IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *              FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *              AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ *              LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *              OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *              SOFTWARE.
+ *
+ */
+
+#ifndef FILEBIN_LEAFTABLE_H
+#define FILEBIN_LEAFTABLE_H
+
+#include <cstdint>
+#include <vector>
+#include "FileBin_IntelHex.hpp"
+#include "FileBin_SymbolIndex.h"
+
+/*
+ * One row per leaf symbol (scalar or scalar array), columns kept in parallel arrays so that scans only
+ * touch the fields they need. Rows are in symbol index order after Build, SortByAddress reorders every
+ * column. Leaf values can be moved in bulk between a memory image and a flat buffer where leaf i starts
+ * at ValueOffset[i].
+ */
+class FileBin_LeafTable
+{
+    private:
+
+        bool IsSortedByAddress = false;
+
+    public:
+
+        std::vector<uint32_t> Addr; /* Absolute address */
+        std::vector<uint32_t> Size; /* Total bytes, Count * Stride */
+        std::vector<uint8_t> Type; /* FileBin_DWARF_VarInfoLenType */
+        std::vector<uint32_t> Count; /* Elements, 1 for plain scalars */
+        std::vector<uint32_t> Stride; /* Element bytes */
+        std::vector<uint32_t> PathId; /* Symbol index entry of the leaf */
+        std::vector<uint32_t> Parent; /* Symbol index entry of the enclosing struct/array, FILEBIN_SYMBOLINDEX_NO_PARENT for variables */
+        std::vector<uint32_t> ValueOffset; /* Start of each leaf in the flat value buffer, one extra entry with the total */
+        std::vector<FileBin_DWARF_BitFieldType> BitField; /* Bytes 0 for plain leaves, values of bitfields hold the raw storage unit */
+
+        void Build(const FileBin_SymbolIndex& Index);
+        void Clear();
+        void SortByAddress();
+        bool SortedByAddress() const;
+
+        uint32_t Rows() const;
+        uint32_t ValueBytes() const;
+
+        /* Return false if part of the leaf lies outside the memory image, missing bytes read as 0 */
+        bool ReadLeaf(const FileBin_IntelHex_Memory& Mem, uint32_t Row, uint8_t* Dst) const;
+        bool WriteLeaf(FileBin_IntelHex_Memory& Mem, uint32_t Row, const uint8_t* Src) const;
+
+        /* Single integer leaves (up to 8 bytes) as a value, bitfields are extracted/inserted with one masked load/store */
+        bool ReadScalar(const FileBin_IntelHex_Memory& Mem, uint32_t Row, int64_t& Value) const;
+        bool WriteScalar(FileBin_IntelHex_Memory& Mem, uint32_t Row, int64_t Value) const;
+
+        /* Bulk transfer of every leaf, return the number of leaves not fully covered by the image */
+        uint32_t Read(const FileBin_IntelHex_Memory& Mem, std::vector<uint8_t>& Values) const;
+        uint32_t Write(FileBin_IntelHex_Memory& Mem, const std::vector<uint8_t>& Values) const;
+};
+
+#endif // FILEBIN_LEAFTABLE_H
@@ -0,0 +1,98 @@
+/**
+ *  \file       FileBin_LineTable.h
+ *  \brief      Address to source line index decoded from .debug_line
+ *
+ *  \version    1.0
+ *  \date       Oct 18, 2026
+ *  \author     Xavier Descarrega - DEVE embedded designs <info@deve.tech>
+ *
+ *  \copyright  MIT License
+ *
+ *              Copyright (c) 2026 Xavier Descarrega
+ *
+ *              Permission is hereby granted, free of charge, to any person obtaining a copy
+ *              of this software and associated documentation files (the "Software"), to deal
+ *              in the Software without restriction, including without limitation the rights
+ *              to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *              copies of the Software, and to permit persons to whom the Software is
+ *              furnished to do so, subject to the following conditions:
+ *
+ *              The above copyright notice and this permission notice shall be included in all
+ *              copies or substantial portions of the Software.
+ *
+ *              THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *              IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *              FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *              AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ *              LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *              OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *              SOFTWARE.
+ *
+ */
+
+#ifndef FILEBIN_LINETABLE_H
+#define FILEBIN_LINETABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#define FILEBIN_LINETABLE_NONE 0xFFFFFFFFu /* File of an end_sequence row, no source past it */
+
+/* Section offsets in the ELF file, LineStrOffset/StrOffset are only used by DWARF 5 headers */
+typedef struct
+{
+    uint32_t LineOffset;
+    uint32_t LineLen;
+    uint32_t LineStrOffset;
+    uint32_t StrOffset;
+} FileBin_LineTable_SectionType;
+
+/* Line program of one compile unit, from its DW_AT_stmt_list/DW_AT_comp_dir */
+typedef struct
+{
+    bool HasStmtList;
+    uint32_t StmtList;
+    uint8_t AddrSize;
+    std::string CompDir;
+} FileBin_LineTable_UnitType;
+
+typedef struct
+{
+    uint32_t Addr; /* First address of the row containing the looked up address */
+    uint32_t Line;
+    const std::string* File;
+} FileBin_LineTable_ResultType;
+
+/*
+ * Rows of every line program merged into address sorted arrays. Consecutive rows with the same
+ * file and line are folded, a lookup is a binary search over Addr.
+ */
+class FileBin_LineTable
+{
+    private:
+
+        std::vector<uint32_t> UnitFileId;    /* Unit local file index to FileName index, per unit at UnitFileBase */
+        std::vector<uint32_t> UnitFileBase;
+        std::vector<uint32_t> UnitFileCnt;
+        std::vector<uint8_t> UnitFileFirst;  /* First valid file index: 1 up to DWARF 4, 0 for DWARF 5 */
+
+    public:
+
+        std::vector<uint32_t> Addr;
+        std::vector<uint32_t> Line;
+        std::vector<uint32_t> File;          /* FileName index or FILEBIN_LINETABLE_NONE */
+        std::vector<std::string> FileName;   /* Unique full paths */
+
+        /* Decodes every unit in parallel on the shared pool, returns the number of units that failed */
+        uint32_t Build(const uint8_t* FileData, size_t FileSize, const FileBin_LineTable_SectionType& Section, const std::vector<FileBin_LineTable_UnitType>& Unit);
+        void Clear();
+
+        uint32_t Rows() const;
+        bool Find(uint32_t Address, FileBin_LineTable_ResultType& Result) const;
+        /* File of a DW_AT_decl_file value of the given unit, nullptr if out of range */
+        const std::string* FileOf(uint32_t UnitIdx, uint32_t FileIdx) const;
+};
+
+#endif // FILEBIN_LINETABLE_H
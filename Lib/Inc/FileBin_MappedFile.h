@@ -0,0 +1,127 @@
+/**
+ *  \file       FileBin_MappedFile.h
+ *  \brief      Read-only memory mapped file
+ *
+ *  \version    1.0
+ *  \date       Oct 18, 2026
+ *  \author     Xavier Descarrega - DEVE embedded designs <info@deve.tech>
+ *
+ *  \copyright  MIT License
+ *
+ *              Copyright (c) 2026 Xavier Descarrega
+ *
+ *              Permission is hereby granted, free of charge, to any person obtaining a copy
+ *              of this software and associated documentation files (the "Software"), to deal
+ *              in the Software without restriction, including without limitation the rights
+ *              to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *              copies of the Software, and to permit persons to whom the Software is
+ *              furnished to do so, subject to the following conditions:
+ *
+ *              The above copyright notice and this permission notice shall be included in all
+ *              copies or substantial portions of the Software.
+ *
+ *              THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *              IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *              FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *              AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ *              LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *              OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *              SOFTWARE.
+ *
+ */
+
+#ifndef FILEBIN_MAPPEDFILE_H
+#define FILEBIN_MAPPEDFILE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+#if defined(_WIN32) || defined(_WIN64)
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+class FileBin_MappedFile
+{
+    public:
+        const uint8_t* data = nullptr;
+        size_t size = 0;
+
+    #if defined(_WIN32) || defined(_WIN64)
+    private:
+        HANDLE hFile = INVALID_HANDLE_VALUE;
+        HANDLE hMap = NULL;
+    #else
+    private:
+        int fd = -1;
+    #endif
+
+    public:
+        FileBin_MappedFile() = default;
+        FileBin_MappedFile(const FileBin_MappedFile&) = delete;
+        FileBin_MappedFile& operator=(const FileBin_MappedFile&) = delete;
+
+        bool open(const std::string& fileName)
+        {
+            /* Reopening drops the previous mapping */
+            close();
+
+    #if defined(_WIN32) || defined(_WIN64)
+            hFile = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                                NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+            if (hFile == INVALID_HANDLE_VALUE) return false;
+
+            LARGE_INTEGER fsize;
+            if (!GetFileSizeEx(hFile, &fsize)) { close(); return false; }
+            size = static_cast<size_t>(fsize.QuadPart);
+
+            hMap = CreateFileMappingA(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+            if (!hMap) { close(); return false; }
+
+            data = static_cast<const uint8_t*>(MapViewOfFile(hMap, FILE_MAP_READ, 0, 0, 0));
+            if (!data) { close(); return false; }
+
+    #else
+            fd = ::open(fileName.c_str(), O_RDONLY);
+            if (fd < 0) return false;
+
+            struct stat st;
+            if (fstat(fd, &st) < 0) { close(); return false; }
+            size = st.st_size;
+
+            void* map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (map == MAP_FAILED) { close(); return false; }
+            data = static_cast<const uint8_t*>(map);
+    #endif
+            return true;
+        }
+
+        void close()
+        {
+    #if defined(_WIN32) || defined(_WIN64)
+            if (data) UnmapViewOfFile(data);
+            if (hMap) CloseHandle(hMap);
+            if (hFile != INVALID_HANDLE_VALUE) CloseHandle(hFile);
+            hMap = NULL;
+            hFile = INVALID_HANDLE_VALUE;
+    #else
+            if (data) munmap((void*)data, size);
+            if (fd >= 0) ::close(fd);
+            fd = -1;
+    #endif
+            data = nullptr;
+            size = 0;
+        }
+
+        ~FileBin_MappedFile()
+        {
+            close();
+        }
+};
+
+#endif // FILEBIN_MAPPEDFILE_H
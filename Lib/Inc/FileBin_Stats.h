@@ -0,0 +1,125 @@
+/**
+ *  \file       FileBin_Stats.h
+ *  \brief      Load pipeline timers and counters
+ *
+ *  \version    1.0
+ *  \date       Oct 18, 2026
+ *  \author     Xavier Descarrega - DEVE embedded designs <info@deve.tech>
+ *
+ *  \copyright  MIT License
+ *
+ *              Copyright (c) 2026 Xavier Descarrega
+ *
+ *              Permission is hereby granted, free of charge, to any person obtaining a copy
+ *              of this software and associated documentation files (the "Software"), to deal
+ *              in the Software without restriction, including without limitation the rights
+ *              to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *              copies of the Software, and to permit persons to whom the Software is
+ *              furnished to do so, subject to the following conditions:
+ *
+ *              The above copyright notice and this permission notice shall be included in all
+ *              copies or substantial portions of the Software.
+ *
+ *              THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *              IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *              FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *              AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ *              LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *              OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *              SOFTWARE.
+ *
+ */
+
+#ifndef FILEBIN_STATS_H
+#define FILEBIN_STATS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/* Accumulated time of a pipeline phase, updated lock free from any thread */
+typedef struct FileBin_Stats_PhaseType
+{
+    std::string Name;
+    std::atomic<uint64_t> Calls{0};
+    std::atomic<uint64_t> TimeNs{0};
+    std::atomic<uint64_t> MaxNs{0}; /* Slowest single call, e.g. the largest CU */
+    std::atomic<uint64_t> Bytes{0}; /* Input bytes processed */
+} FileBin_Stats_PhaseType;
+
+typedef struct FileBin_Stats_CounterType
+{
+    std::string Name;
+    std::atomic<uint64_t> Value{0};
+} FileBin_Stats_CounterType;
+
+/* Plain copy of a phase or counter (Calls/TimeNs/MaxNs/Bytes are 0 for counters) */
+typedef struct
+{
+    std::string Name;
+    uint64_t Calls;
+    uint64_t TimeNs;
+    uint64_t MaxNs;
+    uint64_t Bytes;
+} FileBin_Stats_SnapshotType;
+
+/*
+ * Registry of named phases and counters. Entries are created on first use and never move, so hot
+ * paths look them up once and keep the pointer. Reset zeroes the values but keeps the entries.
+ */
+class FileBin_Stats
+{
+    private:
+
+        mutable std::mutex Lock;
+        std::deque<FileBin_Stats_PhaseType> PhaseList;
+        std::deque<FileBin_Stats_CounterType> CounterList;
+
+    public:
+
+        static FileBin_Stats& Global();
+
+        FileBin_Stats_PhaseType* Phase(const std::string& Name);
+        FileBin_Stats_CounterType* Counter(const std::string& Name);
+
+        void PhaseAdd(FileBin_Stats_PhaseType* Phase, uint64_t Ns, uint64_t Bytes);
+        void CounterAdd(const std::string& Name, uint64_t Value);
+        void CounterSet(const std::string& Name, uint64_t Value);
+        void Reset();
+
+        std::vector<FileBin_Stats_SnapshotType> Phases() const;
+        std::vector<FileBin_Stats_SnapshotType> Counters() const;
+        std::string ToJSON() const;
+
+        static uint64_t PeakRSSBytes();
+        /* Process wide operator new calls/bytes (not cleared by Reset), 0 unless built with FILEBIN_STATS_ALLOC_HOOK */
+        static uint64_t AllocCount();
+        static uint64_t AllocBytes();
+};
+
+/* Adds the lifetime of the object to a phase */
+class FileBin_StatsTimer
+{
+    private:
+
+        FileBin_Stats_PhaseType* PhaseRef;
+        uint64_t BytesDone;
+        std::chrono::steady_clock::time_point Start;
+
+    public:
+
+        explicit FileBin_StatsTimer(FileBin_Stats_PhaseType* Phase, uint64_t Bytes = 0);
+        explicit FileBin_StatsTimer(const std::string& Phase, uint64_t Bytes = 0);
+        ~FileBin_StatsTimer();
+
+        FileBin_StatsTimer(const FileBin_StatsTimer&) = delete;
+        FileBin_StatsTimer& operator=(const FileBin_StatsTimer&) = delete;
+
+        void AddBytes(uint64_t Bytes);
+};
+
+#endif // FILEBIN_STATS_H
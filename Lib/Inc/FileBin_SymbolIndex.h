@@ -0,0 +1,109 @@
+/**
+ *  \file       FileBin_SymbolIndex.h
+ *  \brief      Prefix and substring search over fully qualified symbol paths
+ *
+ *  \version    1.0
+ *  \date       Oct 18, 2026
+ *  \author     Xavier Descarrega - DEVE embedded designs <info@deve.tech>
+ *
+ *  \copyright  MIT License
+ *
+ *              Copyright (c) 2026 Xavier Descarrega
+ *
+ *              Permission is hereby granted, free of charge, to any person obtaining a copy
+ *              of this software and associated documentation files (the "Software"), to deal
+ *              in the Software without restriction, including without limitation the rights
+ *              to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *              copies of the Software, and to permit persons to whom the Software is
+ *              furnished to do so, subject to the following conditions:
+ *
+ *              The above copyright notice and this permission notice shall be included in all
+ *              copies or substantial portions of the Software.
+ *
+ *              THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *              IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *              FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *              AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ *              LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *              OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *              SOFTWARE.
+ *
+ */
+
+#ifndef FILEBIN_SYMBOLINDEX_H
+#define FILEBIN_SYMBOLINDEX_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "FileBin_DWARF.h"
+
+#define FILEBIN_SYMBOLINDEX_NO_PARENT 0xFFFFFFFFu
+
+/* One searchable symbol, paths look like cu/var.member[i].field */
+typedef struct
+{
+    uint32_t CUIdx;
+    uint32_t Addr; /* Absolute */
+    uint32_t Size; /* Bytes */
+    uint32_t ElemSize; /* Array element stride, equal to Size for non arrays */
+    uint32_t Parent; /* Id of the enclosing entry, FILEBIN_SYMBOLINDEX_NO_PARENT for CU level variables */
+    FileBin_DWARF_VarInfoLenType DataType;
+    bool IsLeaf; /* No member entries below */
+    FileBin_DWARF_BitFieldType BitField; /* Bitfield members, Addr/Size are the storage unit */
+} FileBin_SymbolIndex_EntryType;
+
+/* Radix trie node, every node covers the range [EntryBegin, EntryEnd) of the path sorted entries */
+typedef struct
+{
+    uint32_t LabelEntry; /* Entry whose path holds the edge label */
+    uint32_t LabelBegin;
+    uint32_t LabelLen;
+    uint32_t FirstChild;
+    uint32_t ChildCnt;
+    uint32_t EntryBegin;
+    uint32_t EntryEnd;
+} FileBin_SymbolIndex_TrieNodeType;
+
+class FileBin_SymbolIndex
+{
+    private:
+
+        std::vector<FileBin_SymbolIndex_EntryType> Entry;
+        std::string PathData; /* All paths back to back */
+        std::vector<uint32_t> PathOffset; /* Entry i spans [PathOffset[i], PathOffset[i + 1]) */
+
+        std::vector<uint32_t> Sorted; /* Entry ids in path order */
+        std::vector<FileBin_SymbolIndex_TrieNodeType> Trie;
+
+        /* Lower case trigrams hashed into buckets, posting lists of entry ids in ascending order */
+        std::vector<uint32_t> TrigramOffset;
+        std::vector<uint32_t> TrigramPosting;
+
+        void BuildSort();
+        void BuildTrie(uint32_t Begin, uint32_t End, uint32_t Depth, uint32_t NodeIdx);
+        void BuildTrigram();
+        bool Contains(uint32_t Id, const std::string& LowerText) const;
+        uint32_t PostingLen(uint32_t Bucket) const;
+        void SortByPostingLen(std::vector<uint32_t>& Buckets) const;
+
+    public:
+
+        /* Walks every CU (acquiring evicted ones) and indexes the paths in parallel */
+        void Build(FileBin_DWARF* dwarf);
+        void Clear();
+
+        uint32_t Size() const;
+        std::string_view GetPath(uint32_t Id) const;
+        const FileBin_SymbolIndex_EntryType& GetEntry(uint32_t Id) const;
+
+        /* Case sensitive, results in path order */
+        std::vector<uint32_t> FindPrefix(const std::string& Prefix, uint32_t MaxResults) const;
+        /* Case insensitive, results in entry order */
+        std::vector<uint32_t> FindSubstring(const std::string& Text, uint32_t MaxResults) const;
+        /* Case insensitive, ranked by shared trigrams, at least half of the distinctive query trigrams must match */
+        std::vector<uint32_t> FindFuzzy(const std::string& Text, uint32_t MaxResults) const;
+};
+
+#endif // FILEBIN_SYMBOLINDEX_H
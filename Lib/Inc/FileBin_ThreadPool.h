@@ -0,0 +1,114 @@
+/**
+ *  \file       FileBin_ThreadPool.h
+ *  \brief      Work-stealing thread pool
+ *
+ *  \version    1.0
+ *  \date       Oct 18, 2026
+ *  \author     Xavier Descarrega - DEVE embedded designs <info@deve.tech>
+ *
+ *  \copyright  MIT License
+ *
+ *              Copyright (c) 2026 Xavier Descarrega
+ *
+ *              Permission is hereby granted, free of charge, to any person obtaining a copy
+ *              of this software and associated documentation files (the "Software"), to deal
+ *              in the Software without restriction, including without limitation the rights
+ *              to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *              copies of the Software, and to permit persons to whom the Software is
+ *              furnished to do so, subject to the following conditions:
+ *
+ *              The above copyright notice and this permission notice shall be included in all
+ *              copies or substantial portions of the Software.
+ *
+ *              THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *              IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *              FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *              AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ *              LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *              OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *              SOFTWARE.
+ *
+ */
+
+#ifndef FILEBIN_THREADPOOL_H
+#define FILEBIN_THREADPOOL_H
+
+#include <cstdint>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct FileBin_ThreadPool_JobType;
+
+/* Range [Begin, End) of a ParallelFor job, split in halves until it fits the job grain */
+typedef struct
+{
+    FileBin_ThreadPool_JobType* Job;
+    uint32_t Begin;
+    uint32_t End;
+} FileBin_ThreadPool_TaskType;
+
+/* Chase-Lev deque: owner pushes/pops at the bottom, thieves take from the top without locking */
+class FileBin_ThreadPool_Deque
+{
+    private:
+
+        static const int64_t Capacity = 1024; /* Splitting is depth first, a few entries per running task */
+
+        std::atomic<int64_t> Top;
+        std::atomic<int64_t> Bottom;
+        std::atomic<FileBin_ThreadPool_TaskType*> Buffer[Capacity];
+
+    public:
+
+        FileBin_ThreadPool_Deque();
+
+        bool Push(FileBin_ThreadPool_TaskType* task);
+        FileBin_ThreadPool_TaskType* Pop();
+        FileBin_ThreadPool_TaskType* Steal();
+};
+
+class FileBin_ThreadPool
+{
+    private:
+
+        std::vector<std::thread> Worker;
+        std::vector<FileBin_ThreadPool_Deque*> WorkerQueue;
+
+        /* Tasks submitted from threads outside the pool */
+        std::mutex InjectLock;
+        std::deque<FileBin_ThreadPool_TaskType*> Inject;
+
+        std::mutex SleepLock;
+        std::condition_variable SleepCond;
+        std::atomic<uint32_t> Pending;
+        std::atomic<uint32_t> Sleeping;
+        std::atomic<bool> Stop;
+
+        void WorkerLoop(uint32_t Idx);
+        void Submit(FileBin_ThreadPool_TaskType* task);
+        FileBin_ThreadPool_TaskType* Acquire();
+        void Run(FileBin_ThreadPool_TaskType* task);
+
+    public:
+
+        explicit FileBin_ThreadPool(uint32_t ThreadCnt);
+        ~FileBin_ThreadPool();
+
+        FileBin_ThreadPool(const FileBin_ThreadPool&) = delete;
+        FileBin_ThreadPool& operator=(const FileBin_ThreadPool&) = delete;
+
+        /* Calls fn on disjoint sub-ranges of [0, Count), the calling thread helps until all of them are done */
+        void ParallelFor(uint32_t Count, uint32_t Grain, const std::function<void(uint32_t, uint32_t)>& fn);
+
+        uint32_t Size() const;
+
+        /* Pool used by the parsers, created on first use with one worker per hardware thread */
+        static FileBin_ThreadPool& Shared();
+};
+
+#endif // FILEBIN_THREADPOOL_H
@@ -0,0 +1,110 @@
+/**
+ *  \file       FileBin_Trace.h
+ *  \brief      Per-thread trace events exported as Chrome trace JSON
+ *
+ *  \version    1.0
+ *  \date       Oct 18, 2026
+ *  \author     Xavier Descarrega - DEVE embedded designs <info@deve.tech>
+ *
+ *  \copyright  MIT License
+ *
+ *              Copyright (c) 2026 Xavier Descarrega
+ *
+ *              Permission is hereby granted, free of charge, to any person obtaining a copy
+ *              of this software and associated documentation files (the "Software"), to deal
+ *              in the Software without restriction, including without limitation the rights
+ *              to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *              copies of the Software, and to permit persons to whom the Software is
+ *              furnished to do so, subject to the following conditions:
+ *
+ *              The above copyright notice and this permission notice shall be included in all
+ *              copies or substantial portions of the Software.
+ *
+ *              THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *              IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *              FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *              AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ *              LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *              OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *              SOFTWARE.
+ *
+ */
+
+#ifndef FILEBIN_TRACE_H
+#define FILEBIN_TRACE_H
+
+#include <cstdint>
+#include <string>
+
+#define LIBPARSER_TRACE_RING_EVENTS 65536 /* Per thread, power of two, oldest events are overwritten */
+
+/*
+ * Trace points are compiled out unless FILEBIN_TRACE is defined (CMake option FYNIX_TRACE). Event
+ * names must be string literals or otherwise outlive the trace, only the pointer is stored.
+ */
+#if defined(FILEBIN_TRACE)
+#define FILEBIN_TRACE_CAT2(a, b) a##b
+#define FILEBIN_TRACE_CAT(a, b) FILEBIN_TRACE_CAT2(a, b)
+#define FILEBIN_TRACE_SCOPE(Name) FileBin_TraceScope FILEBIN_TRACE_CAT(traceScope, __LINE__)(Name, 0)
+#define FILEBIN_TRACE_SCOPE_ARG(Name, Arg) FileBin_TraceScope FILEBIN_TRACE_CAT(traceScope, __LINE__)(Name, Arg)
+#define FILEBIN_TRACE_THREAD_NAME(Name) FileBin_Trace::SetThreadName(Name)
+#else
+/* Arguments are still referenced so parameters only used for tracing do not warn as unused */
+#define FILEBIN_TRACE_SCOPE(Name) ((void)(Name))
+#define FILEBIN_TRACE_SCOPE_ARG(Name, Arg) ((void)(Name), (void)(Arg))
+#define FILEBIN_TRACE_THREAD_NAME(Name) ((void)0)
+#endif
+
+typedef struct
+{
+    const char* Name;
+    uint64_t BeginNs;
+    uint64_t DurationNs;
+    uint64_t Arg;
+} FileBin_Trace_EventType;
+
+/*
+ * Each thread appends to its own ring buffer without locking, the registry lock is only taken the
+ * first time a thread records an event. Export while the traced threads are idle (e.g. after a
+ * load), events being written during ToJSON may be torn.
+ */
+class FileBin_Trace
+{
+    public:
+
+        static uint64_t Now();
+        static void Record(const char* Name, uint64_t BeginNs, uint64_t EndNs, uint64_t Arg);
+        static void SetThreadName(const std::string& Name);
+
+        /* Hides the events recorded so far, the buffers of other threads are not touched */
+        static void Clear();
+
+        /* Chrome trace event format, loads in chrome://tracing and the Perfetto UI */
+        static std::string ToJSON();
+        static bool WriteJSON(const std::string& FileName);
+};
+
+class FileBin_TraceScope
+{
+    private:
+
+        const char* Name;
+        uint64_t Arg;
+        uint64_t Begin;
+
+    public:
+
+        FileBin_TraceScope(const char* Name, uint64_t Arg) : Name(Name), Arg(Arg), Begin(FileBin_Trace::Now())
+        {
+        }
+
+        ~FileBin_TraceScope()
+        {
+            FileBin_Trace::Record(this->Name, this->Begin, FileBin_Trace::Now(), this->Arg);
+        }
+
+        FileBin_TraceScope(const FileBin_TraceScope&) = delete;
+        FileBin_TraceScope& operator=(const FileBin_TraceScope&) = delete;
+};
+
+#endif // FILEBIN_TRACE_H
@@ -0,0 +1,197 @@
+/**
+ *  \file       FileBin_AddrIndex.cpp
+ *  \brief      Address to symbol reverse lookup
+ *
+ *  \version    1.0
+ *  \date       Oct 18, 2026
+ *  \author     Xavier Descarrega - DEVE embedded designs <info@deve.tech>
+ *
+ *  \copyright  MIT License
+ *
+ *              Copyright (c) 2026 Xavier Descarrega
+ *
+ *              Permission is hereby granted, free of charge, to any person obtaining a copy
+ *              of this software and associated documentation files (the "Software"), to deal
+ *              in the Software without restriction, including without limitation the rights
+ *              to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *              copies of the Software, and to permit persons to whom the Software is
+ *              furnished to do so, subject to the following conditions:
+ *
+ *              The above copyright notice and this permission notice shall be included in all
+ *              copies or substantial portions of the Software.
+ *
+ *              THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *              IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *              FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *              AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ *              LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *              OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *              SOFTWARE.
+ *
+ */
+
+#include "FileBin_AddrIndex.h"
+#include <algorithm>
+#include <numeric>
+
+void FileBin_AddrIndex::Clear()
+{
+    this->Index = nullptr;
+    this->Eytzinger.clear();
+    this->EytzingerPrevId.clear();
+    this->LastId = FILEBIN_ADDRINDEX_NONE;
+}
+
+uint32_t FileBin_AddrIndex::Segments() const
+{
+    return this->Eytzinger.empty() ? 0 : static_cast<uint32_t>(this->Eytzinger.size() - 1);
+}
+
+void FileBin_AddrIndex::Build(const FileBin_SymbolIndex& Index)
+{
+    this->Clear();
+    this->Index = &Index;
+
+    /* Outer ranges first: by start, longest first, then parent before child (ids grow with depth) */
+    std::vector<uint32_t> order;
+    order.reserve(Index.Size());
+    for (uint32_t id = 0; id < Index.Size(); id++)
+    {
+        if (Index.GetEntry(id).Size > 0)
+        {
+            order.push_back(id);
+        }
+    }
+    std::sort(order.begin(), order.end(), [&Index](uint32_t a, uint32_t b)
+    {
+        const FileBin_SymbolIndex_EntryType& ea = Index.GetEntry(a);
+        const FileBin_SymbolIndex_EntryType& eb = Index.GetEntry(b);
+        if (ea.Addr != eb.Addr)
+        {
+            return ea.Addr < eb.Addr;
+        }
+        if (ea.Size != eb.Size)
+        {
+            return ea.Size > eb.Size;
+        }
+        return a < b;
+    });
+
+    /* Sweep with a stack of open ranges, the top is the innermost one */
+    std::vector<uint32_t> segStart;
+    std::vector<uint32_t> segId;
+    std::vector<uint32_t> open;
+    uint64_t pos = 0;
+
+    auto rangeEnd = [&Index](uint32_t id)
+    {
+        return static_cast<uint64_t>(Index.GetEntry(id).Addr) + Index.GetEntry(id).Size;
+    };
+    auto emit = [&segStart, &segId](uint64_t start, uint32_t id)
+    {
+        if (!segStart.empty() && (segStart.back() == start))
+        {
+            segId.back() = id;
+        }
+        else if (segId.empty() || (segId.back() != id))
+        {
+            segStart.push_back(static_cast<uint32_t>(start));
+            segId.push_back(id);
+        }
+    };
+    auto closeUntil = [&](uint64_t limit)
+    {
+        while (!open.empty() && (rangeEnd(open.back()) <= limit))
+        {
+            uint64_t end = rangeEnd(open.back());
+            open.pop_back();
+            if (end > pos)
+            {
+                pos = end;
+                /* Overlapping (non nested) ranges may already be past their end */
+                while (!open.empty() && (rangeEnd(open.back()) <= pos))
+                {
+                    open.pop_back();
+                }
+                if (pos <= 0xFFFFFFFFu)
+                {
+                    emit(pos, open.empty() ? FILEBIN_ADDRINDEX_NONE : open.back());
+                }
+            }
+        }
+    };
+
+    for (uint32_t id : order)
+    {
+        uint32_t start = Index.GetEntry(id).Addr;
+        closeUntil(start);
+
+        open.push_back(id);
+        pos = start;
+        emit(pos, id);
+    }
+    closeUntil(0x100000000ull);
+
+    /* Eytzinger layout of the segment starts */
+    uint32_t n = static_cast<uint32_t>(segStart.size());
+    this->Eytzinger.assign(n + 1, 0);
+    this->EytzingerPrevId.assign(n + 1, FILEBIN_ADDRINDEX_NONE);
+    this->LastId = (n > 0) ? segId.back() : FILEBIN_ADDRINDEX_NONE;
+    uint32_t src = 0;
+    this->BuildEytzinger(segStart, segId, src, 1);
+}
+
+/* In-order traversal of the implicit tree assigns the sorted values */
+void FileBin_AddrIndex::BuildEytzinger(const std::vector<uint32_t>& SegStart, const std::vector<uint32_t>& SegId, uint32_t& Src, uint32_t Slot)
+{
+    if (Slot < this->Eytzinger.size())
+    {
+        this->BuildEytzinger(SegStart, SegId, Src, 2 * Slot);
+        this->Eytzinger[Slot] = SegStart[Src];
+        this->EytzingerPrevId[Slot] = (Src > 0) ? SegId[Src - 1] : FILEBIN_ADDRINDEX_NONE;
+        Src++;
+        this->BuildEytzinger(SegStart, SegId, Src, 2 * Slot + 1);
+    }
+}
+
+FileBin_AddrIndex_ResultType FileBin_AddrIndex::Find(uint32_t Addr) const
+{
+    FileBin_AddrIndex_ResultType result = {FILEBIN_ADDRINDEX_NONE, 0, 0};
+    uint32_t n = this->Segments();
+    if (n == 0)
+    {
+        return result;
+    }
+
+    /* First segment starting after Addr, the comparison only selects the next slot. The slots four
+       levels down share one cache line and are fetched ahead */
+    const uint32_t* eyt = this->Eytzinger.data();
+    uint32_t k = 1;
+    while (k <= n)
+    {
+#if defined(__GNUC__)
+        __builtin_prefetch(eyt + 16 * static_cast<size_t>(k));
+#endif
+        k = 2 * k + (eyt[k] <= Addr);
+    }
+    /* Drop the trailing right turns (and the last left turn) to get back to that node */
+    while (k & 1u)
+    {
+        k >>= 1;
+    }
+    k >>= 1;
+
+    /* The symbol is the one of the segment just before, or the last segment if none starts after Addr */
+    uint32_t id = (k == 0) ? this->LastId : this->EytzingerPrevId[k];
+    if (id == FILEBIN_ADDRINDEX_NONE)
+    {
+        return result;
+    }
+
+    const FileBin_SymbolIndex_EntryType& e = this->Index->GetEntry(id);
+    uint32_t stride = ((e.ElemSize > 0) && e.IsLeaf) ? e.ElemSize : e.Size;
+    result.Id = id;
+    result.ElemIdx = (Addr - e.Addr) / stride;
+    result.Offset = (Addr - e.Addr) % stride;
+    return result;
+}
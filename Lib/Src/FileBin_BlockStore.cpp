@@ -0,0 +1,157 @@
+/**
+ *  \file       FileBin_BlockStore.cpp
+ *  \brief      Content-hashed copy-on-write blocks shared between memory images
+ *
+ *  \version    1.0
+ *  \date       Oct 18, 2026
+ *  \author     Xavier Descarrega - DEVE embedded designs <info@deve.tech>
+ *
+ *  \copyright  MIT License
+ *
+ *              Copyright (c) 2026 Xavier Descarrega
+ *
+ *              Permission is hereby granted, free of charge, to any person obtaining a copy
+ *              of this software and associated documentation files (the "Software"), to deal
+ *              in the Software without restriction, including without limitation the rights
+ *              to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *              copies of the Software, and to permit persons to whom the Software is
+ *              furnished to do so, subject to the following conditions:
+ *
+ *              The above copyright notice and this permission notice shall be included in all
+ *              copies or substantial portions of the Software.
+ *
+ *              THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *              IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *              FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *              AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ *              LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *              OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *              SOFTWARE.
+ *
+ */
+
+#include "FileBin_BlockStore.h"
+#include "FileBin_Stats.h"
+#include "FileBin_ThreadPool.h"
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+/* Eight bytes per step, blocks with equal hashes are still compared in full */
+static uint64_t BlockStoreHash(const uint8_t *pData)
+{
+    uint64_t hash = 0x9E3779B97F4A7C15ull;
+
+    for (uint32_t i = 0; i < LIBPARSER_BLOCKSTORE_BYTES; i += 8u)
+    {
+        uint64_t word;
+        memcpy(&word, pData + i, sizeof(word));
+        hash = (hash ^ word) * 0xFF51AFD7ED558CCDull;
+        hash ^= hash >> 32u;
+    }
+
+    return hash;
+}
+
+FileBin_BlockPtr FileBin_BlockStore::NewBlock(void)
+{
+    /* Not make_shared: the weak references of the index would keep the bytes allocated */
+    return FileBin_BlockPtr(new FileBin_BlockType());
+}
+
+FileBin_BlockPtr FileBin_BlockStore::Clone(const FileBin_BlockType& Block)
+{
+    FileBin_BlockPtr copy(new FileBin_BlockType);
+
+    copy->Hash = 0;
+    copy->isShared = false;
+    memcpy(copy->Byte, Block.Byte, LIBPARSER_BLOCKSTORE_BYTES);
+
+    return copy;
+}
+
+bool FileBin_BlockStore::IsWritable(const FileBin_BlockPtr& Block)
+{
+    return (!Block->isShared) && (Block.use_count() == 1);
+}
+
+void FileBin_BlockStore::Intern(FileBin_BlockPtr *pBlock, size_t Count)
+{
+    /* Hashing is the bulk of the work and needs no lock */
+    FileBin_ThreadPool::Shared().ParallelFor(static_cast<uint32_t>(Count), 256, [&](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t i = begin; i < end; i++)
+        {
+            if (!pBlock[i]->isShared)
+            {
+                pBlock[i]->Hash = BlockStoreHash(pBlock[i]->Byte);
+            }
+        }
+    });
+
+    std::lock_guard<std::mutex> guard(this->Lock);
+    uint64_t hits = 0;
+
+    for (size_t i = 0; i < Count; i++)
+    {
+        if (pBlock[i]->isShared)
+        {
+            continue;
+        }
+
+        auto range = this->Index.equal_range(pBlock[i]->Hash);
+        FileBin_BlockPtr resident;
+
+        for (auto it = range.first; (it != range.second) && !resident; ++it)
+        {
+            FileBin_BlockPtr candidate = it->second.lock();
+            if (candidate && (memcmp(candidate->Byte, pBlock[i]->Byte, LIBPARSER_BLOCKSTORE_BYTES) == 0))
+            {
+                resident = candidate;
+            }
+        }
+
+        if (resident)
+        {
+            pBlock[i] = resident;
+            hits++;
+        }
+        else
+        {
+            pBlock[i]->isShared = true;
+            this->Index.emplace(pBlock[i]->Hash, pBlock[i]);
+        }
+    }
+
+    /* Entries of freed blocks pile up as images are closed, dropped once the index has doubled */
+    if (this->Index.size() >= this->PurgeAt)
+    {
+        for (auto it = this->Index.begin(); it != this->Index.end(); )
+        {
+            it = it->second.expired() ? this->Index.erase(it) : std::next(it);
+        }
+        this->PurgeAt = std::max<size_t>(1024, 2 * this->Index.size());
+    }
+
+    FileBin_Stats::Global().CounterAdd("blockstore.interned", Count);
+    FileBin_Stats::Global().CounterAdd("blockstore.deduplicated", hits);
+}
+
+size_t FileBin_BlockStore::Resident(void)
+{
+    std::lock_guard<std::mutex> guard(this->Lock);
+    size_t count = 0;
+
+    for (const auto& entry : this->Index)
+    {
+        count += entry.second.expired() ? 0 : 1;
+    }
+
+    return count;
+}
+
+FileBin_BlockStore& FileBin_BlockStore::Shared(void)
+{
+    static FileBin_BlockStore store;
+    return store;
+}
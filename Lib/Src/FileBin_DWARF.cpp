@@ -32,102 +32,124 @@
 
 #include "FileBin_DWARF.h"
 #include "FileBin_DWARF_Def.h"
+#include "FileBin_ThreadPool.h"
+#include "FileBin_Stats.h"
+#include <algorithm>
 #include <cassert>
-#include <queue>
 #include <string>
 #include <cstring>
 #include <iostream>
-#include <thread>
+#include <iterator>
 #include <vector>
 #include <mutex>
 
-#if defined(_WIN32) || defined(_WIN64)
-#include <windows.h>
-#else
-#include <sys/mman.h>
-#include <sys/stat.h>
-#include <fcntl.h>
-#include <unistd.h>
-#endif
+#define LIBPARSER_DWARF_BYTESLEBMAX 24
+#define LIBPARSER_DWARF_BITSPERBYTE 8
+#define LIBPARSER_DWARF_DEBUG_ABBRV (0)
+#define LIBPARSER_DWARF_DEBUG (0)
+#define LIBPARSER_DWARF_SYMBOL_GRAIN 256 /* Top level DIEs resolved per pool task */
+#define LIBPARSER_DWARF_PROGRESS_DIE_MASK 0xFFF /* Progress and cancellation polled every 4096 DIEs */
+#define LIBPARSER_DWARF_NAME_HOPS 4 /* DW_AT_specification / DW_AT_abstract_origin followed for a function name */
 
-class MappedFile
+FileBin_DWARF::FileBin_DWARF()
 {
-    public:
-        const uint8_t* data = nullptr;
-        size_t size = 0;
-
-    #if defined(_WIN32) || defined(_WIN64)
-    private:
-        HANDLE hFile = INVALID_HANDLE_VALUE;
-        HANDLE hMap = NULL;
-    #else
-    private:
-        int fd = -1;
-    #endif
-
-    public:
-        bool open(const std::string& fileName)
-        {
-    #if defined(_WIN32) || defined(_WIN64)
-            hFile = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ,
-                                NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
-            if (hFile == INVALID_HANDLE_VALUE) return false;
-
-            LARGE_INTEGER fsize;
-            if (!GetFileSizeEx(hFile, &fsize)) return false;
-            size = static_cast<size_t>(fsize.QuadPart);
-
-            hMap = CreateFileMappingA(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
-            if (!hMap) return false;
-
-            data = static_cast<const uint8_t*>(MapViewOfFile(hMap, FILE_MAP_READ, 0, 0, 0));
-            if (!data) return false;
-
-    #else
-            fd = ::open(fileName.c_str(), O_RDONLY);
-            if (fd < 0) return false;
-
-            struct stat st;
-            if (fstat(fd, &st) < 0) return false;
-            size = st.st_size;
-
-            data = static_cast<const uint8_t*>(mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0));
-            if (data == MAP_FAILED) return false;
-    #endif
-            return true;
-        }
+    this->DataRoot = nullptr;
+    this->SymbolRoot = nullptr;
+    this->CancelRequest = false;
+    this->ProgressInterval = std::chrono::milliseconds(100);
+    this->ProgressTick = 0;
+    this->CacheStats = FileBin_DWARF_CacheStatsType();
+}
 
-        void close()
-        {
-    #if defined(_WIN32) || defined(_WIN64)
-            if (data) UnmapViewOfFile(data);
-            if (hMap) CloseHandle(hMap);
-            if (hFile != INVALID_HANDLE_VALUE) CloseHandle(hFile);
-    #else
-            if (data) munmap((void*)data, size);
-            if (fd >= 0) ::close(fd);
-    #endif
-            data = nullptr;
-            size = 0;
-        }
+FileBin_DWARF::~FileBin_DWARF()
+{
+    this->Reset();
+}
+
+void FileBin_DWARF::SetProgressCallback(FileBin_DWARF_ProgressCb Callback, uint32_t IntervalMs)
+{
+    std::lock_guard<std::mutex> lock(this->ProgressLock);
+    this->ProgressCallback = Callback;
+    this->ProgressInterval = std::chrono::milliseconds(IntervalMs);
+}
+
+void FileBin_DWARF::Cancel()
+{
+    this->CancelRequest.store(true);
+}
+
+bool FileBin_DWARF::IsCancelled() const
+{
+    return this->CancelRequest.load(std::memory_order_relaxed);
+}
 
-        ~MappedFile()
+/* Reports at most once per interval unless forced, may be called from any pool thread */
+void FileBin_DWARF::ReportProgress(bool Force)
+{
+    std::unique_lock<std::mutex> lock(this->ProgressLock, std::try_to_lock);
+
+    if (!lock.owns_lock())
+    {
+        if (!Force)
         {
-            close();
+            return;
         }
-};
+        lock.lock();
+    }
 
-#define LIBPARSER_DWARF_BYTESLEBMAX 24
-#define LIBPARSER_DWARF_BITSPERBYTE 8
-#define LIBPARSER_DWARF_DEBUG_ABBRV (0)
-#define LIBPARSER_DWARF_DEBUG (0)
+    if (!this->ProgressCallback)
+    {
+        return;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    if ((!Force) && ((now - this->ProgressLast) < this->ProgressInterval))
+    {
+        return;
+    }
+    this->ProgressLast = now;
 
-uint8_t HeaderSize_Byte;
+    FileBin_DWARF_ProgressType progress;
+    progress.InfoBytesDone = this->ProgressInfoBytes.load();
+    progress.InfoBytesTotal = this->ProgressInfoTotal;
+    progress.CUDone = this->ProgressCUDone.load();
+    progress.CUTotal = static_cast<uint32_t>(this->CompilationUnit.size());
+    progress.SymbolCnt = this->ProgressSymbolCnt.load();
 
-FileBin_DWARF::FileBin_DWARF()
+    this->ProgressCallback(progress);
+}
+
+void FileBin_DWARF::Reset()
 {
+    FreeTree(this->DataRoot);
     this->DataRoot = nullptr;
+
+    /* Symbols reference the CU type layouts, release them first */
+    FreeSymTree(this->SymbolRoot);
     this->SymbolRoot = nullptr;
+
+    for (auto* cu : this->CompilationUnit)
+    {
+        FreeCompileUnit(cu);
+    }
+    this->CompilationUnit.clear();
+
+    this->AbbrevOffsetCache.clear();
+
+    this->CUTreeNode.clear();
+    this->CUSymbolNode.clear();
+    this->CacheLRU.clear();
+    this->CacheLRUPos.clear();
+    this->CacheStats.ResidentBytes = 0;
+    this->CacheStats.Hits = 0;
+    this->CacheStats.Misses = 0;
+    this->CacheStats.Evictions = 0;
+
+    this->LineTable.Clear();
+
+    this->SymtabIndex.clear();
+    this->SymtabOwner.clear();
+    this->SymtabScanned = false;
 }
 
 std::string FileBin_DWARF::FileBin_DWARF_DW_TAG_ToString(uint16_t StrCode)
@@ -441,6 +463,58 @@ inline int64_t FileBin_DWARF::FileBin_DWARF_ReadSLEB128(
     }
 }
 
+/* Size of the forms that do not depend on the DIE content, -1 otherwise (DW_FORM_addr depends on the CU) */
+static int32_t FileBin_DWARF_FormFixedSize(uint64_t form)
+{
+    switch (form)
+    {
+        case DW_FORM_flag_present:
+        case DW_FORM_implicit_const:
+            return 0;
+
+        case DW_FORM_data1:
+        case DW_FORM_ref1:
+        case DW_FORM_flag:
+        case DW_FORM_strx1:
+        case DW_FORM_addrx1:
+            return 1;
+
+        case DW_FORM_data2:
+        case DW_FORM_ref2:
+        case DW_FORM_strx2:
+        case DW_FORM_addrx2:
+            return 2;
+
+        case DW_FORM_strx3:
+        case DW_FORM_addrx3:
+            return 3;
+
+        case DW_FORM_data4:
+        case DW_FORM_ref4:
+        case DW_FORM_strp:
+        case DW_FORM_line_strp:
+        case DW_FORM_sec_offset:
+        case DW_FORM_strx4:
+        case DW_FORM_addrx4:
+        case DW_FORM_ref_addr: /* Offset size, only the 32-bit DWARF format is parsed */
+        case DW_FORM_strp_sup:
+        case DW_FORM_ref_sup4:
+            return 4;
+
+        case DW_FORM_data8:
+        case DW_FORM_ref8:
+        case DW_FORM_ref_sig8:
+        case DW_FORM_ref_sup8:
+            return 8;
+
+        case DW_FORM_data16:
+            return 16;
+
+        default:
+            return -1;
+    }
+}
+
 FileBin_DWARF_CompileUnitDataType* FileBin_DWARF::ParseAbbrevOffset(const uint8_t* abbrevPtr)
 {
     uint32_t abbrevOffset = static_cast<uint32_t>(abbrevPtr - this->fileBase); // fileBase = mmap base
@@ -474,6 +548,10 @@ FileBin_DWARF_CompileUnitDataType* FileBin_DWARF::ParseAbbrevOffset(const uint8_
         abbrev.code = static_cast<uint32_t>(code);
         abbrev.tag = static_cast<uint32_t>(FileBin_DWARF_ReadULEB128(ptr));
         abbrev.hasChildren = (*ptr++ != 0);
+        abbrev.fixedSize = 0;
+        abbrev.addrCnt = 0;
+        abbrev.siblingIdx = -1;
+        abbrev.locationIdx = -1;
 
 #if (1 == LIBPARSER_DWARF_DEBUG)
         std::cout << "Abbrev " << abbrev.code << "\n";
@@ -491,7 +569,37 @@ FileBin_DWARF_CompileUnitDataType* FileBin_DWARF::ParseAbbrevOffset(const uint8_
 #if (1 == LIBPARSER_DWARF_DEBUG)
             std::cout << "  Attr " << FileBin_DWARF_DW_AT_ToString(attr) << "\n";
 #endif
-            abbrev.attributes.push_back({static_cast<uint32_t>(attr), static_cast<uint32_t>(form)});
+            int64_t implicitConst = 0;
+            if (form == DW_FORM_implicit_const)
+            {
+                implicitConst = FileBin_DWARF_ReadSLEB128(ptr);
+            }
+
+            /* Layout used to step over DIEs without decoding them (see SkipDIE) */
+            int32_t formSize = FileBin_DWARF_FormFixedSize(form);
+            if (form == DW_FORM_addr)
+            {
+                abbrev.addrCnt++;
+            }
+            else if ((formSize < 0) || (abbrev.fixedSize < 0))
+            {
+                abbrev.fixedSize = -1;
+            }
+            else
+            {
+                abbrev.fixedSize += formSize;
+            }
+
+            if (attr == DW_AT_sibling)
+            {
+                abbrev.siblingIdx = static_cast<int32_t>(abbrev.attributes.size());
+            }
+            else if (attr == DW_AT_location)
+            {
+                abbrev.locationIdx = static_cast<int32_t>(abbrev.attributes.size());
+            }
+
+            abbrev.attributes.push_back({static_cast<uint32_t>(attr), static_cast<uint32_t>(form), implicitConst});
         }
 
         cu.abbrevTable.emplace(abbrev.code, std::move(abbrev));
@@ -588,10 +696,30 @@ std::vector<uint8_t> FileBin_DWARF::ReadAttributeValue(const uint8_t*& ptr, uint
             break;
         }
 
+        case DW_FORM_block4:
+        {
+            uint32_t blockLen = readU32(ptr);
+            data.insert(data.end(), ptr, ptr + blockLen);
+            ptr += blockLen;
+            break;
+        }
+
+        case DW_FORM_block:
+        {
+            uint64_t blockLen = FileBin_DWARF_ReadULEB128(ptr);
+            data.insert(data.end(), ptr, ptr + blockLen);
+            ptr += blockLen;
+            break;
+        }
+
         case DW_FORM_strp:
+        case DW_FORM_line_strp:
         {
             uint32_t strOffset = readU32(ptr);
-            const uint8_t* strStart = fileBase + StrOffset + strOffset;
+            uint32_t sectionOffset = (form == DW_FORM_line_strp) ? LineStrOffset : StrOffset;
+            if (sectionOffset == 0)
+                break; /* No .debug_line_str given by the caller */
+            const uint8_t* strStart = fileBase + sectionOffset + strOffset;
             const uint8_t* strEnd = strStart;
             while (*strEnd) ++strEnd;
             data.insert(data.end(), strStart, strEnd);
@@ -599,12 +727,14 @@ std::vector<uint8_t> FileBin_DWARF::ReadAttributeValue(const uint8_t*& ptr, uint
         }
 
         case DW_FORM_data1:
+        case DW_FORM_ref1:
         {
             data.push_back(*ptr++);
             break;
         }
 
         case DW_FORM_data2:
+        case DW_FORM_ref2:
         {
             uint16_t v = readU16(ptr);
             data.resize(2);
@@ -685,9 +815,75 @@ std::vector<uint8_t> FileBin_DWARF::ReadAttributeValue(const uint8_t*& ptr, uint
 
         case DW_FORM_ref_udata:
         {
-            uint64_t len = FileBin_DWARF_ReadULEB128(ptr);
-            //data.insert(data.end(), ptr, ptr + len);
-            //ptr += len;
+            uint64_t v = FileBin_DWARF_ReadULEB128(ptr);
+            do {
+                data.push_back(static_cast<uint8_t>(v & 0xFF));
+                v >>= 8;
+            } while (v);
+            break;
+        }
+
+        case DW_FORM_data16:
+        {
+            data.insert(data.end(), ptr, ptr + 16);
+            ptr += 16;
+            break;
+        }
+
+        /* Indexed strings/addresses need .debug_str_offsets/.debug_addr, only skipped to stay in sync */
+        case DW_FORM_strx1:
+        case DW_FORM_addrx1:
+        {
+            ptr += 1;
+            break;
+        }
+
+        case DW_FORM_strx2:
+        case DW_FORM_addrx2:
+        {
+            ptr += 2;
+            break;
+        }
+
+        case DW_FORM_strx3:
+        case DW_FORM_addrx3:
+        {
+            ptr += 3;
+            break;
+        }
+
+        case DW_FORM_strx4:
+        case DW_FORM_addrx4:
+        {
+            ptr += 4;
+            break;
+        }
+
+        case DW_FORM_strx:
+        case DW_FORM_addrx:
+        case DW_FORM_loclistx:
+        case DW_FORM_rnglistx:
+        {
+            FileBin_DWARF_ReadULEB128(ptr);
+            break;
+        }
+
+        /* References out of the CU (other CU, type unit, supplementary file) and supplementary strings
+           cannot be followed, skipped so that the next attributes stay in sync */
+        case DW_FORM_ref_addr:
+        case DW_FORM_strp_sup:
+        case DW_FORM_ref_sup4:
+        case DW_FORM_ref_sig8:
+        case DW_FORM_ref_sup8:
+        {
+            ptr += FileBin_DWARF_FormFixedSize(form);
+            break;
+        }
+
+        case DW_FORM_implicit_const:
+        {
+            /* No bytes in the DIE, the value comes from the abbrev (see ParseDIE) */
+            break;
         }
 
         case DW_FORM_flag:
@@ -712,98 +908,422 @@ std::vector<uint8_t> FileBin_DWARF::ReadAttributeValue(const uint8_t*& ptr, uint
     return data;
 }
 
-TreeElementType* FileBin_DWARF::ParseDIE(const uint8_t*& ptr, const uint8_t* fileBase, uint32_t cuOffset, uint32_t infoLen, FileBin_DWARF_CompileUnitType* cu, TreeElementType* parent)
+/* Same byte layout as ReadAttributeValue, without building the value */
+void FileBin_DWARF::SkipAttributeValue(const uint8_t*& ptr, uint32_t form, uint8_t addrSize, const uint8_t* fileBase)
 {
-    TreeElementType* prev = nullptr;
-    const uint8_t* sectionEnd = fileBase + cuOffset + infoLen;
-    uint32_t CurrentAbbrevOffset2;
-
-    while (ptr < sectionEnd)
+    int32_t formSize = FileBin_DWARF_FormFixedSize(form);
+    if (formSize >= 0)
     {
-        const uint8_t* dieStart = ptr;
-        // Set CurrentAbbrevOffset to the offset of this DIE relative to the CU start
-        CurrentAbbrevOffset2 = static_cast<uint32_t>(dieStart - fileBase);
+        ptr += formSize;
+        return;
+    }
 
-        uint64_t abbrevCode = FileBin_DWARF_ReadULEB128(ptr);
-        if (abbrevCode == 0)
-            break; // end of siblings
+    switch (form)
+    {
+        case DW_FORM_addr:
+        {
+            ptr += addrSize;
+            break;
+        }
 
-        auto it = cu->AbbrevInfo->abbrevTable.find(static_cast<uint32_t>(abbrevCode));
-        if (it == cu->AbbrevInfo->abbrevTable.end())
+        case DW_FORM_string:
         {
-            std::cerr << "[WARNING] Abbrev code " << abbrevCode << " not found\n";
+            while (*ptr) ++ptr;
+            ++ptr;
             break;
         }
 
-        FileBin_DWARF_Abbrev& abbrev = it->second;
+        case DW_FORM_block1:
+        {
+            uint8_t blockLen = *ptr++;
+            ptr += blockLen;
+            break;
+        }
 
-        TreeElementType* node = new TreeElementType();
-        node->cu = cu;
+        case DW_FORM_block2:
+        {
+            uint16_t blockLen = readU16(ptr);
+            ptr += blockLen;
+            break;
+        }
 
-        // Parse attributes
-        for (const FileBin_DWARF_AbbrevAttr& attrForm : abbrev.attributes)
+        case DW_FORM_block4:
         {
-            std::vector<uint8_t> data;
-            //int16_t attrSize = FileBin_DWARF::DW_FORM_GetLength(attrForm.form);
-#if (1 == LIBPARSER_DWARF_DEBUG)
-            std::cout << "  Attr: " << FileBin_DWARF_DW_AT_ToString(attrForm.attribute)
-                      << " Form: " << FileBin_DWARF_DW_FORM_ToString(attrForm.form)
-                      << std::endl;
-#endif
-            data = ReadAttributeValue(ptr, attrForm.form, cu->AddrSize, fileBase);
+            uint32_t blockLen = readU32(ptr);
+            ptr += blockLen;
+            break;
+        }
 
-            switch (abbrev.tag)
-            {
+        case DW_FORM_block:
+        case DW_FORM_exprloc:
+        {
+            uint64_t blockLen = FileBin_DWARF_ReadULEB128(ptr);
+            ptr += blockLen;
+            break;
+        }
 
-            /* Compile Unit information stores at a different class than the rest of attributes */
-            case DW_TAG_compile_unit:
-            {
-                node->elementType = FILEBIN_DWARF_ELEMENT_COMPILE_UNIT;
+        /* Signed and unsigned LEB128 have the same length encoding */
+        case DW_FORM_udata:
+        case DW_FORM_sdata:
+        case DW_FORM_ref_udata:
+        case DW_FORM_strx:
+        case DW_FORM_addrx:
+        case DW_FORM_loclistx:
+        case DW_FORM_rnglistx:
+        {
+            FileBin_DWARF_ReadULEB128(ptr);
+            break;
+        }
 
-                switch (attrForm.attribute)
-                {
-                    case DW_AT_name:
-                    {
-                        node->data = data;
-                        break;
-                    }
-                }
+        default:
+        {
+            /* Reports the unsupported form */
+            ReadAttributeValue(ptr, form, addrSize, fileBase);
+            break;
+        }
+    }
+}
 
-                break;
+/* Steps over a DIE and all its children without creating nodes. A DW_AT_sibling reference jumps over the
+ * children at once, otherwise they are walked with the abbrev layout */
+void FileBin_DWARF::SkipDIE(const uint8_t*& ptr, const FileBin_DWARF_Abbrev& abbrev, const uint8_t* cuStart, const uint8_t* sectionEnd, FileBin_DWARF_CompileUnitType* cu)
+{
+    const uint8_t* sibling = nullptr;
 
-            }
+    if ((abbrev.siblingIdx < 0) && (abbrev.fixedSize >= 0))
+    {
+        ptr += abbrev.fixedSize + abbrev.addrCnt * cu->AddrSize;
+    }
+    else
+    {
+        for (size_t i = 0; i < abbrev.attributes.size(); i++)
+        {
+            uint32_t form = static_cast<uint32_t>(abbrev.attributes[i].form);
 
-            case DW_TAG_enumeration_type:
+            if (static_cast<int32_t>(i) == abbrev.siblingIdx)
             {
-                node->elementType = FILEBIN_DWARF_ELEMENT_ENUMERATION;
+                const uint8_t* refPtr = ptr;
+                uint64_t ref = 0;
 
-                uint32_t typeOffset = CurrentAbbrevOffset2 - cu->Offset - InfoOffset;
-
-                auto it = cu->typeList.find(typeOffset);
-                if (it == cu->typeList.end())
+                switch (form)
                 {
-                    cu->typeList.emplace(typeOffset, node);
+                    case DW_FORM_ref1:      ref = *refPtr;                              break;
+                    case DW_FORM_ref2:      ref = readU16(refPtr);                      break;
+                    case DW_FORM_ref4:      ref = readU32(refPtr);                      break;
+                    case DW_FORM_ref_udata: ref = FileBin_DWARF_ReadULEB128(refPtr);    break;
+                    default:                                                            break;
                 }
 
-                switch (attrForm.attribute)
+                if (ref != 0)
                 {
-                    case DW_AT_name:
-                    {
-                        node->data = data;
-                        break;
-                    }
-
-                    case DW_AT_byte_size:
-                    {
-                        node->Size.push_back(data[0]);
-                        break;
-                    }
+                    sibling = cuStart + ref;
                 }
-                break;
             }
 
-            case DW_TAG_enumerator:
-            {
+            SkipAttributeValue(ptr, form, cu->AddrSize, this->fileBase);
+        }
+    }
+
+    if (!abbrev.hasChildren)
+    {
+        return;
+    }
+
+    if ((sibling > ptr) && (sibling <= sectionEnd))
+    {
+        ptr = sibling;
+        return;
+    }
+
+    while (ptr < sectionEnd)
+    {
+        uint64_t abbrevCode = FileBin_DWARF_ReadULEB128(ptr);
+        if (abbrevCode == 0)
+            break; // end of children
+
+        auto it = cu->AbbrevInfo->abbrevTable.find(static_cast<uint32_t>(abbrevCode));
+        if (it == cu->AbbrevInfo->abbrevTable.end())
+        {
+            std::cerr << "[WARNING] Abbrev code " << abbrevCode << " not found\n";
+            ptr = sectionEnd;
+            break;
+        }
+
+        SkipDIE(ptr, it->second, cuStart, sectionEnd, cu);
+    }
+}
+
+/* Variables inside functions are kept only when they live at a fixed address (DW_OP_addr location), the
+ * location is peeked at without decoding the DIE */
+bool FileBin_DWARF::IsStaticVariableDIE(const uint8_t* ptr, const FileBin_DWARF_Abbrev& abbrev, FileBin_DWARF_CompileUnitType* cu)
+{
+    if (abbrev.locationIdx < 0)
+    {
+        return false;
+    }
+
+    for (int32_t i = 0; i < abbrev.locationIdx; i++)
+    {
+        SkipAttributeValue(ptr, static_cast<uint32_t>(abbrev.attributes[i].form), cu->AddrSize, this->fileBase);
+    }
+
+    uint64_t exprLen = 0;
+    switch (abbrev.attributes[abbrev.locationIdx].form)
+    {
+        case DW_FORM_exprloc:   exprLen = FileBin_DWARF_ReadULEB128(ptr);   break;
+        case DW_FORM_block1:    exprLen = *ptr++;                           break;
+        default:                return false; /* Location lists, the variable moves */
+    }
+
+    return (exprLen > 0) && (*ptr == DW_OP_addr);
+}
+
+/* DW_AT_name of the DIE at a CU relative offset, followed through DW_AT_specification / DW_AT_abstract_origin */
+std::vector<uint8_t> FileBin_DWARF::ReadDIEName(const uint8_t* cuStart, const uint8_t* sectionEnd, uint32_t dieOffset, FileBin_DWARF_CompileUnitType* cu)
+{
+    /* An out-of-line instance of an inline member is two references away from the name, the bound stops cycles */
+    for (uint32_t hop = 0; hop < LIBPARSER_DWARF_NAME_HOPS; hop++)
+    {
+        const uint8_t* ptr = cuStart + dieOffset;
+        if ((0 == dieOffset) || (ptr >= sectionEnd))
+        {
+            break;
+        }
+
+        auto it = cu->AbbrevInfo->abbrevTable.find(static_cast<uint32_t>(FileBin_DWARF_ReadULEB128(ptr)));
+        if (it == cu->AbbrevInfo->abbrevTable.end())
+        {
+            break;
+        }
+
+        const FileBin_DWARF_Abbrev& abbrev = it->second;
+        uint64_t ref = 0;
+
+        for (const FileBin_DWARF_AbbrevAttr& attrForm : abbrev.attributes)
+        {
+            if (attrForm.attribute == DW_AT_name)
+            {
+                return ReadAttributeValue(ptr, attrForm.form, cu->AddrSize, this->fileBase);
+            }
+
+            if ((attrForm.attribute == DW_AT_specification) || (attrForm.attribute == DW_AT_abstract_origin))
+            {
+                const uint8_t* refPtr = ptr;
+
+                switch (attrForm.form)
+                {
+                    case DW_FORM_ref1:      ref = *refPtr;                              break;
+                    case DW_FORM_ref2:      ref = readU16(refPtr);                      break;
+                    case DW_FORM_ref4:      ref = readU32(refPtr);                      break;
+                    case DW_FORM_ref_udata: ref = FileBin_DWARF_ReadULEB128(refPtr);    break;
+                    default:                                                            break;
+                }
+            }
+
+            SkipAttributeValue(ptr, attrForm.form, cu->AddrSize, this->fileBase);
+        }
+
+        dieOffset = static_cast<uint32_t>(ref);
+    }
+
+    return {};
+}
+
+/* Tags of a function body that never lead to a static variable */
+static bool FileBin_DWARF_ScopeSkipTag(uint32_t tag)
+{
+    switch (tag)
+    {
+        case DW_TAG_formal_parameter:
+        case DW_TAG_unspecified_parameters:
+        case DW_TAG_label:
+        case DW_TAG_inlined_subroutine:
+        case DW_TAG_call_site:
+        case DW_TAG_call_site_parameter:
+        case DW_TAG_GNU_call_site:
+        case DW_TAG_GNU_call_site_parameter:
+        case DW_TAG_template_type_parameter:
+        case DW_TAG_template_value_parameter:
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+/* Names declared inside a function are prefixed with it, "fn::var" */
+static std::vector<uint8_t> FileBin_DWARF_ScopeName(const TreeElementType* scope, const std::vector<uint8_t>& name)
+{
+    if ((!scope) || (scope->elementType != FILEBIN_DWARF_ELEMENT_SCOPE) || scope->data.empty())
+    {
+        return name;
+    }
+
+    std::vector<uint8_t> scopedName = scope->data;
+    scopedName.push_back(':');
+    scopedName.push_back(':');
+    scopedName.insert(scopedName.end(), name.begin(), name.end());
+    return scopedName;
+}
+
+TreeElementType* FileBin_DWARF::ParseDIE(const uint8_t*& ptr, const uint8_t* fileBase, uint32_t cuOffset, uint32_t infoLen, FileBin_DWARF_CompileUnitType* cu, TreeElementType* parent)
+{
+    TreeElementType* prev = nullptr;
+    const uint8_t* sectionEnd = fileBase + cuOffset + infoLen;
+    uint32_t CurrentAbbrevOffset2;
+    bool inScope = parent && (parent->elementType == FILEBIN_DWARF_ELEMENT_SCOPE);
+
+    while (ptr < sectionEnd)
+    {
+        /* Progress and cancellation are polled every LIBPARSER_DWARF_PROGRESS_DIE_MASK + 1 DIEs */
+        if (0 == ((++this->ProgressTick) & LIBPARSER_DWARF_PROGRESS_DIE_MASK))
+        {
+            if (this->IsCancelled())
+            {
+                break;
+            }
+
+            this->ProgressInfoBytes.store(static_cast<uint32_t>(ptr - (fileBase + this->InfoOffset)));
+            this->ReportProgress(false);
+        }
+
+        const uint8_t* dieStart = ptr;
+        // Set CurrentAbbrevOffset to the offset of this DIE relative to the CU start
+        CurrentAbbrevOffset2 = static_cast<uint32_t>(dieStart - fileBase);
+
+        uint64_t abbrevCode = FileBin_DWARF_ReadULEB128(ptr);
+        if (abbrevCode == 0)
+            break; // end of siblings
+
+        auto it = cu->AbbrevInfo->abbrevTable.find(static_cast<uint32_t>(abbrevCode));
+        if (it == cu->AbbrevInfo->abbrevTable.end())
+        {
+            std::cerr << "[WARNING] Abbrev code " << abbrevCode << " not found\n";
+            break;
+        }
+
+        FileBin_DWARF_Abbrev& abbrev = it->second;
+
+        /* Function bodies: parameters, locals, call sites and inlined code are stepped over, only nested
+         * scopes, local types and static variables get a node */
+        if (inScope && (FileBin_DWARF_ScopeSkipTag(abbrev.tag) ||
+                        ((abbrev.tag == DW_TAG_variable) && !IsStaticVariableDIE(ptr, abbrev, cu))))
+        {
+            SkipDIE(ptr, abbrev, fileBase + cuOffset, sectionEnd, cu);
+            continue;
+        }
+
+        TreeElementType* node = new TreeElementType();
+        node->cu = cu;
+
+        if ((abbrev.tag == DW_TAG_subprogram) || (abbrev.tag == DW_TAG_lexical_block))
+        {
+            /* Blocks take the name of their function, nested functions append theirs on DW_AT_name */
+            node->elementType = FILEBIN_DWARF_ELEMENT_SCOPE;
+            if (inScope)
+                node->data = parent->data;
+        }
+
+        bool hasName = false;
+        uint32_t nameRef = 0; /* Subprograms, DIE holding the name when the DIE has none */
+
+        // Parse attributes
+        for (const FileBin_DWARF_AbbrevAttr& attrForm : abbrev.attributes)
+        {
+            std::vector<uint8_t> data;
+            //int16_t attrSize = FileBin_DWARF::DW_FORM_GetLength(attrForm.form);
+#if (1 == LIBPARSER_DWARF_DEBUG)
+            std::cout << "  Attr: " << FileBin_DWARF_DW_AT_ToString(attrForm.attribute)
+                      << " Form: " << FileBin_DWARF_DW_FORM_ToString(attrForm.form)
+                      << std::endl;
+#endif
+            data = ReadAttributeValue(ptr, attrForm.form, cu->AddrSize, fileBase);
+
+            if (attrForm.form == DW_FORM_implicit_const)
+            {
+                /* Same byte layout as DW_FORM_udata/sdata */
+                if (attrForm.implicitConst >= 0)
+                {
+                    uint64_t v = static_cast<uint64_t>(attrForm.implicitConst);
+                    do {
+                        data.push_back(static_cast<uint8_t>(v & 0xFF));
+                        v >>= 8;
+                    } while (v);
+                }
+                else
+                {
+                    data.resize(sizeof(attrForm.implicitConst));
+                    std::memcpy(data.data(), &attrForm.implicitConst, sizeof(attrForm.implicitConst));
+                }
+            }
+
+            switch (abbrev.tag)
+            {
+
+            /* Compile Unit information stores at a different class than the rest of attributes */
+            case DW_TAG_compile_unit:
+            {
+                node->elementType = FILEBIN_DWARF_ELEMENT_COMPILE_UNIT;
+
+                switch (attrForm.attribute)
+                {
+                    case DW_AT_name:
+                    {
+                        node->data = data;
+                        break;
+                    }
+
+                    case DW_AT_stmt_list:
+                    {
+                        cu->stmtList = 0;
+                        for (size_t i = 0; (i < data.size()) && (i < 4); ++i)
+                            cu->stmtList |= static_cast<uint32_t>(data[i]) << (i * 8);
+                        cu->hasStmtList = true;
+                        break;
+                    }
+
+                    case DW_AT_comp_dir:
+                    {
+                        cu->compDir.assign(data.begin(), data.end());
+                        break;
+                    }
+                }
+
+                break;
+
+            }
+
+            case DW_TAG_enumeration_type:
+            {
+                node->elementType = FILEBIN_DWARF_ELEMENT_ENUMERATION;
+
+                uint32_t typeOffset = CurrentAbbrevOffset2 - cu->Offset - InfoOffset;
+
+                auto it = cu->typeList.find(typeOffset);
+                if (it == cu->typeList.end())
+                {
+                    cu->typeList.emplace(typeOffset, node);
+                }
+
+                switch (attrForm.attribute)
+                {
+                    case DW_AT_name:
+                    {
+                        node->data = data;
+                        break;
+                    }
+
+                    case DW_AT_byte_size:
+                    {
+                        node->Size.push_back(data[0]);
+                        break;
+                    }
+                }
+                break;
+            }
+
+            case DW_TAG_enumerator:
+            {
                 node->elementType = FILEBIN_DWARF_ELEMENT_ENUMERATION;
 
                 switch (attrForm.attribute)
@@ -963,9 +1483,30 @@ TreeElementType* FileBin_DWARF::ParseDIE(const uint8_t*& ptr, const uint8_t* fil
                 break;
             }
 
+            case DW_TAG_pointer_type:
+            {
+                /* The pointed type is not followed, the symbol is an address sized integer */
+                node->elementType = FILEBIN_DWARF_ELEMENT_POINTER;
+
+                uint32_t typeOffset = CurrentAbbrevOffset2 - cu->Offset - InfoOffset;
+
+                auto it = cu->typeList.find(typeOffset);
+                if (it == cu->typeList.end())
+                {
+                    cu->typeList.emplace(typeOffset, node);
+                }
+
+                if (attrForm.attribute == DW_AT_byte_size)
+                {
+                    node->Size.push_back(data[0]);
+                }
+                break;
+            }
+
             case DW_TAG_structure_type:
+            case DW_TAG_union_type:
             {
-                node->elementType = FILEBIN_DWARF_ELEMENT_STRUCTURE;
+                node->elementType = (abbrev.tag == DW_TAG_union_type) ? FILEBIN_DWARF_ELEMENT_UNION : FILEBIN_DWARF_ELEMENT_STRUCTURE;
 
                 uint32_t typeOffset = CurrentAbbrevOffset2 - cu->Offset - InfoOffset;
 
@@ -1033,6 +1574,50 @@ TreeElementType* FileBin_DWARF::ParseDIE(const uint8_t*& ptr, const uint8_t* fil
                             node->Location += static_cast<uint32_t>(data[i]) << (i * 8);
                         break;
                     }
+
+                    /* Bitfields, DWARF 2/3 give the storage unit size and the offset from its MSB, DWARF 4+
+                     * the offset from the start of the struct */
+                    case DW_AT_byte_size:
+                    {
+                        node->Size.push_back(data[0]);
+                        break;
+                    }
+                    case DW_AT_bit_size:
+                    case DW_AT_bit_offset:
+                    case DW_AT_data_bit_offset:
+                    {
+                        uint32_t value = 0;
+                        for (size_t i = 0; (i < data.size()) && (i < 4); ++i)
+                            value |= static_cast<uint32_t>(data[i]) << (i * 8);
+
+                        if (attrForm.attribute == DW_AT_bit_size)
+                        {
+                            node->BitSize = value;
+                        }
+                        else
+                        {
+                            /* DW_FORM_sdata keeps its sign in the low 32 bits */
+                            node->BitOffset = static_cast<int32_t>(value);
+                            node->isDataBitOffset = (attrForm.attribute == DW_AT_data_bit_offset);
+                        }
+                        break;
+                    }
+                }
+                break;
+            }
+
+            case DW_TAG_subprogram:
+            {
+                if (attrForm.attribute == DW_AT_name)
+                {
+                    node->data = FileBin_DWARF_ScopeName(parent, data);
+                    hasName = true;
+                }
+                else if ((attrForm.attribute == DW_AT_specification) || (attrForm.attribute == DW_AT_abstract_origin))
+                {
+                    nameRef = 0;
+                    for (size_t i = 0; (i < data.size()) && (i < 4); ++i)
+                        nameRef |= static_cast<uint32_t>(data[i]) << (i * 8);
                 }
                 break;
             }
@@ -1045,7 +1630,7 @@ TreeElementType* FileBin_DWARF::ParseDIE(const uint8_t*& ptr, const uint8_t* fil
                 {
                     case DW_AT_name:
                     {
-                        node->data = data;
+                        node->data = FileBin_DWARF_ScopeName(parent, data);
 
                         break;
                     }
@@ -1058,13 +1643,26 @@ TreeElementType* FileBin_DWARF::ParseDIE(const uint8_t*& ptr, const uint8_t* fil
                     }
                     case DW_AT_location:
                     {
-                        node->Addr = 0;
-                        for (size_t i = 1; i < data.size(); ++i)
+                        /* Only a lone DW_OP_addr is a fixed address, anything else is left to the .symtab join */
+                        bool isExpr = (attrForm.form == DW_FORM_exprloc) || (attrForm.form == DW_FORM_block1) ||
+                                      (attrForm.form == DW_FORM_block2) || (attrForm.form == DW_FORM_block4) || (attrForm.form == DW_FORM_block);
+                        if (isExpr && (data.size() == (1u + cu->AddrSize)) && (data[0] == DW_OP_addr))
                         {
-                            node->Addr += static_cast<uint32_t>(data[i]) << ((i - 1) * 8);
+                            node->Addr = 0;
+                            for (size_t i = 1; (i < data.size()) && (i <= 4); ++i)
+                            {
+                                node->Addr += static_cast<uint32_t>(data[i]) << ((i - 1) * 8);
+                            }
+                            node->hasLocation = true;
                         }
                         break;
                     }
+                    case DW_AT_linkage_name:
+                    case DW_AT_MIPS_linkage_name:
+                    {
+                        node->linkageName = data;
+                        break;
+                    }
                     case DW_AT_declaration:
                     {
                         node->isDeclaration = true;
@@ -1073,6 +1671,20 @@ TreeElementType* FileBin_DWARF::ParseDIE(const uint8_t*& ptr, const uint8_t* fil
                         break;
                     }
 
+                    case DW_AT_decl_file:
+                    case DW_AT_decl_line:
+                    {
+                        uint32_t value = 0;
+                        for (size_t i = 0; (i < data.size()) && (i < 4); ++i)
+                            value |= static_cast<uint32_t>(data[i]) << (i * 8);
+
+                        if (attrForm.attribute == DW_AT_decl_file)
+                            node->DeclFile = value;
+                        else
+                            node->DeclLine = value;
+                        break;
+                    }
+
                     case DW_AT_specification:
                     {
                         // If this is a definition, DW_AT_specification points to the declaration
@@ -1092,10 +1704,22 @@ TreeElementType* FileBin_DWARF::ParseDIE(const uint8_t*& ptr, const uint8_t* fil
                             if (node->data.empty())
                                 node->data = declNode->data;
 
+                            if (node->linkageName.empty())
+                                node->linkageName = declNode->linkageName;
+
                             if (node->typeOffset == 0)
                                 node->typeOffset = declNode->typeOffset;
 
-                            node->Addr = declNode->Addr;
+                            if (node->DeclLine == 0)
+                            {
+                                node->DeclFile = declNode->DeclFile;
+                                node->DeclLine = declNode->DeclLine;
+                            }
+
+                            if (!node->hasLocation)
+                                node->Addr = declNode->Addr;
+
+                            declNode->isCompleted = true;
                         }
                         break;
                     }
@@ -1133,6 +1757,17 @@ TreeElementType* FileBin_DWARF::ParseDIE(const uint8_t*& ptr, const uint8_t* fil
             }
         }
 
+        /* Out-of-line member definitions and concrete instances of inline functions only refer to the DIE
+           carrying the name, their static variables are qualified with it */
+        if (!hasName && (nameRef != 0))
+        {
+            std::vector<uint8_t> name = ReadDIEName(fileBase + cuOffset, sectionEnd, nameRef, cu);
+            if (!name.empty())
+            {
+                node->data = FileBin_DWARF_ScopeName(parent, name);
+            }
+        }
+
         // Recurse into children
         if (abbrev.hasChildren)
             node->child = ParseDIE(ptr, fileBase, cuOffset, infoLen, cu, node);
@@ -1153,9 +1788,136 @@ TreeElementType* FileBin_DWARF::ParseDIE(const uint8_t*& ptr, const uint8_t* fil
     return parent ? parent->child : prev;
 }
 
-uint8_t FileBin_DWARF::SymbolResolveType(TreeElementType* node, FileBin_DWARF_VarInfoType* parent)
+/* Children are appended through the tail pointer so that building a list of N siblings stays O(N) */
+static inline void SymbolAppendChild(FileBin_DWARF_VarInfoType* parent, FileBin_DWARF_VarInfoType* node)
 {
-    FileBin_DWARF_VarInfoType* newVar = nullptr;
+    if (!parent->child)
+    {
+        parent->child = node;
+    }
+    else
+    {
+        parent->childLast->next = node;
+    }
+
+    parent->childLast = node;
+}
+
+/* Hands the nodes of a freshly resolved layout over to the CU, nested layouts are already owned */
+static void SymbolMarkShared(FileBin_DWARF_VarInfoType* node, std::vector<FileBin_DWARF_VarInfoType*>& owner)
+{
+    for (; node != nullptr; node = node->next)
+    {
+        if (node->isShared)
+        {
+            continue;
+        }
+
+        node->isShared = true;
+        owner.push_back(node);
+        SymbolMarkShared(node->child, owner);
+    }
+}
+
+/* Points target to a shared layout, same result as resolving the type directly below target */
+static inline uint8_t SymbolAttachLayout(const FileBin_DWARF_TypeLayoutType* layout, FileBin_DWARF_VarInfoType* target)
+{
+    target->DataType = layout->DataType;
+    target->Size = layout->Size;
+    target->child = layout->root;
+    target->childLast = layout->root;
+
+    return layout->symbolSize;
+}
+
+/* Each type is expanded once per CU, later lookups of the same offset reuse the layout */
+FileBin_DWARF_TypeLayoutType* FileBin_DWARF::SymbolTypeLayout(FileBin_DWARF_CompileUnitType* cu, uint32_t typeOffset)
+{
+    /* Variables of one CU are resolved from several threads, nested types re-enter from the same thread */
+    std::lock_guard<std::recursive_mutex> lock(cu->typeLayoutLock);
+
+    auto layoutIt = cu->typeLayout.find(typeOffset);
+    if (layoutIt != cu->typeLayout.end())
+    {
+        return &layoutIt->second;
+    }
+
+    auto it = cu->typeList.find(typeOffset);
+    if (it == cu->typeList.end())
+    {
+        return nullptr;
+    }
+
+    /* Resolve relative to a zero based instance */
+    FileBin_DWARF_VarInfoType holder = FileBin_DWARF_VarInfoType();
+    FileBin_DWARF_TypeLayoutType layout;
+
+    layout.symbolSize = SymbolResolveType(it->second, &holder);
+    layout.root = holder.child;
+    layout.DataType = holder.DataType;
+    layout.Size = holder.Size;
+
+    SymbolMarkShared(layout.root, cu->typeLayoutNodes);
+
+    return &cu->typeLayout.emplace(typeOffset, std::move(layout)).first->second;
+}
+
+static bool SymbolIsSigned(FileBin_DWARF_VarInfoLenType type)
+{
+    return (type == FileBin_VARINFO_TYPE_SINT8) || (type == FileBin_VARINFO_TYPE_SINT16) ||
+           (type == FileBin_VARINFO_TYPE_SINT32) || (type == FileBin_VARINFO_TYPE_SINT64);
+}
+
+/* Bitfield member to a storage unit load: the naturally aligned unit of the member type when the field fits
+ * in it and in the struct, otherwise (packed structs) the smallest byte range holding the field. Returns false
+ * above 8 bytes */
+static bool SymbolBitField(const TreeElementType* member, uint32_t typeBytes, uint32_t structBytes, FileBin_DWARF_VarInfoLenType type, uint32_t& byteOffset, FileBin_DWARF_BitFieldType& bf)
+{
+    int64_t width = member->BitSize;
+    int64_t bit;
+
+    if (member->isDataBitOffset)
+    {
+        bit = member->BitOffset;
+    }
+    else
+    {
+        /* Little endian: DW_AT_bit_offset counts from the MSB of the storage unit */
+        int64_t unitBits = 8ll * (member->Size.empty() ? typeBytes : member->Size.at(0));
+        bit = 8ll * member->Location + unitBits - member->BitOffset - width;
+    }
+
+    if ((bit < 0) || (width <= 0))
+    {
+        return false;
+    }
+
+    int64_t unit = ((typeBytes == 1) || (typeBytes == 2) || (typeBytes == 4) || (typeBytes == 8)) ? typeBytes : 1;
+    int64_t start = (bit / (8 * unit)) * unit;
+    int64_t bytes = unit;
+
+    if (((bit - 8 * start + width) > (8 * unit)) || ((start + unit) > structBytes))
+    {
+        start = bit / 8;
+        bytes = ((bit % 8) + width + 7) / 8;
+    }
+
+    if (bytes > 8)
+    {
+        return false;
+    }
+
+    byteOffset = static_cast<uint32_t>(start);
+    bf.Bytes = static_cast<uint8_t>(bytes);
+    bf.Shift = static_cast<uint8_t>(bit - 8 * start);
+    bf.Width = static_cast<uint8_t>(width);
+    bf.isSigned = SymbolIsSigned(type);
+    return true;
+}
+
+uint8_t FileBin_DWARF::SymbolResolveType(TreeElementType* node, FileBin_DWARF_VarInfoType* parent)
+{
+    FileBin_DWARF_VarInfoType* newVar = nullptr;
     uint8_t symbolSize = 0;
     uint32_t elementSize = 0;
 
@@ -1168,7 +1930,11 @@ uint8_t FileBin_DWARF::SymbolResolveType(TreeElementType* node, FileBin_DWARF_Va
 
         std::string str(newVar->data.begin(), newVar->data.end());
 
-        if (str == "unsigned char" || str == "char")
+        if (str == "_Bool" || str == "bool")
+        {
+            newVar->DataType = FileBin_VARINFO_TYPE_BOOLEAN;
+        }
+        else if (str == "unsigned char" || str == "char")
         {
             newVar->DataType = FileBin_VARINFO_TYPE_UINT8;
         }
@@ -1228,16 +1994,7 @@ uint8_t FileBin_DWARF::SymbolResolveType(TreeElementType* node, FileBin_DWARF_Va
             std::cerr << "Type with no size\n";
         }
 
-        if (!parent->child)
-        {
-            parent->child = newVar;
-        }
-        else
-        {
-            FileBin_DWARF_VarInfoType* last = parent->child;
-            while (last->next) last = last->next;
-            last->next = newVar;
-        }
+        SymbolAppendChild(parent, newVar);
     }
     else if (node->elementType == FILEBIN_DWARF_ELEMENT_CONSTANT)
     {
@@ -1248,16 +2005,7 @@ uint8_t FileBin_DWARF::SymbolResolveType(TreeElementType* node, FileBin_DWARF_Va
         newVar->Addr = parent->Addr;
 
         // Append to parent's child list
-        if (!parent->child)
-        {
-            parent->child = newVar;
-        }
-        else
-        {
-            FileBin_DWARF_VarInfoType* last = parent->child;
-            while (last->next) last = last->next;
-            last->next = newVar;
-        }
+        SymbolAppendChild(parent, newVar);
 
         /* Propagate type */
         //parent->DataType = newVar->DataType;
@@ -1265,12 +2013,11 @@ uint8_t FileBin_DWARF::SymbolResolveType(TreeElementType* node, FileBin_DWARF_Va
         // Lookup type in CU typeList
         if ((node->cu)&&(newVar->TypeOffset != 0))
         {
-            auto it = node->cu->typeList.find(node->typeOffset);
-            if (it != node->cu->typeList.end())
+            FileBin_DWARF_TypeLayoutType* layout = SymbolTypeLayout(node->cu, node->typeOffset);
+            if (layout)
             {
-                TreeElementType* typeNode = it->second;
-                // Recursively traverse the type tree and attach as child
-                symbolSize += SymbolResolveType(typeNode, newVar);
+                // Attach the shared type layout as child
+                symbolSize += SymbolAttachLayout(layout, newVar);
                 // Propagate dimension definition
                 /* Propagate type */
                 parent->DataType = newVar->DataType;
@@ -1287,25 +2034,16 @@ uint8_t FileBin_DWARF::SymbolResolveType(TreeElementType* node, FileBin_DWARF_Va
         newVar->isQualifier = true;
         newVar->Addr = parent->Addr;
         // Append to parent's child list
-        if (!parent->child)
-        {
-            parent->child = newVar;
-        }
-        else
-        {
-            FileBin_DWARF_VarInfoType* last = parent->child;
-            while (last->next) last = last->next;
-            last->next = newVar;
-        }
+        SymbolAppendChild(parent, newVar);
 
         // Lookup type in CU typeList
         if (node->cu && (newVar->TypeOffset != 0))
         {
-            auto it = node->cu->typeList.find(node->typeOffset);
-            if (it != node->cu->typeList.end())
+            FileBin_DWARF_TypeLayoutType* layout = SymbolTypeLayout(node->cu, node->typeOffset);
+            if (layout)
             {
-                // Recursively traverse the type tree and attach as child
-                symbolSize += SymbolResolveType(it->second, newVar);
+                // Attach the shared type layout as child
+                symbolSize += SymbolAttachLayout(layout, newVar);
 
                 /* Propagate type */
                 parent->DataType = newVar->DataType;
@@ -1322,79 +2060,89 @@ uint8_t FileBin_DWARF::SymbolResolveType(TreeElementType* node, FileBin_DWARF_Va
         newVar->Addr = parent->Addr;
 
         // Append to parent's child list
-        if (!parent->child)
-        {
-            parent->child = newVar;
-        }
-        else
-        {
-            FileBin_DWARF_VarInfoType* last = parent->child;
-            while (last->next) last = last->next;
-            last->next = newVar;
-        }
+        SymbolAppendChild(parent, newVar);
 
         // Lookup type in CU typeList
         if ((node->cu)&&(newVar->TypeOffset != 0))
         {
-            auto it = node->cu->typeList.find(node->typeOffset);
-            if (it != node->cu->typeList.end())
+            FileBin_DWARF_TypeLayoutType* layout = SymbolTypeLayout(node->cu, node->typeOffset);
+            if (layout)
             {
-                TreeElementType* typeNode = it->second;
-                symbolSize += SymbolResolveType(typeNode, newVar);
+                symbolSize += SymbolAttachLayout(layout, newVar);
                 /* Propagate type */
                 parent->DataType = newVar->DataType;
                 parent->Size = newVar->Size;
             }
         }
     }
-    else if (node->elementType == FILEBIN_DWARF_ELEMENT_STRUCTURE)
+    else if (node->elementType == FILEBIN_DWARF_ELEMENT_POINTER)
+    {
+        newVar = new FileBin_DWARF_VarInfoType();
+        newVar->data = {'P', 'T', 'R'};
+        newVar->isQualifier = true;
+        newVar->Addr = parent->Addr;
+
+        symbolSize = node->Size.empty() ? static_cast<uint8_t>(node->cu->AddrSize) : static_cast<uint8_t>(node->Size.at(0));
+        newVar->DataType = (symbolSize == 8) ? FileBin_VARINFO_TYPE_UINT64 :
+                           (symbolSize == 2) ? FileBin_VARINFO_TYPE_UINT16 : FileBin_VARINFO_TYPE_UINT32;
+        newVar->Size.push_back(symbolSize);
+
+        /* Propagate type */
+        parent->DataType = newVar->DataType;
+        parent->Size = newVar->Size;
+
+        SymbolAppendChild(parent, newVar);
+    }
+    else if ((node->elementType == FILEBIN_DWARF_ELEMENT_STRUCTURE) || (node->elementType == FILEBIN_DWARF_ELEMENT_UNION))
     {
         uint8_t structTotalSize = 0;
         newVar = new FileBin_DWARF_VarInfoType();
-        newVar->data = {'S', 'T', 'R'};
+        if (node->elementType == FILEBIN_DWARF_ELEMENT_UNION)
+            newVar->data = {'U', 'N', 'I'};
+        else
+            newVar->data = {'S', 'T', 'R'};
         newVar->TypeOffset = node->typeOffset;
         newVar->isQualifier = true;
         newVar->Addr = parent->Addr;
 
         // Append to parent's child list
-        if (!parent->child)
-        {
-            parent->child = newVar;
-        }
+        SymbolAppendChild(parent, newVar);
 
         TreeElementType* nodeMember = node->child;
-        FileBin_DWARF_VarInfoType* newNodeMember = parent->child;
-
-        // Only create child if nodeMember exists
-        if (nodeMember != nullptr)
-        {
-            newNodeMember->child = new FileBin_DWARF_VarInfoType();
-            newNodeMember = newNodeMember->child;
-        }
 
         while (nodeMember != nullptr)
         {
+            FileBin_DWARF_VarInfoType* newNodeMember = new FileBin_DWARF_VarInfoType();
             newNodeMember->data = nodeMember->data;
 
             if ((nodeMember->cu) && (nodeMember->typeOffset != 0))
             {
-                auto it = nodeMember->cu->typeList.find(nodeMember->typeOffset);
-                if (it != nodeMember->cu->typeList.end())
+                FileBin_DWARF_TypeLayoutType* layout = SymbolTypeLayout(nodeMember->cu, nodeMember->typeOffset);
+                if (layout)
                 {
-                    TreeElementType* typeNode = it->second;
                     newNodeMember->Addr = parent->Addr + nodeMember->Location;
-                    elementSize = SymbolResolveType(typeNode, newNodeMember);
+                    elementSize = SymbolAttachLayout(layout, newNodeMember);
                     symbolSize += elementSize;
+
+                    uint32_t byteOffset = 0;
+                    if (nodeMember->BitSize != 0)
+                    {
+                        uint32_t typeBytes = (layout->Size.size() == 1) ? layout->Size.at(0) : elementSize;
+                        uint32_t structBytes = node->Size.empty() ? 0xFFFFFFFFu : node->Size.at(0);
+                        if (SymbolBitField(nodeMember, typeBytes, structBytes, layout->DataType, byteOffset, newNodeMember->BitField))
+                        {
+                            newNodeMember->Addr = parent->Addr + byteOffset;
+                            newNodeMember->Size = {newNodeMember->BitField.Bytes};
+                        }
+                        else
+                        {
+                            std::cerr << "[WARNING] Unsupported bitfield layout\n";
+                        }
+                    }
                 }
             }
 
-
-            // Only create next node if there is actually a next node
-            if (nodeMember->next != nullptr)
-            {
-                newNodeMember->next = new FileBin_DWARF_VarInfoType();
-                newNodeMember = newNodeMember->next;
-            }
+            SymbolAppendChild(newVar, newNodeMember);
 
             nodeMember = nodeMember->next;
         }
@@ -1416,27 +2164,17 @@ uint8_t FileBin_DWARF::SymbolResolveType(TreeElementType* node, FileBin_DWARF_Va
         parent->DataType = FileBin_VARINFO_TYPE_ENUM;
 
         // Append to parent's child list
-        if (!parent->child)
-        {
-            parent->child = newVar;
-        }
+        SymbolAppendChild(parent, newVar);
 
         TreeElementType* nodeMember = node->child;
-        FileBin_DWARF_VarInfoType* newNodeMember =  parent->child;
-
-        newNodeMember->child = new FileBin_DWARF_VarInfoType();
-        newNodeMember = newNodeMember->child;
 
         while (nodeMember != nullptr)
         {
+            FileBin_DWARF_VarInfoType* newNodeMember = new FileBin_DWARF_VarInfoType();
             newNodeMember->data = nodeMember->data;
             newNodeMember->isQualifier = true;
 
-            if (nodeMember->next != nullptr)
-            {
-                newNodeMember->next = new FileBin_DWARF_VarInfoType();
-                newNodeMember = newNodeMember->next;
-            }
+            SymbolAppendChild(newVar, newNodeMember);
 
             nodeMember = nodeMember->next;
         }
@@ -1454,10 +2192,7 @@ uint8_t FileBin_DWARF::SymbolResolveType(TreeElementType* node, FileBin_DWARF_Va
         newVar->isQualifier = true;
 
         // Append to parent's child list
-        if (!parent->child)
-        {
-            parent->child = newVar;
-        }
+        SymbolAppendChild(parent, newVar);
 
         TreeElementType* nodeMember = node->child;
 
@@ -1474,11 +2209,12 @@ uint8_t FileBin_DWARF::SymbolResolveType(TreeElementType* node, FileBin_DWARF_Va
         // Lookup type in CU typeList
         if ((node->cu)&&(newVar->TypeOffset != 0))
         {
-            auto it = node->cu->typeList.find(node->typeOffset);
-            if (it != node->cu->typeList.end())
+            FileBin_DWARF_TypeLayoutType* layout = SymbolTypeLayout(node->cu, node->typeOffset);
+            if (layout)
             {
-                TreeElementType* typeNode = it->second;
-                symbolSize += SymbolResolveType(typeNode, newVar);
+                std::vector<uint32_t> dims = newVar->Size;
+                symbolSize += SymbolAttachLayout(layout, newVar);
+                newVar->Size = dims;
                 newVar->Size.push_back(symbolSize);
                 parent->Size.push_back(symbolSize);
 
@@ -1498,27 +2234,17 @@ uint8_t FileBin_DWARF::SymbolResolveType(TreeElementType* node, FileBin_DWARF_Va
         std::cout << "DIMARRAY" << std::endl;
 
         // Append to parent's child list
-        if (!parent->child)
-        {
-            parent->child = newVar;
-        }
-        else
-        {
-            FileBin_DWARF_VarInfoType* last = parent->child;
-            while (last->next) last = last->next;
-            last->next = newVar;
-        }
+        SymbolAppendChild(parent, newVar);
 
 
         // Lookup type in CU typeList
         if ((node->cu)&&(newVar->TypeOffset != 0))
         {
-            auto it = node->cu->typeList.find(node->typeOffset);
-            if (it != node->cu->typeList.end())
+            FileBin_DWARF_TypeLayoutType* layout = SymbolTypeLayout(node->cu, node->typeOffset);
+            if (layout)
             {
-                TreeElementType* typeNode = it->second;
-                // Recursively traverse the type tree and attach as child
-                symbolSize += SymbolResolveType(typeNode, newVar);
+                // Attach the shared type layout as child
+                symbolSize += SymbolAttachLayout(layout, newVar);
                 newVar->Size.push_back(symbolSize);
             }
         }
@@ -1526,56 +2252,60 @@ uint8_t FileBin_DWARF::SymbolResolveType(TreeElementType* node, FileBin_DWARF_Va
     return symbolSize;
 }
 
-void FileBin_DWARF::SymbolTraverse(TreeElementType* node, FileBin_DWARF_VarInfoType* parent)
+FileBin_DWARF_VarInfoType* FileBin_DWARF::SymbolResolveVariable(TreeElementType* node)
 {
+    FileBin_DWARF_VarInfoType* newVar = nullptr;
 
-    while (node != nullptr)
+    // Only create a FileBin_VarInfoType node for actual variables that are also not just a declaration
+    if ((node->elementType == FILEBIN_DWARF_ELEMENT_VARIABLE) && (!node->isDeclaration))
     {
+        newVar = new FileBin_DWARF_VarInfoType();
+        newVar->data = node->data;
+        newVar->Addr = node->Addr;
+        newVar->TypeOffset = node->typeOffset;
+        newVar->DeclFile = node->DeclFile;
+        newVar->DeclLine = node->DeclLine;
 
-        FileBin_DWARF_VarInfoType* newVar = nullptr;
-
-        // Only create a FileBin_VarInfoType node for actual variables that are also not just a declaration
-        if ((node->elementType == FILEBIN_DWARF_ELEMENT_VARIABLE) && (!node->isDeclaration))
+        // Lookup type in CU typeList
+        if (node->cu)
         {
-
-            //std::cout << "Address: " << std::hex << node->Addr << std::endl;
-
-            newVar = new FileBin_DWARF_VarInfoType();
-            newVar->data = node->data;
-            newVar->Addr = node->Addr;
-            newVar->TypeOffset = node->typeOffset;
-
-            // Append to parent's child list
-            if (!parent->child)
+            if (newVar->TypeOffset != 0)
             {
-                parent->child = newVar;
+                FileBin_DWARF_TypeLayoutType* layout = SymbolTypeLayout(node->cu, node->typeOffset);
+                if (layout)
+                {
+                    // Variables of the same type share one expanded layout
+                    SymbolAttachLayout(layout, newVar);
+                }
             }
             else
             {
-                FileBin_DWARF_VarInfoType* last = parent->child;
-                while (last->next) last = last->next;
-                last->next = newVar;
+                /* Only the .symtab size is known */
+                newVar->Size = node->Size;
+                std::cout << "Unable to resolve type: " << std::hex << node->Addr << std::endl;
             }
+        }
+    }
 
-            // Lookup type in CU typeList
-            if (node->cu)
-            {
-                if (newVar->TypeOffset != 0)
-                {
-                    auto it = node->cu->typeList.find(node->typeOffset);
-                    if (it != node->cu->typeList.end())
-                    {
-                        TreeElementType* typeNode = it->second;
-                        // Recursively traverse the type tree and attach as child
-                        SymbolResolveType(typeNode, newVar);
-                    }
-                }
-                else
-                {
-                    std::cout << "Unable to resolve type: " << std::hex << node->Addr << std::endl;
-                }
-            }
+    return newVar;
+}
+
+void FileBin_DWARF::SymbolTraverse(TreeElementType* node, FileBin_DWARF_VarInfoType* parent)
+{
+    while (node != nullptr)
+    {
+        FileBin_DWARF_VarInfoType* newVar = SymbolResolveVariable(node);
+
+        if (newVar)
+        {
+            // Append to parent's child list
+            SymbolAppendChild(parent, newVar);
+        }
+        else if (node->elementType == FILEBIN_DWARF_ELEMENT_SCOPE)
+        {
+            SymbolTraverse(node->child, parent);
         }
+
         // Move to next sibling
         node = node->next;
     }
@@ -1624,7 +2354,7 @@ void FileBin_DWARF::ParseAllAbbrvSectionHeader(const uint8_t* fileData, uint32_t
             newCU->AbrevOffset = readU32(ptr);
             newCU->AddrSize    = *ptr++;
             newCU->UnitType    = DW_UT_compile;
-            HeaderSize_Byte    = 11;
+            newCU->HeaderSize  = 11;
         }
         else if (newCU->Version == 5)
         {
@@ -1632,7 +2362,7 @@ void FileBin_DWARF::ParseAllAbbrvSectionHeader(const uint8_t* fileData, uint32_t
             newCU->UnitType    = *ptr++;
             newCU->AddrSize    = *ptr++;
             newCU->AbrevOffset = readU32(ptr);
-            HeaderSize_Byte    = 12;
+            newCU->HeaderSize  = 12;
         }
         else
         {
@@ -1667,147 +2397,663 @@ void FileBin_DWARF::FreeTree(TreeElementType* node)
 
 void FileBin_DWARF::FreeSymTree(FileBin_DWARF_VarInfoType* node)
 {
-    if (!node) return;
+    /* Shared layouts are owned by their CU */
+    if ((!node) || (node->isShared)) return;
     FreeSymTree(node->child);
     FreeSymTree(node->next);
     delete node;
 }
 
-uint8_t FileBin_DWARF::Parse(std::string file_name, uint32_t Offset, uint32_t Len, uint32_t InfoOffset, uint32_t InfoLen, uint32_t StrOffset)
+void FileBin_DWARF::FreeCompileUnit(FileBin_DWARF_CompileUnitType* cu)
+{
+    for (auto* node : cu->typeLayoutNodes)
+    {
+        delete node;
+    }
+
+    delete cu;
+}
+
+/* Approximate heap footprint of a DIE tree, used for the CU cache budget */
+static uint64_t TreeBytes(const TreeElementType* node)
+{
+    uint64_t bytes = 0;
+
+    for (; node != nullptr; node = node->next)
+    {
+        bytes += sizeof(TreeElementType) + node->data.capacity() + (node->Size.capacity() * sizeof(uint32_t));
+        bytes += TreeBytes(node->child);
+    }
+
+    return bytes;
+}
+
+/* Approximate heap footprint of the symbols owned by a list, shared layouts are counted with their CU */
+static uint64_t SymTreeBytes(const FileBin_DWARF_VarInfoType* node)
+{
+    uint64_t bytes = 0;
+
+    for (; (node != nullptr) && (!node->isShared); node = node->next)
+    {
+        bytes += sizeof(FileBin_DWARF_VarInfoType) + node->data.capacity() + (node->Size.capacity() * sizeof(uint32_t));
+        bytes += SymTreeBytes(node->child);
+    }
+
+    return bytes;
+}
+
+static void SymbolCollectDIE(TreeElementType* node, std::vector<TreeElementType*>& dieList)
+{
+    for (TreeElementType* die = node; die != nullptr; die = die->next)
+    {
+        if (die->elementType == FILEBIN_DWARF_ELEMENT_SCOPE)
+        {
+            SymbolCollectDIE(die->child, dieList);
+        }
+        else
+        {
+            dieList.push_back(die);
+        }
+    }
+}
+
+void FileBin_DWARF::SymbolResolveCU(uint32_t Idx, bool isParallel)
+{
+    TreeElementType* targetNode = this->CUTreeNode[Idx];
+    FileBin_DWARF_VarInfoType* cuSymbol = this->CUSymbolNode[Idx];
+
+    // Navigation depends on how ParseDIE attaches data:
+    // Usually, the first child is the DW_TAG_compile_unit
+    if (targetNode->child)
+    {
+        cuSymbol->data = targetNode->child->data;
+
+        // Children of the CU (functions, types, globals), static variables of functions are flattened in
+        std::vector<TreeElementType*> dieList;
+        SymbolCollectDIE(targetNode->child->child, dieList);
+
+        std::vector<FileBin_DWARF_VarInfoType*> varList(dieList.size(), nullptr);
+
+        /* Ranges of top level DIEs are work-stolen by the shared pool so that one big CU does not
+           serialize the run. Results are stored by index to keep the DWARF order */
+        auto resolveRange = [&](uint32_t begin, uint32_t end)
+        {
+            uint32_t symbolCnt = 0;
+
+            if (this->IsCancelled())
+            {
+                return;
+            }
+
+            for (uint32_t i = begin; i < end; i++)
+            {
+                varList[i] = SymbolResolveVariable(dieList[i]);
+                symbolCnt += (varList[i] != nullptr);
+            }
+
+            this->ProgressSymbolCnt.fetch_add(symbolCnt);
+            this->ReportProgress(false);
+        };
+
+        if (isParallel)
+        {
+            FileBin_ThreadPool::Shared().ParallelFor(static_cast<uint32_t>(dieList.size()), LIBPARSER_DWARF_SYMBOL_GRAIN, resolveRange);
+        }
+        else
+        {
+            resolveRange(0, static_cast<uint32_t>(dieList.size()));
+        }
+
+        for (auto* var : varList)
+        {
+            if (var)
+            {
+                SymbolAppendChild(cuSymbol, var);
+            }
+        }
+    }
+}
+
+/* File part of a path, .symtab STT_FILE entries usually carry the bare source name */
+static std::string FileBin_DWARF_BaseName(const std::string& path)
+{
+    size_t pos = path.find_last_of("/\\");
+    return (pos == std::string::npos) ? path : path.substr(pos + 1);
+}
+
+/* Variables the .symtab join may patch: definitions without a fixed address and declarations never completed in the CU */
+static bool FileBin_DWARF_SymtabCandidate(const TreeElementType* node)
+{
+    return (!node->hasLocation) && (!node->isCompleted);
+}
+
+/* Looks the variable up by linkage name then by name, local symbols of the CU source first. Returns -1 if absent */
+int32_t FileBin_DWARF::SymtabFind(const TreeElementType* node, const std::string& cuFile, std::string& key) const
+{
+    const std::vector<uint8_t>* names[2] = {&node->linkageName, &node->data};
+
+    for (const std::vector<uint8_t>* name : names)
+    {
+        if (name->empty())
+        {
+            continue;
+        }
+
+        key.assign(cuFile);
+        key.push_back('\0');
+        key.append(name->begin(), name->end());
+        auto it = this->SymtabIndex.find(key);
+
+        if (it == this->SymtabIndex.end())
+        {
+            key.assign(name->begin(), name->end());
+            it = this->SymtabIndex.find(key);
+        }
+
+        if (it != this->SymtabIndex.end())
+        {
+            return static_cast<int32_t>(it->second);
+        }
+    }
+
+    return -1;
+}
+
+/* First pass over a CU: DWARF located variables claim their symbol, the first CU with a candidate owns an unclaimed one */
+void FileBin_DWARF::SymtabScanCU(uint32_t Idx)
+{
+    TreeElementType* cuNode = this->CUTreeNode[Idx]->child;
+    if ((!cuNode) || this->SymtabIndex.empty())
+    {
+        return;
+    }
+
+    std::vector<TreeElementType*> dieList;
+    SymbolCollectDIE(cuNode->child, dieList);
+    std::string cuFile = FileBin_DWARF_BaseName(std::string(cuNode->data.begin(), cuNode->data.end()));
+    std::string key;
+
+    for (TreeElementType* node : dieList)
+    {
+        if (node->elementType != FILEBIN_DWARF_ELEMENT_VARIABLE)
+        {
+            continue;
+        }
+
+        bool located = node->hasLocation && (!node->isDeclaration);
+        if ((!located) && (!FileBin_DWARF_SymtabCandidate(node)))
+        {
+            continue;
+        }
+
+        int32_t sym = SymtabFind(node, cuFile, key);
+        if (sym < 0)
+        {
+            continue;
+        }
+
+        if (located)
+        {
+            this->SymtabOwner[sym] = -2;
+        }
+        else if (this->SymtabOwner[sym] == -1)
+        {
+            this->SymtabOwner[sym] = static_cast<int32_t>(Idx);
+        }
+    }
+}
+
+/* Gives the candidates of a CU the address (and size if untyped) of the symbols it owns, before SymbolResolveCU */
+void FileBin_DWARF::SymtabPatchCU(uint32_t Idx)
+{
+    TreeElementType* cuNode = this->CUTreeNode[Idx]->child;
+    if ((!cuNode) || this->SymtabIndex.empty())
+    {
+        return;
+    }
+
+    std::vector<TreeElementType*> dieList;
+    SymbolCollectDIE(cuNode->child, dieList);
+    std::string cuFile = FileBin_DWARF_BaseName(std::string(cuNode->data.begin(), cuNode->data.end()));
+    std::string key;
+    std::vector<int32_t> patched;
+
+    for (TreeElementType* node : dieList)
+    {
+        if ((node->elementType != FILEBIN_DWARF_ELEMENT_VARIABLE) || (!FileBin_DWARF_SymtabCandidate(node)))
+        {
+            continue;
+        }
+
+        int32_t sym = SymtabFind(node, cuFile, key);
+        if ((sym < 0) || (this->SymtabOwner[sym] != static_cast<int32_t>(Idx)) ||
+            (std::find(patched.begin(), patched.end(), sym) != patched.end()))
+        {
+            continue;
+        }
+
+        const FileBin_ELF_SymbolType& symbol = this->Symtab[sym];
+        node->Addr = symbol.Addr;
+        node->hasLocation = true;
+        node->isDeclaration = false;
+        if (node->typeOffset == 0)
+        {
+            node->Size = {symbol.Size};
+        }
+        patched.push_back(sym);
+    }
+}
+
+void FileBin_DWARF::MeasureCU(uint32_t Idx)
+{
+    FileBin_DWARF_CompileUnitType* cu = this->CompilationUnit[Idx];
+
+    cu->residentBytes = TreeBytes(this->CUTreeNode[Idx]->child) + SymTreeBytes(this->CUSymbolNode[Idx]->child);
+
+    for (auto* node : cu->typeLayoutNodes)
+    {
+        cu->residentBytes += sizeof(FileBin_DWARF_VarInfoType) + node->data.capacity() + (node->Size.capacity() * sizeof(uint32_t));
+    }
+
+    /* Hash map entries, roughly a node plus a bucket each */
+    cu->residentBytes += (cu->typeList.size() + cu->varDeclaration.size()) * 32;
+    cu->residentBytes += cu->typeLayout.size() * (sizeof(FileBin_DWARF_TypeLayoutType) + 32);
+}
+
+/* Rebuilds the DIE and symbol trees of an evicted CU from the mapped .debug_info, touches only the CU itself
+   and data that is read only after Parse so AcquireCU runs it without CacheLock */
+void FileBin_DWARF::BuildCU(uint32_t Idx, bool isParallel)
+{
+    FileBin_DWARF_CompileUnitType* cu = this->CompilationUnit[Idx];
+    const uint8_t* cuStart = this->File.data + this->InfoOffset + cu->Offset + cu->HeaderSize;
+
+    {
+        FileBin_StatsTimer timer("dwarf.die_parse", cu->Length_Bytes);
+        ParseDIE(cuStart, this->File.data, this->InfoOffset + cu->Offset, cu->Length_Bytes, cu, this->CUTreeNode[Idx]);
+    }
+    {
+        FileBin_StatsTimer timer("dwarf.symtab_join");
+        if (this->SymtabScanned)
+            SymtabPatchCU(Idx);
+        else
+            SymtabScanCU(Idx);
+    }
+    {
+        FileBin_StatsTimer timer("dwarf.symbol_resolve");
+        SymbolResolveCU(Idx, isParallel);
+        MeasureCU(Idx);
+    }
+}
+
+/* Puts a built CU under cache control, CacheLock held */
+void FileBin_DWARF::PublishCU(uint32_t Idx)
+{
+    FileBin_DWARF_CompileUnitType* cu = this->CompilationUnit[Idx];
+
+    cu->isResident = true;
+    this->CacheStats.ResidentBytes += cu->residentBytes;
+    this->CacheLRU.push_front(Idx);
+    this->CacheLRUPos[Idx] = this->CacheLRU.begin();
+}
+
+void FileBin_DWARF::LoadCU(uint32_t Idx)
+{
+    BuildCU(Idx, true);
+    PublishCU(Idx);
+}
+
+/* Drops the per-CU trees, the CU and symbol placeholder nodes stay so the top level lists remain valid */
+void FileBin_DWARF::UnloadCU(uint32_t Idx)
 {
-    // Open memory-mapped file
-    MappedFile file;
-    if (!file.open(file_name))
+    FileBin_DWARF_CompileUnitType* cu = this->CompilationUnit[Idx];
+    FileBin_DWARF_VarInfoType* cuSymbol = this->CUSymbolNode[Idx];
+
+    FreeSymTree(cuSymbol->child);
+    cuSymbol->child = nullptr;
+    cuSymbol->childLast = nullptr;
+
+    FreeTree(this->CUTreeNode[Idx]->child);
+    this->CUTreeNode[Idx]->child = nullptr;
+
+    for (auto* node : cu->typeLayoutNodes)
+    {
+        delete node;
+    }
+    std::vector<FileBin_DWARF_VarInfoType*>().swap(cu->typeLayoutNodes);
+    std::unordered_map<uint32_t, FileBin_DWARF_TypeLayoutType>().swap(cu->typeLayout);
+    std::unordered_map<uint32_t, TreeElementType*>().swap(cu->typeList);
+    std::unordered_map<uint32_t, TreeElementType*>().swap(cu->varDeclaration);
+
+    cu->isResident = false;
+    this->CacheStats.ResidentBytes -= cu->residentBytes;
+    cu->residentBytes = 0;
+    this->CacheLRU.erase(this->CacheLRUPos[Idx]);
+}
+
+/* Evicts least recently used, unpinned CUs until the budget is met */
+void FileBin_DWARF::CacheEnforceBudget()
+{
+    if (0 == this->CacheStats.BudgetBytes)
+    {
+        return;
+    }
+
+    auto it = this->CacheLRU.end();
+
+    while ((this->CacheStats.ResidentBytes > this->CacheStats.BudgetBytes) && (it != this->CacheLRU.begin()))
+    {
+        --it;
+        uint32_t idx = *it;
+
+        if (this->CompilationUnit[idx]->pinCnt > 0)
+        {
+            continue;
+        }
+
+        /* UnloadCU erases the entry, continue from its successor */
+        it = std::next(it);
+        UnloadCU(idx);
+        this->CacheStats.Evictions++;
+        FileBin_Stats::Global().CounterAdd("dwarf.cache_evictions", 1);
+    }
+}
+
+void FileBin_DWARF::SetSymbolTable(const std::vector<FileBin_ELF_SymbolType>& Symbols)
+{
+    std::lock_guard<std::mutex> lock(this->CacheLock);
+    this->Symtab = Symbols;
+}
+
+void FileBin_DWARF::SetMemoryBudget(uint64_t Bytes)
+{
+    std::lock_guard<std::mutex> lock(this->CacheLock);
+    this->CacheStats.BudgetBytes = Bytes;
+    CacheEnforceBudget();
+}
+
+FileBin_DWARF_CacheStatsType FileBin_DWARF::GetCacheStats()
+{
+    std::lock_guard<std::mutex> lock(this->CacheLock);
+    return this->CacheStats;
+}
+
+uint32_t FileBin_DWARF::GetCUCount() const
+{
+    return static_cast<uint32_t>(this->CUSymbolNode.size());
+}
+
+const FileBin_LineTable& FileBin_DWARF::GetLineTable() const
+{
+    return this->LineTable;
+}
+
+TreeElementType* FileBin_DWARF::GetCUTree(uint32_t Idx) const
+{
+    return (Idx < this->CUTreeNode.size()) ? this->CUTreeNode[Idx] : nullptr;
+}
+
+FileBin_DWARF_VarInfoType* FileBin_DWARF::AcquireCU(uint32_t Idx)
+{
+    std::unique_lock<std::mutex> lock(this->CacheLock);
+
+    if (Idx >= this->CompilationUnit.size())
+    {
+        return nullptr;
+    }
+
+    FileBin_DWARF_CompileUnitType* cu = this->CompilationUnit[Idx];
+
+    /* Another caller is rebuilding it, the result is shared */
+    this->CacheLoaded.wait(lock, [cu]() { return !cu->isLoading; });
+
+    if (cu->isResident)
+    {
+        this->CacheStats.Hits++;
+        FileBin_Stats::Global().CounterAdd("dwarf.cache_hits", 1);
+        this->CacheLRU.splice(this->CacheLRU.begin(), this->CacheLRU, this->CacheLRUPos[Idx]);
+        cu->pinCnt++;
+    }
+    else
+    {
+        this->CacheStats.Misses++;
+        FileBin_Stats::Global().CounterAdd("dwarf.cache_misses", 1);
+        cu->isLoading = true;
+        cu->pinCnt++;
+
+        /* Callers are often pool tasks (FileBin_SymbolIndex::Build), the CU is built without the lock and
+           without nested ParallelFor: a waiting worker helps with pending tasks and could pick another
+           AcquireCU, which then would block on CacheLock or on this CU */
+        lock.unlock();
+        BuildCU(Idx, false);
+        lock.lock();
+
+        PublishCU(Idx);
+        cu->isLoading = false;
+        this->CacheLoaded.notify_all();
+    }
+
+    CacheEnforceBudget();
+
+    return this->CUSymbolNode[Idx];
+}
+
+void FileBin_DWARF::ReleaseCU(uint32_t Idx)
+{
+    std::lock_guard<std::mutex> lock(this->CacheLock);
+
+    if ((Idx < this->CompilationUnit.size()) && (this->CompilationUnit[Idx]->pinCnt > 0))
+    {
+        this->CompilationUnit[Idx]->pinCnt--;
+        CacheEnforceBudget();
+    }
+}
+
+uint8_t FileBin_DWARF::Parse(std::string file_name, uint32_t Offset, uint32_t Len, uint32_t InfoOffset, uint32_t InfoLen, uint32_t StrOffset,
+                             uint32_t LineOffset, uint32_t LineLen, uint32_t LineStrOffset)
+{
+    std::lock_guard<std::mutex> lock(this->CacheLock);
+
+    /* A request left over from an earlier run (e.g. Cancel after it returned) must not abort this one */
+    this->CancelRequest = false;
+    this->Reset();
+
+    // Open memory-mapped file, kept open so that evicted CUs can be parsed again
+    if (!this->File.open(file_name))
     {
         std::cout << "Failed to open file: " << file_name << "\n";
+        this->CancelRequest = false;
         return 1;
     }
 
     // Store offsets
     this->StrOffset = StrOffset;
+    this->LineStrOffset = LineStrOffset;
     this->InfoOffset = InfoOffset;
-    this->fileBase = file.data;
+    this->fileBase = this->File.data;
 
-    FreeTree(this->DataRoot);
-    this->DataRoot = nullptr;
+    this->ProgressInfoTotal = InfoLen;
+    this->ProgressInfoBytes = 0;
+    this->ProgressCUDone = 0;
+    this->ProgressSymbolCnt = 0;
+    this->ProgressTick = 0;
+    this->ReportProgress(true);
 
-    for (auto* cu : this->CompilationUnit)
+    /* Identify and parse all compilation units headers (does not go deeper into parsing) */
     {
-        delete cu;
+        FileBin_StatsTimer timer("dwarf.cu_headers", InfoLen);
+        this->ParseAllAbbrvSectionHeader(this->File.data, Offset, InfoOffset, InfoLen);
     }
-    this->CompilationUnit.clear();
-
-    this->AbbrevOffsetCache.clear();
-
-    FreeSymTree(this->SymbolRoot);
-    this->SymbolRoot = nullptr;
-
-    /* Identify and parse all compilation units headers (does not go deeper into parsing) */
-    this->ParseAllAbbrvSectionHeader(file.data, Offset, InfoOffset, InfoLen);
     uint32_t cuCnt = static_cast<uint32_t>(CompilationUnit.size());
     if (cuCnt == 0)
     {
         std::cout << "Failefile: " << file_name << "\n";
+        this->CancelRequest = false;
         return 0;
     }
     //this->PrintAllAbbrevInfo();
 
-    std::vector<TreeElementType*> cuTreeNodes(cuCnt); // Direct mapping
-    TreeElementType* currItem = new TreeElementType();
-    this->DataRoot = currItem;
+    /* Permanent per-CU entries of DataRoot and SymbolRoot, their children are loaded/evicted */
+    this->CUTreeNode.resize(cuCnt);
+    this->CUSymbolNode.resize(cuCnt);
+    this->CacheLRUPos.resize(cuCnt);
+
+    FileBin_Stats_PhaseType* abbrevPhase = FileBin_Stats::Global().Phase("dwarf.abbrev_parse");
+    FileBin_Stats_PhaseType* diePhase = FileBin_Stats::Global().Phase("dwarf.die_parse");
+    FileBin_Stats_PhaseType* symbolPhase = FileBin_Stats::Global().Phase("dwarf.symbol_resolve");
 
-    // Build TreeElementType for each compilation unit
     for (uint32_t t = 0; t < cuCnt; t++)
     {
-        cuTreeNodes[t] = currItem; // Map index 't' to the tree node
+        const uint8_t* abbrevPtr = this->File.data + Offset + CompilationUnit[t]->AbrevOffset;
+        {
+            FileBin_StatsTimer timer(abbrevPhase);
+            CompilationUnit[t]->AbbrevInfo = ParseAbbrevOffset(abbrevPtr);
+        }
 
-        const uint8_t* abbrevPtr = file.data + Offset + CompilationUnit[t]->AbrevOffset;
-        CompilationUnit[t]->AbbrevInfo = ParseAbbrevOffset(abbrevPtr);
-        const uint8_t* cuStart = file.data + InfoOffset + CompilationUnit[t]->Offset + HeaderSize_Byte;
-        //const uint8_t* ptr = cuStart;
-        ParseDIE(cuStart, file.data, InfoOffset + CompilationUnit[t]->Offset, CompilationUnit[t]->Length_Bytes, CompilationUnit[t], currItem);
+        this->CUTreeNode[t] = new TreeElementType();
+        this->CUSymbolNode[t] = new FileBin_DWARF_VarInfoType();
+        this->CUSymbolNode[t]->elementType = FILEBIN_DWARF_ELEMENT_COMPILE_UNIT;
 
-        if (t < cuCnt - 1)
+        if (t > 0)
         {
-            currItem->next = new TreeElementType();
-            currItem = currItem->next;
+            this->CUTreeNode[t - 1]->next = this->CUTreeNode[t];
+            this->CUSymbolNode[t - 1]->next = this->CUSymbolNode[t];
         }
     }
 
-    // -----------------------------
-    // Multithreaded SymbolTraverse
-    // -----------------------------
-    std::mutex symbolMutex;
-    FileBin_DWARF_VarInfoType* lastSymbol = nullptr;
-    std::vector<FileBin_DWARF_VarInfoType*> cuSymbols(cuCnt, nullptr);
-    std::vector<std::thread> threads2;
+    this->DataRoot = this->CUTreeNode[0];
+    this->SymbolRoot = this->CUSymbolNode[0];
 
-    // Determine maximum concurrent threads
-    const unsigned int maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    /* Hash side of the .symtab join, probed once per variable DIE */
+    {
+        FileBin_StatsTimer timer("dwarf.symtab_join");
+        this->SymtabIndex.reserve(this->Symtab.size());
+        for (uint32_t i = 0; i < this->Symtab.size(); i++)
+        {
+            const FileBin_ELF_SymbolType& symbol = this->Symtab[i];
+            std::string key = symbol.isLocal ? (FileBin_DWARF_BaseName(symbol.File) + '\0' + symbol.Name) : symbol.Name;
+            this->SymtabIndex.emplace(std::move(key), i); /* Duplicates keep the first entry */
+        }
+        this->SymtabOwner.assign(this->Symtab.size(), -1);
+    }
 
-    std::mutex queueMutex;
-    std::queue<uint32_t> tasks;
-    for (uint32_t t = 0; t < cuCnt; ++t)
-        tasks.push(t);
+    if (0 == this->CacheStats.BudgetBytes)
+    {
+        // Build TreeElementType for each compilation unit
+        for (uint32_t t = 0; (t < cuCnt) && (!this->IsCancelled()); t++)
+        {
+            const uint8_t* cuStart = this->File.data + InfoOffset + CompilationUnit[t]->Offset + CompilationUnit[t]->HeaderSize;
+            FileBin_StatsTimer timer(diePhase, CompilationUnit[t]->Length_Bytes);
+            ParseDIE(cuStart, this->File.data, InfoOffset + CompilationUnit[t]->Offset, CompilationUnit[t]->Length_Bytes, CompilationUnit[t], this->CUTreeNode[t]);
 
-    auto worker = [&]() {
-        while (true) {
-            uint32_t t;
+            this->ProgressInfoBytes.store(CompilationUnit[t]->Offset + CompilationUnit[t]->Length_Bytes + 4);
+            this->ReportProgress(false);
+        }
+
+        if (!this->IsCancelled())
+        {
+            FileBin_StatsTimer timer("dwarf.symtab_join");
+            for (uint32_t t = 0; t < cuCnt; t++)
             {
-                std::lock_guard<std::mutex> lock(queueMutex);
-                if (tasks.empty()) return;
-                t = tasks.front();
-                tasks.pop();
+                SymtabScanCU(t);
             }
+            this->SymtabScanned = true;
+            for (uint32_t t = 0; t < cuCnt; t++)
+            {
+                SymtabPatchCU(t);
+            }
+        }
 
-            // FIX: Direct O(1) access. No more for loop here.
-            TreeElementType* targetNode = cuTreeNodes[t];
-
-            FileBin_DWARF_VarInfoType* cuSymbol = new FileBin_DWARF_VarInfoType();
-
-            // Navigation depends on how ParseDIE attaches data:
-            // Usually, the first child is the DW_TAG_compile_unit
-            if (targetNode->child) {
-                cuSymbol->data = targetNode->child->data;
-                cuSymbol->elementType = FILEBIN_DWARF_ELEMENT_COMPILE_UNIT;
+        // -----------------------------
+        // Multithreaded symbol resolution
+        // -----------------------------
+        FileBin_ThreadPool::Shared().ParallelFor(cuCnt, 1, [&](uint32_t cuBegin, uint32_t cuEnd)
+        {
+            for (uint32_t t = cuBegin; (t < cuEnd) && (!this->IsCancelled()); t++)
+            {
+                FileBin_StatsTimer timer(symbolPhase);
+                SymbolResolveCU(t, true);
+                MeasureCU(t);
 
-                // Recurse into children of the CU (functions, types, globals)
-                if (targetNode->child->child)
-                {
-                    SymbolTraverse(targetNode->child->child, cuSymbol);
-                }
+                this->ProgressCUDone.fetch_add(1);
+                this->ReportProgress(false);
             }
+        });
 
-            cuSymbols[t] = cuSymbol;
+        /* Everything stays resident, the LRU order only matters once a budget is set */
+        for (uint32_t t = 0; t < cuCnt; t++)
+        {
+            CompilationUnit[t]->isResident = true;
+            this->CacheStats.ResidentBytes += CompilationUnit[t]->residentBytes;
+            this->CacheLRU.push_front(t);
+            this->CacheLRUPos[t] = this->CacheLRU.begin();
         }
-    };
+    }
+    else
+    {
+        /* Budgeted: CUs are built one at a time and older ones evicted, peak memory stays near the budget */
+        for (uint32_t t = 0; (t < cuCnt) && (!this->IsCancelled()); t++)
+        {
+            LoadCU(t);
+            CacheEnforceBudget();
 
-    // Launch threads (limited to maxThreads)
-    std::vector<std::thread> threads;
-    for (unsigned int i = 0; i < std::min(maxThreads, cuCnt); ++i)
-        threads.emplace_back(worker);
+            this->ProgressInfoBytes.store(CompilationUnit[t]->Offset + CompilationUnit[t]->Length_Bytes + 4);
+            this->ProgressCUDone.fetch_add(1);
+            this->ReportProgress(false);
+        }
 
-    // Wait for threads to finish
-    for (auto& th : threads)
-        th.join();
+        /* Owners are only known after the last CU, resident owners are dropped and come back patched */
+        this->SymtabScanned = true;
+        for (int32_t owner : this->SymtabOwner)
+        {
+            if ((owner >= 0) && (this->CompilationUnit[owner]->isResident))
+            {
+                UnloadCU(static_cast<uint32_t>(owner));
+            }
+        }
+    }
+
+    if (!this->IsCancelled())
+    {
+        /* CU attributes are known once every CU went through ParseDIE at least once */
+        std::vector<FileBin_LineTable_UnitType> lineUnit(cuCnt);
+        for (uint32_t t = 0; t < cuCnt; t++)
+        {
+            lineUnit[t].HasStmtList = CompilationUnit[t]->hasStmtList;
+            lineUnit[t].StmtList = CompilationUnit[t]->stmtList;
+            lineUnit[t].AddrSize = static_cast<uint8_t>(CompilationUnit[t]->AddrSize);
+            lineUnit[t].CompDir = CompilationUnit[t]->compDir;
+        }
 
-    // Append to global Symbol list sequentially
-    lastSymbol = nullptr;
-    for (uint32_t t = 0; t < cuCnt; ++t) {
-        if (!cuSymbols[t]) continue;
+        this->LineTable.Build(this->File.data, this->File.size, {LineOffset, LineLen, LineStrOffset, StrOffset}, lineUnit);
+    }
 
-        if (!this->SymbolRoot)
-            this->SymbolRoot = cuSymbols[t];
-        else
-            lastSymbol->next = cuSymbols[t];
+    if (this->IsCancelled())
+    {
+        /* Partial results are dropped, the parser is left empty */
+        this->Reset();
+        this->CancelRequest = false;
 
-        lastSymbol = cuSymbols[t];
+        std::cout << "[INFO] Parsing cancelled: " << file_name << "\n";
+        return 2;
     }
 
-    std::cout << "[INFO] Parsed symbols from " << cuCnt
-              << " compilation units using " << threads.size() << " threads\n";
+    FileBin_Stats& stats = FileBin_Stats::Global();
+    stats.CounterAdd("dwarf.cu_count", cuCnt);
+    stats.CounterAdd("dwarf.info_bytes", InfoLen);
+    stats.CounterAdd("dwarf.die_nodes", this->ProgressTick);
+    stats.CounterAdd("dwarf.symbol_nodes", this->ProgressSymbolCnt.load());
+    stats.CounterAdd("dwarf.symtab_patched", std::count_if(this->SymtabOwner.begin(), this->SymtabOwner.end(), [](int32_t owner) { return owner >= 0; }));
+    stats.CounterSet("dwarf.resident_bytes", this->CacheStats.ResidentBytes);
+    /* Listed from the start, AcquireCU and evictions keep adding to them after the load */
+    stats.CounterSet("dwarf.cache_hits", this->CacheStats.Hits);
+    stats.CounterSet("dwarf.cache_misses", this->CacheStats.Misses);
+    stats.CounterSet("dwarf.cache_evictions", this->CacheStats.Evictions);
 
+    std::cout << "[INFO] Parsed symbols from " << cuCnt
+              << " compilation units using " << (FileBin_ThreadPool::Shared().Size() + 1) << " threads\n";
 
+    this->ReportProgress(true);
+    this->CancelRequest = false;
 
     return 0;
 }
@@ -31,89 +31,17 @@
  */
 
 #include "FileBin_ELF.h"
+#include "FileBin_Stats.h"
 #include "FileBin_ELF_Def.h"
+#include "FileBin_MappedFile.h"
 #include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <iomanip>    // for std::setw and std::setfill
 
-#if defined(_WIN32) || defined(_WIN64)
-#include <windows.h>
-#else
-#include <sys/mman.h>
-#include <sys/stat.h>
-#include <fcntl.h>
-#include <unistd.h>
-#endif
 
 using namespace std;
 
-class MappedFile
-{
-public:
-    const uint8_t* data = nullptr;
-    size_t size = 0;
-
-#if defined(_WIN32) || defined(_WIN64)
-private:
-    HANDLE hFile = INVALID_HANDLE_VALUE;
-    HANDLE hMap = NULL;
-#else
-private:
-    int fd = -1;
-#endif
-
-public:
-    bool open(const std::string& fileName)
-    {
-#if defined(_WIN32) || defined(_WIN64)
-        hFile = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ,
-                            NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
-        if (hFile == INVALID_HANDLE_VALUE) return false;
-
-        LARGE_INTEGER fsize;
-        if (!GetFileSizeEx(hFile, &fsize)) return false;
-        size = static_cast<size_t>(fsize.QuadPart);
-
-        hMap = CreateFileMappingA(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
-        if (!hMap) return false;
-
-        data = static_cast<const uint8_t*>(MapViewOfFile(hMap, FILE_MAP_READ, 0, 0, 0));
-        if (!data) return false;
-
-#else
-        fd = ::open(fileName.c_str(), O_RDONLY);
-        if (fd < 0) return false;
-
-        struct stat st;
-        if (fstat(fd, &st) < 0) return false;
-        size = st.st_size;
-
-        data = static_cast<const uint8_t*>(mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0));
-        if (data == MAP_FAILED) return false;
-#endif
-        return true;
-    }
-
-    void close()
-    {
-#if defined(_WIN32) || defined(_WIN64)
-        if (data) UnmapViewOfFile(data);
-        if (hMap) CloseHandle(hMap);
-        if (hFile != INVALID_HANDLE_VALUE) CloseHandle(hFile);
-#else
-        if (data) munmap((void*)data, size);
-        if (fd >= 0) ::close(fd);
-#endif
-        data = nullptr;
-        size = 0;
-    }
-
-    ~MappedFile()
-    {
-        close();
-    }
-};
-
 FileBin_ELF::FileBin_ELF()
 {
 }
@@ -402,7 +330,7 @@ std::vector<SectionMapEntry> FileBin_ELF::buildSectionMap(const std::vector<Elf3
     return map;
 }
 
-const SectionMapEntry* FileBin_ELF::findSectionForVA(uint32_t va) {
+const SectionMapEntry* FileBin_ELF::findSectionForVA(uint32_t va) const {
     size_t left = 0;
     size_t right = this->sectionMap.size();
 
@@ -421,38 +349,29 @@ const SectionMapEntry* FileBin_ELF::findSectionForVA(uint32_t va) {
 
 std::vector<uint8_t> FileBin_ELF::readSymbolFromELF(
                                        uint32_t symbolVA,
-                                       uint32_t symbolSize)
+                                       uint32_t symbolSize) const
 {
-
-    this->file_descriptor = fopen(this->File_Name.c_str(), "rb");
-    if (!this->file_descriptor)
+    if (!this->File.data)
     {
-        std::cout << "[ERROR] Unable to open ELF file: " << this->File_Name << std::endl;
-        //return 1;
+        std::cout << "[ERROR] ELF file not loaded: " << this->File_Name << std::endl;
+        return {};
     }
 
     const SectionMapEntry* sec = findSectionForVA(symbolVA);
     if (!sec) {
-        std::cerr << "[ERROR] Symbol VA 0x" << std::hex << symbolVA << " not in any section\n";
+        std::cerr << "[ERROR] Symbol VA 0x" << std::hex << symbolVA << std::dec << " not in any section\n";
         return {};
     }
 
-    uint32_t fileOffset = sec->fileOffset + (symbolVA - sec->vaStart);
-    std::vector<uint8_t> buffer(symbolSize);
-
-    if (fseek(this->file_descriptor, fileOffset, SEEK_SET) != 0) {
-        std::cerr << "[ERROR] fseek failed\n";
-        return {};
-    }
+    uint64_t fileOffset = static_cast<uint64_t>(sec->fileOffset) + (symbolVA - sec->vaStart);
 
-    if (fread(buffer.data(), 1, symbolSize, this->file_descriptor) != symbolSize) {
-        std::cerr << "[ERROR] fread failed\n";
+    if (fileOffset + symbolSize > this->File.size) {
+        std::cerr << "[ERROR] Symbol VA 0x" << std::hex << symbolVA << std::dec << " beyond end of file\n";
         return {};
     }
 
-    fclose(file_descriptor);
-
-    return buffer;
+    const uint8_t* src = this->File.data + fileOffset;
+    return std::vector<uint8_t>(src, src + symbolSize);
 }
 
 uint8_t FileBin_ELF::Parse(const std::string& file_name)
@@ -463,14 +382,25 @@ uint8_t FileBin_ELF::Parse(const std::string& file_name)
     this->debugInfoInfoFound = false;
     this->debugInfoStrFound = false;
     this->File_Name = file_name;
-
-    // Open memory-mapped file
-    MappedFile file;
+    this->SectionHeader.clear();
+    this->ProgramHeader.clear();
+    this->sectionMap.clear();
+    this->symbol_section_header = nullptr;
+    this->symbol_string_section_header = nullptr;
+    this->ObjectSymbols.clear();
+    this->LineOffset = 0;
+    this->LineLen = 0;
+    this->LineStrOffset = 0;
+
+    // Open memory-mapped file, kept open for readSymbolFromELF
+    FileBin_MappedFile& file = this->File;
     if (!file.open(file_name)) {
         std::cout << "[ERROR] Unable to open ELF file: " << file_name << std::endl;
         return 1;
     }
 
+    FileBin_StatsTimer timer("elf.parse", file.size);
+
     if (file.size < sizeof(Elf32_Ehdr)) {
         std::cout << "[ERROR] File too small for ELF header" << std::endl;
         return 2;
@@ -487,9 +417,18 @@ uint8_t FileBin_ELF::Parse(const std::string& file_name)
         return 3;
     }
 
-    // Read program headers and section headers directly
-    const Elf32_Phdr* program_header = reinterpret_cast<const Elf32_Phdr*>(file.data + elf_header.e_phoff);
-    const Elf32_Shdr* section_header = reinterpret_cast<const Elf32_Shdr*>(file.data + elf_header.e_shoff);
+    // Section headers are copied, e_shoff is not guaranteed to be aligned for Elf32_Shdr
+    this->SectionHeader.resize(elf_header.e_shnum);
+    if (elf_header.e_shnum > 0) {
+        std::memcpy(this->SectionHeader.data(), file.data + elf_header.e_shoff, elf_header.e_shnum * sizeof(Elf32_Shdr));
+    }
+    const Elf32_Shdr* section_header = this->SectionHeader.data();
+
+    // Program headers likewise, only the load addresses are used
+    this->ProgramHeader.resize(elf_header.e_phnum);
+    if (elf_header.e_phnum > 0) {
+        std::memcpy(this->ProgramHeader.data(), file.data + elf_header.e_phoff, elf_header.e_phnum * sizeof(Elf32_Phdr));
+    }
 
     // Identify string section and symbol tables
     for (uint32_t i = 0; i < elf_header.e_shnum; ++i)
@@ -506,7 +445,7 @@ uint8_t FileBin_ELF::Parse(const std::string& file_name)
         }
     }
 
-    sectionMap = buildSectionMap(std::vector<Elf32_Shdr>(section_header, section_header + elf_header.e_shnum));
+    sectionMap = buildSectionMap(this->SectionHeader);
 
     // Load string table
     if (string_section.sh_offset + string_section.sh_size > file.size) {
@@ -539,16 +478,84 @@ uint8_t FileBin_ELF::Parse(const std::string& file_name)
             } else if (name == ".debug_str") {
                 debugInfoStrFound = true;
                 StrOffset = section_header[i].sh_offset;
+            } else if (name == ".debug_line") {
+                LineOffset = section_header[i].sh_offset;
+                LineLen = section_header[i].sh_size;
+            } else if (name == ".debug_line_str") {
+                LineStrOffset = section_header[i].sh_offset;
             }
         }
     }
 
-    // The file remains mapped; file.data points to ELF contents
-    // No need to fclose; the destructor of MappedFile handles unmapping
+    ParseSymbolTable();
+
+    // The file remains mapped until the next Parse or destruction
 
     return 0;
 }
 
+/* Collects defined data objects from .symtab. Local symbols remember the
+ * preceding STT_FILE entry so that statics of equal name in different
+ * translation units stay apart. */
+void FileBin_ELF::ParseSymbolTable(void)
+{
+    if (this->symbol_section_header == nullptr)
+        return;
+
+    const Elf32_Shdr& symtab = *this->symbol_section_header;
+    if ((symtab.sh_link >= this->SectionHeader.size()) ||
+        (symtab.sh_offset + (uint64_t)symtab.sh_size > this->File.size))
+    {
+        std::cout << "[WARNING] Invalid .symtab header, symbols ignored" << std::endl;
+        return;
+    }
+
+    const Elf32_Shdr& strtab = this->SectionHeader[symtab.sh_link];
+    if (strtab.sh_offset + (uint64_t)strtab.sh_size > this->File.size)
+    {
+        std::cout << "[WARNING] Invalid .strtab header, symbols ignored" << std::endl;
+        return;
+    }
+
+    const uint8_t* symData = this->File.data + symtab.sh_offset;
+    const char* strData = reinterpret_cast<const char*>(this->File.data + strtab.sh_offset);
+    uint32_t symCount = symtab.sh_size / sizeof(Elf32_Sym);
+    std::string fileName;
+
+    auto symName = [&](uint32_t offset) -> std::string
+    {
+        if (offset >= strtab.sh_size)
+            return std::string();
+        return std::string(strData + offset, strnlen(strData + offset, strtab.sh_size - offset));
+    };
+
+    for (uint32_t i = 1; i < symCount; i++)
+    {
+        Elf32_Sym sym;
+        std::memcpy(&sym, symData + i * sizeof(Elf32_Sym), sizeof(Elf32_Sym));
+        uint8_t type = ELF32_ST_TYPE(sym.st_info);
+
+        if (type == STT_FILE)
+        {
+            fileName = symName(sym.st_name);
+            continue;
+        }
+
+        if (((type != STT_OBJECT) && (type != STT_COMMON)) || (sym.st_shndx == SHN_UNDEF) || (sym.st_name == 0))
+            continue;
+
+        FileBin_ELF_SymbolType entry;
+        entry.Name = symName(sym.st_name);
+        entry.isLocal = (ELF32_ST_BIND(sym.st_info) == STB_LOCAL);
+        entry.File = entry.isLocal ? fileName : std::string();
+        entry.Addr = sym.st_value;
+        entry.Size = sym.st_size;
+        this->ObjectSymbols.push_back(std::move(entry));
+    }
+
+    FileBin_Stats::Global().CounterSet("elf.object_symbols", this->ObjectSymbols.size());
+}
+
 
 #if(0)
 uint8_t FileBin_ELF::Parse(const std::string& file_name)
@@ -812,3 +819,41 @@ uint32_t FileBin_ELF::GetStrOffset(void) const
 {
     return StrOffset;
 }
+
+uint32_t FileBin_ELF::GetLineOffset(void) const
+{
+    return LineOffset;
+}
+
+uint32_t FileBin_ELF::GetLineLen(void) const
+{
+    return LineLen;
+}
+
+uint32_t FileBin_ELF::GetLineStrOffset(void) const
+{
+    return LineStrOffset;
+}
+
+uint32_t FileBin_ELF::GetLoadAddress(void) const
+{
+    /* The image starts at the lowest physical address that carries file data */
+    bool isFound = false;
+    uint32_t loadAddr = 0;
+
+    for (const Elf32_Phdr& phdr : this->ProgramHeader)
+    {
+        if ((phdr.p_type == PT_LOAD) && (phdr.p_filesz > 0) && (!isFound || (phdr.p_paddr < loadAddr)))
+        {
+            loadAddr = phdr.p_paddr;
+            isFound = true;
+        }
+    }
+
+    return loadAddr;
+}
+
+const std::vector<FileBin_ELF_SymbolType>& FileBin_ELF::GetObjectSymbols(void) const
+{
+    return ObjectSymbols;
+}
@@ -0,0 +1,154 @@
+/**
+ *  \file       FileBin_ELFSet.cpp
+ *  \brief      Concurrent loading of several ELF and DWARF files
+ *
+ *  \version    1.0
+ *  \date       Oct 18, 2026
+ *  \author     Xavier Descarrega - DEVE embedded designs <info@deve.tech>
+ *
+ *  \copyright  MIT License
+ *
+ *              Copyright (c) 2026 Xavier Descarrega
+ *
+ *              Permission is hereby granted, free of charge, to any person obtaining a copy
+ *              of this software and associated documentation files (the "Software"), to deal
+ *              in the Software without restriction, including without limitation the rights
+ *              to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *              copies of the Software, and to permit persons to whom the Software is
+ *              furnished to do so, subject to the following conditions:
+ *
+ *              The above copyright notice and this permission notice shall be included in all
+ *              copies or substantial portions of the Software.
+ *
+ *              THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *              IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *              FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *              AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ *              LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *              OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *              SOFTWARE.
+ *
+ */
+
+#include "FileBin_ELFSet.h"
+#include "FileBin_Stats.h"
+#include "FileBin_ThreadPool.h"
+#include <iostream>
+
+FileBin_ELFSet::~FileBin_ELFSet()
+{
+    this->Clear();
+}
+
+void FileBin_ELFSet::Clear()
+{
+    std::lock_guard<std::mutex> lock(this->EntryLock);
+
+    for (auto& entry : this->Entry)
+    {
+        delete entry.DWARF;
+        delete entry.ELF;
+    }
+    this->Entry.clear();
+}
+
+uint32_t FileBin_ELFSet::Load(const std::vector<std::string>& FileNames, uint64_t MemoryBudgetBytes)
+{
+    FileBin_StatsTimer timer("elfset.load");
+
+    this->Clear();
+    this->CancelRequest = false;
+
+    /* The list is complete before it is published, Cancel only sees it under EntryLock */
+    std::vector<FileBin_ELFSet_EntryType> entries;
+    for (const auto& fileName : FileNames)
+    {
+        FileBin_ELFSet_EntryType entry;
+        entry.FileName = fileName;
+        entry.ELF = new FileBin_ELF();
+        entry.DWARF = new FileBin_DWARF();
+        entry.DWARF->SetMemoryBudget(MemoryBudgetBytes);
+        entry.ELFResult = 0;
+        entry.DWARFResult = 0;
+
+        /* FileBin_DWARF::Parse drops older requests when it starts, its forced first report forwards a
+           set cancel that raced with the start */
+        FileBin_DWARF* dwarf = entry.DWARF;
+        dwarf->SetProgressCallback([this, dwarf](const FileBin_DWARF_ProgressType&)
+        {
+            if (this->CancelRequest.load())
+            {
+                dwarf->Cancel();
+            }
+        });
+
+        entries.push_back(entry);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(this->EntryLock);
+        this->Entry.swap(entries);
+    }
+
+    /* Entry is not resized until the next Load/Clear, tasks index it without the lock */
+    FileBin_ThreadPool::Shared().ParallelFor(static_cast<uint32_t>(this->Entry.size()), 1, [this](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t i = begin; i < end; i++)
+        {
+            FileBin_ELFSet_EntryType& entry = this->Entry[i];
+            FileBin_ELF* elf = entry.ELF;
+
+            if (this->CancelRequest.load())
+            {
+                entry.DWARFResult = 2; /* Same as a cancelled FileBin_DWARF::Parse */
+                continue;
+            }
+
+            entry.ELFResult = elf->Parse(entry.FileName);
+
+            if ((0 == entry.ELFResult) && elf->IsDWARF())
+            {
+                entry.DWARF->SetSymbolTable(elf->GetObjectSymbols());
+                entry.DWARFResult = entry.DWARF->Parse(entry.FileName, elf->GetAbbrevOffset(), elf->GetAbbrevLen(),
+                                                       elf->GetInfoOffset(), elf->GetInfoLen(), elf->GetStrOffset(),
+                                                       elf->GetLineOffset(), elf->GetLineLen(), elf->GetLineStrOffset());
+            }
+        }
+    });
+
+    uint32_t failCnt = 0;
+    for (const auto& entry : this->Entry)
+    {
+        if ((entry.ELFResult != 0) || (entry.DWARFResult != 0))
+        {
+            std::cout << "[ERROR] Unable to load " << entry.FileName << " (ELF " << static_cast<int>(entry.ELFResult)
+                      << ", DWARF " << static_cast<int>(entry.DWARFResult) << ")" << std::endl;
+            failCnt++;
+        }
+    }
+
+    FileBin_Stats::Global().CounterAdd("elfset.files", this->Entry.size());
+
+    return failCnt;
+}
+
+void FileBin_ELFSet::Cancel()
+{
+    this->CancelRequest.store(true);
+
+    std::lock_guard<std::mutex> lock(this->EntryLock);
+    for (auto& entry : this->Entry)
+    {
+        entry.DWARF->Cancel();
+    }
+}
+
+uint32_t FileBin_ELFSet::Size() const
+{
+    return static_cast<uint32_t>(this->Entry.size());
+}
+
+const FileBin_ELFSet_EntryType& FileBin_ELFSet::Get(uint32_t Idx) const
+{
+    return this->Entry.at(Idx);
+}
@@ -0,0 +1,281 @@
+/**
+ *  \file       FileBin_HexCodec.cpp
+ *  \brief      ASCII hex record payload codec
+ *
+ *  \version    1.0
+ *  \date       Oct 18, 2026
+ *  \author     Xavier Descarrega - DEVE embedded designs <info@deve.tech>
+ *
+ *  \copyright  MIT License
+ *
+ *              Copyright (c) 2026 Xavier Descarrega
+ *
+ *              Permission is hereby granted, free of charge, to any person obtaining a copy
+ *              of this software and associated documentation files (the "Software"), to deal
+ *              in the Software without restriction, including without limitation the rights
+ *              to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *              copies of the Software, and to permit persons to whom the Software is
+ *              furnished to do so, subject to the following conditions:
+ *
+ *              The above copyright notice and this permission notice shall be included in all
+ *              copies or substantial portions of the Software.
+ *
+ *              THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *              IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *              FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *              AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ *              LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *              OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *              SOFTWARE.
+ *
+ */
+
+#include "FileBin_HexCodec.h"
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define LIBPARSER_HEXCODEC_SSE2 1
+#include <emmintrin.h>
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#else
+#define LIBPARSER_HEXCODEC_SSE2 0
+#endif
+
+#define LIBPARSER_HEXCODEC_SIMD_MIN 8 /* Bytes, shorter payloads (headers, checksums) stay scalar */
+
+#if defined(__GNUC__)
+#define LIBPARSER_HEXCODEC_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define LIBPARSER_HEXCODEC_TARGET_AVX2
+#endif
+
+/* 0xFF is FILEBIN_HEXCODEC_INVALID */
+const uint8_t FileBin_HexCodec::NibbleTable[256] =
+{
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,};
+
+const char FileBin_HexCodec::DigitTable[513] =
+    "000102030405060708090A0B0C0D0E0F"
+    "101112131415161718191A1B1C1D1E1F"
+    "202122232425262728292A2B2C2D2E2F"
+    "303132333435363738393A3B3C3D3E3F"
+    "404142434445464748494A4B4C4D4E4F"
+    "505152535455565758595A5B5C5D5E5F"
+    "606162636465666768696A6B6C6D6E6F"
+    "707172737475767778797A7B7C7D7E7F"
+    "808182838485868788898A8B8C8D8E8F"
+    "909192939495969798999A9B9C9D9E9F"
+    "A0A1A2A3A4A5A6A7A8A9AAABACADAEAF"
+    "B0B1B2B3B4B5B6B7B8B9BABBBCBDBEBF"
+    "C0C1C2C3C4C5C6C7C8C9CACBCCCDCECF"
+    "D0D1D2D3D4D5D6D7D8D9DADBDCDDDEDF"
+    "E0E1E2E3E4E5E6E7E8E9EAEBECEDEEEF"
+    "F0F1F2F3F4F5F6F7F8F9FAFBFCFDFEFF";
+
+static bool HexCodecDecodeScalar(const uint8_t* Src, uint32_t Count, uint8_t* Dst, uint32_t* Sum)
+{
+    const uint8_t* table = FileBin_HexCodec::NibbleTable;
+    uint32_t sum = 0;
+    uint8_t bad = 0;
+
+    for (uint32_t i = 0; i < Count; i++)
+    {
+        uint8_t hi = table[Src[2 * i]];
+        uint8_t lo = table[Src[(2 * i) + 1]];
+        uint8_t byte = static_cast<uint8_t>((hi << 4) | lo);
+
+        bad |= hi | lo;
+        Dst[i] = byte;
+        sum += byte;
+    }
+
+    *Sum += sum;
+    return (bad & 0xF0u) == 0;
+}
+
+#if LIBPARSER_HEXCODEC_SSE2
+
+/*
+ * 16 digits to 8 bytes. '0'-'9' are checked on the raw characters, letters after setting bit 5
+ * which folds 'A'-'F' onto 'a'-'f' (and nothing else onto that range). The digit pairs are then
+ * 16 bit lanes holding the first digit in the low byte, shifted together and packed.
+ */
+static inline bool HexCodecBlockSSE2(const uint8_t* Src, uint8_t* Dst, __m128i& Sum)
+{
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Src));
+    const __m128i l = _mm_or_si128(v, _mm_set1_epi8(0x20));
+    const __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8('9' + 1)));
+    const __m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(l, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(l, _mm_set1_epi8('f' + 1)));
+
+    if (_mm_movemask_epi8(_mm_or_si128(digit, alpha)) != 0xFFFF)
+    {
+        return false;
+    }
+
+    const __m128i nibble = _mm_or_si128(_mm_and_si128(digit, _mm_sub_epi8(v, _mm_set1_epi8('0'))),
+                                        _mm_andnot_si128(digit, _mm_sub_epi8(l, _mm_set1_epi8('a' - 10))));
+    const __m128i hi = _mm_and_si128(nibble, _mm_set1_epi16(0x00FF));
+    const __m128i lo = _mm_srli_epi16(nibble, 8);
+    const __m128i word = _mm_or_si128(_mm_slli_epi16(hi, 4), lo);
+
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(Dst), _mm_packus_epi16(word, word));
+    Sum = _mm_add_epi64(Sum, _mm_sad_epu8(word, _mm_setzero_si128()));
+
+    return true;
+}
+
+/* Whole 8 byte blocks, Done gets the number of bytes decoded */
+static bool HexCodecDecodeSSE2(const uint8_t* Src, uint32_t Count, uint8_t* Dst, uint32_t* Sum, uint32_t* Done)
+{
+    __m128i sum = _mm_setzero_si128();
+    uint32_t i = 0;
+
+    for (; (i + 8) <= Count; i += 8)
+    {
+        if (!HexCodecBlockSSE2(Src + (2 * i), Dst + i, sum))
+        {
+            return false;
+        }
+    }
+
+    *Sum += static_cast<uint32_t>(_mm_cvtsi128_si32(sum)) + static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(sum, 8)));
+    *Done = i;
+    return true;
+}
+
+/* Same as the SSE2 block on 32 digits, packus works per 128 bit lane so the two halves are gathered afterwards.
+   Whole 16 byte blocks only, the rest is left to the SSE2 kernel once the upper YMM state is cleared */
+LIBPARSER_HEXCODEC_TARGET_AVX2
+static bool HexCodecDecodeAVX2(const uint8_t* Src, uint32_t Count, uint8_t* Dst, uint32_t* Sum, uint32_t* Done)
+{
+    __m256i sum = _mm256_setzero_si256();
+    uint32_t i = 0;
+
+    for (; (i + 16) <= Count; i += 16)
+    {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(Src + (2 * i)));
+        const __m256i l = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+        const __m256i digit = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('0' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), v));
+        const __m256i alpha = _mm256_and_si256(_mm256_cmpgt_epi8(l, _mm256_set1_epi8('a' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('f' + 1), l));
+
+        if (_mm256_movemask_epi8(_mm256_or_si256(digit, alpha)) != -1)
+        {
+            _mm256_zeroupper();
+            return false;
+        }
+
+        const __m256i nibble = _mm256_or_si256(_mm256_and_si256(digit, _mm256_sub_epi8(v, _mm256_set1_epi8('0'))),
+                                               _mm256_andnot_si256(digit, _mm256_sub_epi8(l, _mm256_set1_epi8('a' - 10))));
+        const __m256i hi = _mm256_and_si256(nibble, _mm256_set1_epi16(0x00FF));
+        const __m256i lo = _mm256_srli_epi16(nibble, 8);
+        const __m256i word = _mm256_or_si256(_mm256_slli_epi16(hi, 4), lo);
+        const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(word, word), 0x08);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(Dst + i), _mm256_castsi256_si128(packed));
+        sum = _mm256_add_epi64(sum, _mm256_sad_epu8(word, _mm256_setzero_si256()));
+    }
+
+    const __m128i sum128 = _mm_add_epi64(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+    *Sum += static_cast<uint32_t>(_mm_cvtsi128_si32(sum128)) + static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(sum128, 8)));
+    *Done = i;
+
+    _mm256_zeroupper();
+    return true;
+}
+
+static bool HexCodecHasAVX2(void)
+{
+#if defined(_MSC_VER)
+    int regs[4];
+    __cpuid(regs, 0);
+    if (regs[0] < 7)
+    {
+        return false;
+    }
+
+    /* OSXSAVE and AVX, then the OS must save the YMM state */
+    __cpuid(regs, 1);
+    if ((regs[2] & (3 << 27)) != (3 << 27))
+    {
+        return false;
+    }
+    if ((_xgetbv(0) & 6) != 6)
+    {
+        return false;
+    }
+
+    __cpuidex(regs, 7, 0);
+    return (regs[1] & (1 << 5)) != 0;
+#elif defined(__GNUC__)
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+static bool HexCodecUseAVX2(void)
+{
+    static const bool hasAVX2 = HexCodecHasAVX2();
+    return hasAVX2;
+}
+
+#endif
+
+bool FileBin_HexCodec::Decode(const uint8_t* Src, uint32_t Count, uint8_t* Dst, uint32_t* Sum)
+{
+    uint32_t done = 0;
+
+#if LIBPARSER_HEXCODEC_SSE2
+    if ((Count >= 16) && HexCodecUseAVX2())
+    {
+        if (!HexCodecDecodeAVX2(Src, Count, Dst, Sum, &done))
+        {
+            return false;
+        }
+    }
+
+    if ((Count - done) >= LIBPARSER_HEXCODEC_SIMD_MIN)
+    {
+        uint32_t blockDone = 0;
+        if (!HexCodecDecodeSSE2(Src + (2 * done), Count - done, Dst + done, Sum, &blockDone))
+        {
+            return false;
+        }
+        done += blockDone;
+    }
+#endif
+
+    return HexCodecDecodeScalar(Src + (2 * done), Count - done, Dst + done, Sum);
+}
+
+uint8_t* FileBin_HexCodec::Encode(const uint8_t* Src, uint32_t Count, uint8_t* Dst, uint32_t* Sum)
+{
+    uint32_t sum = 0;
+
+    for (uint32_t i = 0; i < Count; i++)
+    {
+        memcpy(Dst + (2 * i), &DigitTable[2 * Src[i]], 2);
+        sum += Src[i];
+    }
+
+    *Sum += sum;
+    return Dst + (2 * Count);
+}
@@ -34,6 +34,13 @@
 #include "QFile"
 #include <QDataStream>
 #include "Log.h"
+#include "FileBin_Stats.h"
+#include "FileBin_MappedFile.h"
+#include "FileBin_ThreadPool.h"
+#include "FileBin_Trace.h"
+#include <algorithm>
+#include <cstring>
+#include <functional>
 
 
 FileBin_IntelHex_Page::FileBin_IntelHex_Page(void)
@@ -41,6 +48,71 @@ FileBin_IntelHex_Page::FileBin_IntelHex_Page(void)
     this->Length_Bytes = 0;
 }
 
+const uint8_t* FileBin_IntelHex_Page::Data(uint32_t Offset, uint32_t *pAvail) const
+{
+    uint64_t pos = (uint64_t)(this->BaseAddress & (LIBPARSER_BLOCKSTORE_BYTES - 1u)) + Offset;
+    uint32_t inner = static_cast<uint32_t>(pos & (LIBPARSER_BLOCKSTORE_BYTES - 1u));
+
+    *pAvail = LIBPARSER_BLOCKSTORE_BYTES - inner;
+    return this->Block[pos / LIBPARSER_BLOCKSTORE_BYTES]->Byte + inner;
+}
+
+uint8_t* FileBin_IntelHex_Page::MutableData(uint32_t Offset, uint32_t *pAvail)
+{
+    uint64_t pos = (uint64_t)(this->BaseAddress & (LIBPARSER_BLOCKSTORE_BYTES - 1u)) + Offset;
+    uint32_t inner = static_cast<uint32_t>(pos & (LIBPARSER_BLOCKSTORE_BYTES - 1u));
+    FileBin_BlockPtr& block = this->Block[pos / LIBPARSER_BLOCKSTORE_BYTES];
+
+    if (!FileBin_BlockStore::IsWritable(block))
+    {
+        block = FileBin_BlockStore::Clone(*block);
+    }
+
+    *pAvail = LIBPARSER_BLOCKSTORE_BYTES - inner;
+    return block->Byte + inner;
+}
+
+void FileBin_IntelHex_Page::Read(uint32_t Offset, uint32_t Length, uint8_t *pDst) const
+{
+    while (Length > 0)
+    {
+        uint32_t avail;
+        const uint8_t *pSrc = this->Data(Offset, &avail);
+        uint32_t len = std::min(Length, avail);
+
+        memcpy(pDst, pSrc, len);
+        pDst += len;
+        Offset += len;
+        Length -= len;
+    }
+}
+
+void FileBin_IntelHex_Page::Write(uint32_t Offset, uint32_t Length, const uint8_t *pSrc)
+{
+    while (Length > 0)
+    {
+        uint32_t avail;
+        uint8_t *pDst = this->MutableData(Offset, &avail);
+        uint32_t len = std::min(Length, avail);
+
+        memcpy(pDst, pSrc, len);
+        pSrc += len;
+        Offset += len;
+        Length -= len;
+    }
+}
+
+void FileBin_IntelHex_Page::Allocate(void)
+{
+    uint64_t end = (uint64_t)(this->BaseAddress & (LIBPARSER_BLOCKSTORE_BYTES - 1u)) + this->Length_Bytes;
+
+    this->Block.resize((end + LIBPARSER_BLOCKSTORE_BYTES - 1u) / LIBPARSER_BLOCKSTORE_BYTES);
+    for (FileBin_BlockPtr& block : this->Block)
+    {
+        block = FileBin_BlockStore::NewBlock();
+    }
+}
+
 FileBin_IntelHex_Record::FileBin_IntelHex_Record()
 {
     this->ByteCount = 0;
@@ -48,46 +120,57 @@ FileBin_IntelHex_Record::FileBin_IntelHex_Record()
 
 bool FileBin_IntelHex_Record::Parse(uint8_t *pBuffer, uint16_t Length)
 {
-    uint8_t crc;
-    bool bOk = false;
+    uint32_t sum = 0;
 
-    /* Line start character */
-    if (pBuffer[0] == ':')
+    if (!this->ParseHeader(pBuffer, Length, &sum))
     {
-        crc = 0;
-        this->ByteCount = (Lib_IntelHex_AsciiToNum(pBuffer[1]) * 16) + Lib_IntelHex_AsciiToNum(pBuffer[2]);
-        this->Address = (Lib_IntelHex_AsciiToNum(pBuffer[3]) * 4096) + (Lib_IntelHex_AsciiToNum(pBuffer[4]) * 256) + (Lib_IntelHex_AsciiToNum(pBuffer[5]) * 16) + Lib_IntelHex_AsciiToNum(pBuffer[6]);       
-        this->RecordType = (Lib_IntelHex_AsciiToNum(pBuffer[7]) * 16) + Lib_IntelHex_AsciiToNum(pBuffer[8]);
+        return false;
+    }
 
-        //cout << "New register, address: " << std::hex << this->Address << " length: " << std::dec << (int)this->ByteCount << " type: " << std::dec << (int)this->RecordType << endl;
+    this->Data.resize(this->ByteCount);
 
-        for (uint16_t i = 0u; i < this->ByteCount; i++)
-        {
-            Data.push_back((Lib_IntelHex_AsciiToNum(pBuffer[9+2*i]) * 16) + Lib_IntelHex_AsciiToNum(pBuffer[10+2*i]));
-            //cout << " ->" << std::hex << (Lib_IntelHex_AsciiToNum(pBuffer[9+2*i]) * 16) + Lib_IntelHex_AsciiToNum(pBuffer[10+2*i]) << endl;
-        }
+    return this->ParseData(pBuffer, this->Data.data(), sum);
+}
 
-        for (uint32_t i = 0u; i < this->ByteCount + 4u; i++)
-        {
-            crc -= (Lib_IntelHex_AsciiToNum(pBuffer[(i * 2u) + 1u]) * 16u) + Lib_IntelHex_AsciiToNum(pBuffer[(i * 2u) + 2u]);
-        }
+bool FileBin_IntelHex_Record::ParseHeader(const uint8_t *pBuffer, size_t Length, uint32_t *pSum)
+{
+    uint8_t header[4];
 
-        //crc &= 0xFF;
-        /* 2's complement */
-        //crc = 0x100 - crc;
-        //crc &= 0xFF;
+    /* Line start character, then byte count, address and record type */
+    if ((Length < 11u) || (pBuffer[0] != ':') || (!FileBin_HexCodec::Decode(&pBuffer[1], 4u, header, pSum)))
+    {
+        return false;
+    }
 
-        uint8_t crcChk = ((Lib_IntelHex_AsciiToNum(pBuffer[(this->ByteCount * 2) + 9]) * 16u) + Lib_IntelHex_AsciiToNum(pBuffer[(this->ByteCount * 2) + 10])) & 0x00FF;
+    this->ByteCount = header[0];
+    this->Address = static_cast<uint16_t>((header[1] << 8u) | header[2]);
+    this->RecordType = header[3];
 
-        if (crc != crcChk)
-        {
-            cout << "Wrong CRC, should " << (int)crcChk << " is " << (int)crc << endl;
-        }
+    //cout << "New register, address: " << std::hex << this->Address << " length: " << std::dec << (int)this->ByteCount << " type: " << std::dec << (int)this->RecordType << endl;
+
+    return (Length >= (11u + (2u * this->ByteCount)));
+}
+
+bool FileBin_IntelHex_Record::ParseData(const uint8_t *pBuffer, uint8_t *pData, uint32_t Sum)
+{
+    uint8_t crcChk;
+
+    /* Data and checksum are summed while decoding */
+    if ((!FileBin_HexCodec::Decode(&pBuffer[9], this->ByteCount, pData, &Sum)) ||
+        (!FileBin_HexCodec::DecodeByte(&pBuffer[(this->ByteCount * 2u) + 9u], &crcChk)))
+    {
+        return false;
+    }
 
-        bOk = (crc == crcChk);
+    /* 2's complement */
+    uint8_t crc = static_cast<uint8_t>(0u - Sum);
+
+    if (crc != crcChk)
+    {
+        cout << "Wrong CRC, should " << (int)crcChk << " is " << (int)crc << endl;
     }
 
-    return bOk;
+    return (crc == crcChk);
 }
 
 FileBin_IntelHex_Memory::FileBin_IntelHex_Memory()
@@ -96,509 +179,1024 @@ FileBin_IntelHex_Memory::FileBin_IntelHex_Memory()
 
 void FileBin_IntelHex_Memory::Clear(void)
 {
-    for (uint32_t i = 0; i < this->Page.size(); i++)
-    {
-        this->Page.at(i).Byte.clear();
-        this->Page.at(i).Length_Bytes = 0;
-    }
     this->Page.clear();
+    this->PageHit = 0;
+    this->Dirty.clear();
+    this->BasePage.clear();
 }
 
 bool FileBin_IntelHex_Memory::GetMemPageOffset(uint32_t *pPage, uint32_t *pOffset, uint32_t Address)
 {
-    /* Look for page */
-    bool pageFound = false;
-    uint32_t minAddress, maxAddress;
-    uint32_t cnt = 0;
-   // uint8_t fBuf[4];
+    /* Sequential accesses mostly stay in the extent of the previous one */
+    if ((this->PageHit >= this->Page.size()) || (Address < this->Page[this->PageHit].BaseAddress) ||
+        ((Address - this->Page[this->PageHit].BaseAddress) >= this->Page[this->PageHit].Length_Bytes))
+    {
+        auto next = std::upper_bound(this->Page.begin(), this->Page.end(), Address, [](uint32_t a, const FileBin_IntelHex_Page& p)
+        {
+            return a < p.BaseAddress;
+        });
+
+        if ((next == this->Page.begin()) || ((Address - (next - 1)->BaseAddress) >= (next - 1)->Length_Bytes))
+        {
+            cout << "Error address not programmed: 0x" << std::hex << Address << std::dec << endl;
+            return false;
+        }
+
+        this->PageHit = static_cast<uint32_t>((next - 1) - this->Page.begin());
+    }
+
+    *pPage = this->PageHit;
+    *pOffset = Address - this->Page[this->PageHit].BaseAddress;
+
+    return true;
+}
+
+bool FileBin_IntelHex_Memory::IsProgrammed(uint32_t Address, uint32_t Length)
+{
+    auto next = std::upper_bound(this->Page.begin(), this->Page.end(), Address, [](uint32_t a, const FileBin_IntelHex_Page& p)
+    {
+        return a < p.BaseAddress;
+    });
+
+    /* Extents never touch, a programmed range lies within a single one */
+    return (next != this->Page.begin()) && (((uint64_t)Address - (next - 1)->BaseAddress + Length) <= (next - 1)->Length_Bytes);
+}
+
+/* Extent holding [Address, Address + Length), or Page.size() (and an error message) */
+static uint32_t IntelHexSpanPage(FileBin_IntelHex_Memory& Mem, uint32_t Address, uint64_t Length, uint32_t *pOffset)
+{
+    uint32_t page;
+
+    if (!Mem.GetMemPageOffset(&page, pOffset, Address))
+    {
+        return static_cast<uint32_t>(Mem.Page.size());
+    }
+
+    /* Extents never touch, the range must lie within this one */
+    if ((*pOffset + Length) > Mem.Page[page].Length_Bytes)
+    {
+        cout << "Error address range not programmed: 0x" << std::hex << Address << std::dec << " length " << Length << endl;
+        return static_cast<uint32_t>(Mem.Page.size());
+    }
+
+    return page;
+}
+
+bool FileBin_IntelHex_Memory::MemRead(uint32_t Address, uint64_t Length, uint8_t *pDst)
+{
+    uint32_t offset;
+    uint32_t page = IntelHexSpanPage(*this, Address, Length, &offset);
 
-    if (this->Page.size() == 0)
+    if (page == this->Page.size())
     {
         return false;
     }
 
-    minAddress = this->Page.at(0).BaseAddress;
-    maxAddress = this->Page.at(this->Page.size() - 1).BaseAddress + this->Page.at(this->Page.size() - 1).Byte.size();
-    //cout << "uint16 -> Looking for address " << (uint32_t)Address << " len " << "range" << std::hex << minAddress << ":" << maxAddress << endl;//this->Page.size() << endl;
+    this->Page[page].Read(offset, static_cast<uint32_t>(Length), pDst);
+    return true;
+}
 
-    /* Assume memory pages have monotonic increasing ranges */
-    if ((Address < minAddress) || (Address > maxAddress))
+bool FileBin_IntelHex_Memory::MemWrite(uint32_t Address, uint64_t Length, const uint8_t *pSrc)
+{
+    uint32_t offset;
+    uint32_t page = IntelHexSpanPage(*this, Address, Length, &offset);
+
+    if (page == this->Page.size())
     {
-        cout << "Error address out of range: 0x" << std::hex << Address << endl;
         return false;
     }
 
-    /* Move to page with right offset */
-    while ((!pageFound) && ((cnt + 1) < this->Page.size()))
+    this->Update(page, offset, static_cast<uint32_t>(Length), pSrc);
+    return true;
+}
+
+void FileBin_IntelHex_Memory::Update(uint32_t PageIdx, uint32_t Offset, uint32_t Length, const uint8_t *pSrc)
+{
+    FileBin_IntelHex_Page& page = this->Page[PageIdx];
+
+    /* Writing a value that is already there neither clones a block nor dirties a sector */
+    while (Length > 0)
     {
-        //cout << cnt << "page init " << this->Page.at(cnt).BaseAddress << endl;
-        if (this->Page.at(cnt + 1).BaseAddress > Address)
+        uint32_t avail;
+        const uint8_t *pCur = page.Data(Offset, &avail);
+        uint32_t len = std::min(Length, avail);
+        uint32_t i = static_cast<uint32_t>(std::mismatch(pCur, pCur + len, pSrc).first - pCur);
+
+        if (i < len)
         {
-            pageFound = true;
+            /* The block may be cloned, compared from then on against the copy. Each differing run is dirty */
+            uint8_t *pDst = page.MutableData(Offset, &avail);
+
+            while (i < len)
+            {
+                uint32_t j = i + 1u;
+
+                while ((j < len) && (pDst[j] != pSrc[j]))
+                {
+                    j++;
+                }
+                memcpy(pDst + i, pSrc + i, j - i);
+                this->MarkDirty(page.BaseAddress + Offset + i, j - i);
+                i = static_cast<uint32_t>(std::mismatch(pDst + j, pDst + len, pSrc + j).first - pDst);
+            }
         }
-        else
+        pSrc += len;
+        Offset += len;
+        Length -= len;
+    }
+}
+
+void FileBin_IntelHex_Memory::Share(void)
+{
+    FileBin_StatsTimer timer("blockstore.share");
+    vector<FileBin_BlockPtr> block;
+
+    for (FileBin_IntelHex_Page& page : this->Page)
+    {
+        block.insert(block.end(), std::make_move_iterator(page.Block.begin()), std::make_move_iterator(page.Block.end()));
+    }
+
+    FileBin_BlockStore::Shared().Intern(block.data(), block.size());
+
+    size_t next = 0;
+    for (FileBin_IntelHex_Page& page : this->Page)
+    {
+        for (FileBin_BlockPtr& b : page.Block)
         {
-            cnt++;
+            b = std::move(block[next++]);
         }
+    }
+}
 
+void FileBin_IntelHex_Memory::SwapArray(uint8_t *pData, uint32_t Count, uint32_t Size)
+{
+    for (uint32_t i = 0; i < Count; i++, pData += Size)
+    {
+        std::reverse(pData, pData + Size);
     }
+}
 
-    *pPage = cnt;
-    *pOffset = Address - this->Page.at(cnt).BaseAddress;
+#define LIBPARSER_INTELHEX_SAVE_CHUNK (1u << 18) /* Data bytes per parallel format task, made of whole 64 KB windows */
 
-    return true;
+/* Programmed bytes of one extent formatted as a unit, records restart at its start */
+typedef struct
+{
+    const FileBin_IntelHex_Page *pPage;
+    uint32_t Offset; /* In the extent */
+    uint32_t Address;
+    uint32_t Length;
+    bool hasUpper; /* Intel HEX, starts with an extended linear address record */
+    size_t TextOffset;
+} FileBin_IntelHex_WindowType;
+
+/* Record text: start code, fields, data and checksum digits, CR LF */
+static inline size_t IntelHexRecordText(uint32_t ByteCount)
+{
+    return 1u + (2u * (4u + ByteCount + 1u)) + 2u;
+}
 
+/* S-record text without data: type, byte count, address and checksum digits, CR LF */
+static inline size_t SRecRecordText(uint32_t AddressBytes)
+{
+    return 2u + (2u * (1u + AddressBytes + 1u)) + 2u;
 }
 
-uint8_t FileBin_IntelHex_Memory::ReadMem_uint8(uint8_t *buffer, uint32_t Length, uint32_t Address)
+/*
+ * Windows of the extents and their text size with RecordText per record plus the data digits. Intel HEX
+ * windows end at each 64 KB address boundary, which records never cross, S-record windows hold a whole
+ * number of records. Returns the text length of all windows.
+ */
+static size_t IntelHexWindows(const vector<FileBin_IntelHex_Page>& Page, uint32_t RecordBytes, size_t RecordText, bool isHex,
+                              vector<FileBin_IntelHex_WindowType> *pWindow)
 {
-    uint8_t fBuf[64];
-    uint32_t Page, Offset;
+    /* Extended linear address records only where the upper 16 bits change */
+    uint32_t upper = 0xFFFFFFFFu;
+    size_t textLen = 0;
 
-    if (GetMemPageOffset(&Page, &Offset, Address))
+    for (const FileBin_IntelHex_Page& page : Page)
     {
-        if (this->Page.at(Page).Byte.size() < (Offset + 1))
+        for (uint32_t j = 0; j < page.Length_Bytes; )
         {
-            cout << "Error reading memory" << endl;
-            return 0.0f;
-        }
+            FileBin_IntelHex_WindowType w;
+            uint32_t left = page.Length_Bytes - j;
 
-        fBuf[0] = this->Page.at(Page).Byte.at(Offset);
+            w.pPage = &page;
+            w.Offset = j;
+            w.Address = page.BaseAddress + j;
+            if (isHex)
+            {
+                w.Length = std::min<uint32_t>(left, 0x10000u - (w.Address & 0xFFFFu));
+                w.hasUpper = ((w.Address >> 16u) != upper);
+                upper = w.Address >> 16u;
+            }
+            else
+            {
+                w.Length = std::min<uint32_t>(left, RecordBytes * (0x10000u / RecordBytes));
+                w.hasUpper = false;
+            }
+            w.TextOffset = textLen;
 
-        return (fBuf[0]);
+            textLen += (w.hasUpper ? IntelHexRecordText(2) : 0) + (2u * (size_t)w.Length) +
+                       ((size_t)((w.Length + RecordBytes - 1) / RecordBytes) * RecordText);
+            pWindow->push_back(w);
+            j += w.Length;
+        }
     }
 
-    return 0;
+    return textLen;
 }
 
-int8_t FileBin_IntelHex_Memory::ReadMem_sint8(uint8_t *buffer, uint32_t Length, uint32_t Address)
+/* Formats the windows straight to their place in the text, optionally in parallel. Tasks take whole windows */
+static void IntelHexFormatWindows(const vector<FileBin_IntelHex_WindowType>& Window, bool isParallel, const char *TraceName,
+                                  const std::function<void(const FileBin_IntelHex_WindowType&)>& Format)
 {
-    uint8_t fBuf[64];
-    uint32_t Page, Offset;
+    vector<uint32_t> taskFirst;
+    uint64_t taskData = LIBPARSER_INTELHEX_SAVE_CHUNK;
 
-    if (GetMemPageOffset(&Page, &Offset, Address))
+    for (uint32_t i = 0; i < Window.size(); i++)
     {
-        if (this->Page.at(Page).Byte.size() < (Offset + 1))
+        if (taskData >= LIBPARSER_INTELHEX_SAVE_CHUNK)
         {
-            cout << "Error reading memory" << endl;
-            return 0.0f;
+            taskFirst.push_back(i);
+            taskData = 0;
         }
+        taskData += Window[i].Length;
+    }
+    taskFirst.push_back(static_cast<uint32_t>(Window.size()));
 
-        fBuf[0] = this->Page.at(Page).Byte.at(Offset);
+    auto formatTasks = [&](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t t = begin; t < end; t++)
+        {
+            FILEBIN_TRACE_SCOPE_ARG(TraceName, t);
+            for (uint32_t i = taskFirst[t]; i < taskFirst[t + 1]; i++)
+            {
+                Format(Window[i]);
+            }
+        }
+    };
 
-        return (fBuf[0]);
+    if (isParallel)
+    {
+        FileBin_ThreadPool::Shared().ParallelFor(static_cast<uint32_t>(taskFirst.size() - 1), 1, formatTasks);
+    }
+    else
+    {
+        formatTasks(0, static_cast<uint32_t>(taskFirst.size() - 1));
     }
-
-    return 0;
 }
 
-uint16_t FileBin_IntelHex_Memory::ReadMem_uint16(uint8_t *buffer, uint32_t Length, uint32_t Address)
+/* Len bytes of the window from i, gathered in pBounce when they straddle two blocks */
+static inline const uint8_t* IntelHexRecordData(const FileBin_IntelHex_WindowType& Window, uint32_t i, uint32_t Len, uint8_t *pBounce)
 {
+    uint32_t avail;
+    const uint8_t *pData = Window.pPage->Data(Window.Offset + i, &avail);
 
-    uint8_t fBuf[64];
-    uint32_t Page, Offset;
-
-    if (GetMemPageOffset(&Page, &Offset, Address))
+    if (avail >= Len)
     {
+        return pData;
+    }
 
-        if (this->Page.at(Page).Byte.size() < (Offset + 1 + 1))
-        {
-            cout << "Error reading memory" << endl;
-            return 0.0f;
-        }
+    Window.pPage->Read(Window.Offset + i, Len, pBounce);
+    return pBounce;
+}
+
+static uint8_t* IntelHexFormatRecord(uint8_t *pDst, uint8_t RecordType, uint16_t Address, const uint8_t *pData, uint8_t ByteCount)
+{
+    uint8_t field[4] = {ByteCount, static_cast<uint8_t>(Address >> 8u), static_cast<uint8_t>(Address), RecordType};
+    uint32_t sum = 0;
 
-        fBuf[0] = this->Page.at(Page).Byte.at(Offset);
-        fBuf[1] = this->Page.at(Page).Byte.at(Offset+1);
+    *pDst++ = ':';
+    pDst = FileBin_HexCodec::Encode(field, 4u, pDst, &sum);
+    pDst = FileBin_HexCodec::Encode(pData, ByteCount, pDst, &sum);
+    pDst = FileBin_HexCodec::EncodeByte(static_cast<uint8_t>(0u - sum), pDst);
+    *pDst++ = '\r';
+    *pDst++ = '\n';
 
-        return (fBuf[1] << 8u | fBuf[0]);
+    return pDst;
+}
+
+static void IntelHexFormatWindow(const FileBin_IntelHex_WindowType& Window, uint32_t RecordBytes, uint8_t *pDst)
+{
+    if (Window.hasUpper)
+    {
+        uint8_t ulba[2] = {static_cast<uint8_t>(Window.Address >> 24u), static_cast<uint8_t>(Window.Address >> 16u)};
+        pDst = IntelHexFormatRecord(pDst, 0x04, 0, ulba, 2);
     }
 
-    return 0;
+    uint8_t bounce[255];
 
+    for (uint32_t i = 0; i < Window.Length; i += RecordBytes)
+    {
+        uint32_t len = std::min<uint32_t>(RecordBytes, Window.Length - i);
+        pDst = IntelHexFormatRecord(pDst, 0x00, static_cast<uint16_t>(Window.Address + i), IntelHexRecordData(Window, i, len, bounce),
+                                    static_cast<uint8_t>(len));
+    }
 }
 
-int16_t FileBin_IntelHex_Memory::ReadMem_sint16(uint8_t *buffer, uint32_t Length, uint32_t Address)
+bool FileBin_IntelHex_Memory::SaveHex(vector<uint8_t> *pText, uint32_t RecordBytes, bool isParallel)
 {
-    uint8_t fBuf[64];
-    uint32_t Page, Offset;
+    if ((RecordBytes == 0) || (RecordBytes > 255))
+    {
+        cout << "Error record length " << RecordBytes << " not in 1..255" << endl;
+        return false;
+    }
 
-    if (GetMemPageOffset(&Page, &Offset, Address))
+    vector<FileBin_IntelHex_WindowType> window;
+    size_t textLen = IntelHexWindows(this->Page, RecordBytes, IntelHexRecordText(0), true, &window);
+
+    FileBin_StatsTimer timer("hex.save", textLen);
+
+    pText->resize(textLen + IntelHexRecordText(0));
+
+    IntelHexFormatWindows(window, isParallel, "hex.save_chunk", [&](const FileBin_IntelHex_WindowType& w)
     {
+        IntelHexFormatWindow(w, RecordBytes, pText->data() + w.TextOffset);
+    });
 
-        if (this->Page.at(Page).Byte.size() < (Offset + 1 + 1))
-        {
-            cout << "Error reading memory" << endl;
-            return 0.0f;
-        }
+    /* End of file record */
+    IntelHexFormatRecord(pText->data() + textLen, 0x01, 0, nullptr, 0);
 
-        fBuf[0] = this->Page.at(Page).Byte.at(Offset);
-        fBuf[1] = this->Page.at(Page).Byte.at(Offset+1);
+    return true;
+}
 
-        return (fBuf[1] << 8u | fBuf[0]);
+/* Type is the digit after the 'S', the checksum is the ones' complement of the byte count, address and data sum */
+static uint8_t* SRecFormatRecord(uint8_t *pDst, uint8_t Type, uint32_t AddressBytes, uint32_t Address, const uint8_t *pData, uint8_t ByteCount)
+{
+    uint8_t field[5];
+    uint32_t sum = 0;
+
+    field[0] = static_cast<uint8_t>(AddressBytes + ByteCount + 1u);
+    for (uint32_t i = 0; i < AddressBytes; i++)
+    {
+        field[1 + i] = static_cast<uint8_t>(Address >> (8u * (AddressBytes - 1u - i)));
     }
 
-    return 0;
+    *pDst++ = 'S';
+    *pDst++ = Type;
+    pDst = FileBin_HexCodec::Encode(field, 1u + AddressBytes, pDst, &sum);
+    pDst = FileBin_HexCodec::Encode(pData, ByteCount, pDst, &sum);
+    pDst = FileBin_HexCodec::EncodeByte(static_cast<uint8_t>(~sum), pDst);
+    *pDst++ = '\r';
+    *pDst++ = '\n';
+
+    return pDst;
 }
 
-uint32_t FileBin_IntelHex_Memory::ReadMem_uint32(uint32_t Address)
+bool FileBin_IntelHex_Memory::SaveSRec(vector<uint8_t> *pText, uint32_t RecordBytes, bool isParallel)
 {
-    uint8_t fBuf[64];
-    uint32_t Page, Offset;
+    /* Smallest address field covering the image: S1/S9, S2/S8 or S3/S7 records */
+    uint64_t end = this->Page.empty() ? 0 : ((uint64_t)this->Page.back().BaseAddress + this->Page.back().Length_Bytes);
+    uint32_t addressBytes = (end <= 0x10000u) ? 2u : ((end <= 0x1000000u) ? 3u : 4u);
+    uint8_t dataType = static_cast<uint8_t>('1' + (addressBytes - 2u));
+    uint8_t endType = static_cast<uint8_t>('9' - (addressBytes - 2u));
+
+    /* The byte count also covers the address and the checksum */
+    if ((RecordBytes == 0) || (RecordBytes > (254u - addressBytes)))
+    {
+        cout << "Error record length " << RecordBytes << " not in 1.." << (254u - addressBytes) << endl;
+        return false;
+    }
+
+    vector<FileBin_IntelHex_WindowType> window;
+    size_t headerLen = SRecRecordText(2);
+    size_t textLen = headerLen + IntelHexWindows(this->Page, RecordBytes, SRecRecordText(addressBytes), false, &window);
+
+    FileBin_StatsTimer timer("srec.save", textLen);
 
-    if (GetMemPageOffset(&Page, &Offset, Address))
+    pText->resize(textLen + SRecRecordText(addressBytes));
+
+    /* Empty S0 header */
+    SRecFormatRecord(pText->data(), '0', 2, 0, nullptr, 0);
+
+    IntelHexFormatWindows(window, isParallel, "srec.save_chunk", [&](const FileBin_IntelHex_WindowType& w)
     {
+        uint8_t *pDst = pText->data() + headerLen + w.TextOffset;
+        uint8_t bounce[255];
 
-        if (this->Page.at(Page).Byte.size() < (Offset + 3 + 1))
+        for (uint32_t i = 0; i < w.Length; i += RecordBytes)
         {
-            cout << "Error reading memory" << endl;
-            return 0.0f;
+            uint32_t len = std::min<uint32_t>(RecordBytes, w.Length - i);
+            pDst = SRecFormatRecord(pDst, dataType, addressBytes, w.Address + i, IntelHexRecordData(w, i, len, bounce), static_cast<uint8_t>(len));
         }
+    });
 
-        fBuf[0] = this->Page.at(Page).Byte.at(Offset);
-        fBuf[1] = this->Page.at(Page).Byte.at(Offset+1);
-        fBuf[2] = this->Page.at(Page).Byte.at(Offset+2);
-        fBuf[3] = this->Page.at(Page).Byte.at(Offset+3);
-
-        return (fBuf[3] << 24u) | (fBuf[2] << 16u) | (fBuf[1] << 8u | fBuf[0]);
-    }
+    /* Termination record, no start address */
+    SRecFormatRecord(pText->data() + textLen, endType, addressBytes, 0, nullptr, 0);
 
-    return 0;
+    return true;
 }
 
-int32_t FileBin_IntelHex_Memory::ReadMem_sint32(uint8_t *buffer, uint32_t Length, uint32_t Address)
+static bool IntelHexWriteFile(const string& filename, const vector<uint8_t>& Data)
 {
-    uint8_t fBuf[64];
-    uint32_t Page, Offset;
+    QFile file(filename.c_str());
 
-    if (GetMemPageOffset(&Page, &Offset, Address))
+    if (!file.open(QIODevice::WriteOnly | QFile::Truncate))
     {
+        return false;
+    }
 
-        if (this->Page.at(Page).Byte.size() < (Offset + 3 + 1))
-        {
-            cout << "Error reading memory" << endl;
-            return 0.0f;
-        }
+    bool isOk = (file.write((const char *)Data.data(), Data.size()) == (qint64)Data.size());
 
-        fBuf[0] = this->Page.at(Page).Byte.at(Offset);
-        fBuf[1] = this->Page.at(Page).Byte.at(Offset+1);
-        fBuf[2] = this->Page.at(Page).Byte.at(Offset+2);
-        fBuf[3] = this->Page.at(Page).Byte.at(Offset+3);
+    file.close();
+    return isOk;
+}
 
-        return (fBuf[3] << 24u) | (fBuf[2] << 16u) | (fBuf[1] << 8u | fBuf[0]);
+/* Bytes (up to 8) of Value, least significant first */
+static uint8_t* IntelHexPutLE(uint8_t *pDst, uint64_t Value, uint32_t Bytes)
+{
+    for (uint32_t i = 0; i < Bytes; i++)
+    {
+        *pDst++ = static_cast<uint8_t>(Value >> (8u * i));
     }
 
-    return 0;
+    return pDst;
 }
 
-float FileBin_IntelHex_Memory::ReadMem_float32(uint8_t *buffer, uint32_t Length, uint32_t Address)
+bool FileBin_IntelHex_Memory::Save(string filename, uint32_t RecordBytes, bool isParallel)
 {
-    uint32_t Page, Offset;
+    vector<uint8_t> text;
+    bool isSRec = (TypeFromExtension(filename.c_str()) == LIB_FIRMWAREBIN_SREC);
 
-    if (GetMemPageOffset(&Page, &Offset, Address))
+    if (!(isSRec ? this->SaveSRec(&text, RecordBytes, isParallel) : this->SaveHex(&text, RecordBytes, isParallel)))
     {
+        return false;
+    }
 
-        if (this->Page.at(Page).Byte.size() < (Offset + 3 + 1))
-        {
-            cout << "Error reading memory" << endl;
-            return 0.0f;
-        }
+    return IntelHexWriteFile(filename, text);
+}
 
-        uint8_t fBuf[4];
+bool FileBin_IntelHex_Memory::SetDirtySector(uint32_t Bytes)
+{
+    if ((Bytes == 0) || ((Bytes & (Bytes - 1u)) != 0))
+    {
+        cout << "Error sector size " << Bytes << " is not a power of two" << endl;
+        return false;
+    }
 
-        fBuf[0] = this->Page.at(Page).Byte.at(Offset);
-        fBuf[1] = this->Page.at(Page).Byte.at(Offset+1);
-        fBuf[2] = this->Page.at(Page).Byte.at(Offset+2);
-        fBuf[3] = this->Page.at(Page).Byte.at(Offset+3);
+    map<uint32_t, uint64_t> dirty;
 
-        float val = *(float *)&fBuf;
-        return val;
+    dirty.swap(this->Dirty);
+    this->DirtySector = Bytes;
+    for (const auto& range : dirty)
+    {
+        this->MarkDirty(range.first, range.second - range.first);
     }
 
-    return 0.0f;
+    return true;
 }
 
-void FileBin_IntelHex_Memory::WriteMem_boolean(uint32_t Address, uint8_t value)
+void FileBin_IntelHex_Memory::MarkDirty(uint32_t Address, uint64_t Length)
 {
-    uint32_t Page, Offset;
-
-    if (GetMemPageOffset(&Page, &Offset, Address))
+    if (Length == 0)
     {
+        return;
+    }
 
-        if (this->Page.at(Page).Byte.size() < (Offset + 1))
-        {
-            cout << "Error writing memory" << endl;
-            return;
-        }
+    uint64_t mask = (uint64_t)this->DirtySector - 1u;
+    uint64_t start = Address & ~mask;
+    uint64_t end = std::min<uint64_t>(((uint64_t)Address + Length + mask) & ~mask, 0x100000000ull);
 
-        this->Page.at(Page).Byte.at(Offset) = value & 0xFF;
+    /* Joined with the ranges it overlaps or touches */
+    auto it = this->Dirty.upper_bound(static_cast<uint32_t>(start));
+
+    if ((it != this->Dirty.begin()) && (std::prev(it)->second >= start))
+    {
+        --it;
+        start = it->first;
+    }
+    while ((it != this->Dirty.end()) && (it->first <= end))
+    {
+        end = std::max(end, it->second);
+        it = this->Dirty.erase(it);
     }
 
+    this->Dirty.emplace(static_cast<uint32_t>(start), end);
 }
 
-void FileBin_IntelHex_Memory::WriteMem_uint8(uint32_t Address, uint8_t value)
+void FileBin_IntelHex_Memory::ClearDirty(void)
 {
-    uint32_t Page, Offset;
+    this->Dirty.clear();
+    this->BasePage = this->Page;
+}
 
-    if (GetMemPageOffset(&Page, &Offset, Address))
+uint64_t FileBin_IntelHex_Memory::BaseHash(void) const
+{
+    uint64_t hash = 0xCBF29CE484222325ull;
+    auto add = [&hash](const uint8_t *pData, uint32_t Length)
     {
-
-        if (this->Page.at(Page).Byte.size() < (Offset + 1))
+        for (uint32_t i = 0; i < Length; i++)
         {
-            cout << "Error writing memory" << endl;
-            return;
+            hash = (hash ^ pData[i]) * 0x100000001B3ull;
         }
+    };
+
+    for (const FileBin_IntelHex_Page& page : this->BasePage)
+    {
+        uint8_t field[8];
 
-        this->Page.at(Page).Byte.at(Offset) = value & 0xFF;
+        IntelHexPutLE(field, page.BaseAddress, 4);
+        IntelHexPutLE(field + 4, page.Length_Bytes, 4);
+        add(field, sizeof(field));
+
+        for (uint32_t i = 0; i < page.Length_Bytes; )
+        {
+            uint32_t avail;
+            const uint8_t *pData = page.Data(i, &avail);
+            uint32_t len = std::min(page.Length_Bytes - i, avail);
+
+            add(pData, len);
+            i += len;
+        }
     }
 
+    return hash;
 }
 
-void FileBin_IntelHex_Memory::WriteMem_sint8(uint32_t Address, int8_t value)
+void FileBin_IntelHex_Memory::DirtyImage(FileBin_IntelHex_Memory *pDelta) const
 {
-    uint32_t Page, Offset;
+    pDelta->Clear();
 
-    if (GetMemPageOffset(&Page, &Offset, Address))
+    for (const auto& range : this->Dirty)
     {
+        auto next = std::upper_bound(this->Page.begin(), this->Page.end(), range.first, [](uint32_t a, const FileBin_IntelHex_Page& p)
+        {
+            return a < p.BaseAddress;
+        });
 
-        if (this->Page.at(Page).Byte.size() < (Offset + 1))
+        /* The extent below the range start may reach into it, the following ones start inside it */
+        for (auto it = (next == this->Page.begin()) ? next : (next - 1); (it != this->Page.end()) && (it->BaseAddress < range.second); ++it)
         {
-            cout << "Error writing memory" << endl;
-            return;
-        }
+            uint64_t lo = std::max<uint64_t>(range.first, it->BaseAddress);
+            uint64_t hi = std::min<uint64_t>(range.second, (uint64_t)it->BaseAddress + it->Length_Bytes);
 
-        this->Page.at(Page).Byte.at(Offset) = value & 0xFF;
-    }
+            if (lo >= hi)
+            {
+                continue;
+            }
 
+            /* Blocks sit at the same addresses in both images */
+            FileBin_IntelHex_Page sub;
+            uint32_t first = static_cast<uint32_t>(lo / LIBPARSER_BLOCKSTORE_BYTES) - (it->BaseAddress / LIBPARSER_BLOCKSTORE_BYTES);
+            uint32_t count = static_cast<uint32_t>(((lo % LIBPARSER_BLOCKSTORE_BYTES) + (hi - lo) + LIBPARSER_BLOCKSTORE_BYTES - 1u) / LIBPARSER_BLOCKSTORE_BYTES);
+
+            sub.BaseAddress = static_cast<uint32_t>(lo);
+            sub.Length_Bytes = static_cast<uint32_t>(hi - lo);
+            sub.Block.assign(it->Block.begin() + first, it->Block.begin() + first + count);
+            pDelta->Page.push_back(std::move(sub));
+        }
+    }
 }
 
-void FileBin_IntelHex_Memory::WriteMem_uint16(uint32_t Address, uint16_t value)
+bool FileBin_IntelHex_Memory::SavePatch(vector<uint8_t> *pData)
 {
+    FileBin_IntelHex_Memory delta;
+    size_t len = 16u;
 
-    uint32_t Page, Offset;
-
-    if (GetMemPageOffset(&Page, &Offset, Address))
+    this->DirtyImage(&delta);
+    for (const FileBin_IntelHex_Page& page : delta.Page)
     {
+        len += 8u + page.Length_Bytes;
+    }
 
-        if (this->Page.at(Page).Byte.size() < (Offset + 2))
-        {
-            cout << "Error writing memory" << endl;
-            return;
-        }
+    FileBin_StatsTimer timer("hex.patch", len);
+
+    pData->resize(len);
 
-        this->Page.at(Page).Byte.at(Offset) = value & 0xFF;
-        this->Page.at(Page).Byte.at(Offset+1) =(value >> 8u) & 0xFF;;
+    uint8_t *pDst = pData->data();
+    memcpy(pDst, "FBP1", 4);
+    pDst = IntelHexPutLE(pDst + 4, this->BaseHash(), 8);
+    pDst = IntelHexPutLE(pDst, delta.Page.size(), 4);
+
+    for (const FileBin_IntelHex_Page& page : delta.Page)
+    {
+        pDst = IntelHexPutLE(pDst, page.BaseAddress, 4);
+        pDst = IntelHexPutLE(pDst, page.Length_Bytes, 4);
+        page.Read(0, page.Length_Bytes, pDst);
+        pDst += page.Length_Bytes;
     }
 
+    return true;
 }
 
-void FileBin_IntelHex_Memory::WriteMem_sint16(uint32_t Address, int16_t value)
+bool FileBin_IntelHex_Memory::SaveDelta(string filename, uint32_t RecordBytes, bool isParallel)
 {
-    uint32_t Page, Offset;
+    vector<uint8_t> data;
+    Lib_FirwareBinType type = TypeFromExtension(filename.c_str());
+    bool isOk;
 
-    if (GetMemPageOffset(&Page, &Offset, Address))
+    if (type == LIB_FIRMWAREBIN_BIN)
     {
+        isOk = this->SavePatch(&data);
+    }
+    else
+    {
+        FileBin_IntelHex_Memory delta;
 
-        if (this->Page.at(Page).Byte.size() < (Offset + 2))
-        {
-            cout << "Error writing memory" << endl;
-            return;
-        }
-
-        this->Page.at(Page).Byte.at(Offset) = value & 0xFF;
-        this->Page.at(Page).Byte.at(Offset+1) =(value >> 8u) & 0xFF;
+        this->DirtyImage(&delta);
+        isOk = (type == LIB_FIRMWAREBIN_SREC) ? delta.SaveSRec(&data, RecordBytes, isParallel) : delta.SaveHex(&data, RecordBytes, isParallel);
     }
 
+    return isOk && IntelHexWriteFile(filename, data);
 }
 
-void FileBin_IntelHex_Memory::WriteMem_uint32(uint32_t Address, uint32_t value)
+#define LIBPARSER_INTELHEX_CHUNK (1u << 20) /* Bytes of HEX text per parallel decode task, extended to the next line end */
+
+/* Consecutive data records of a chunk */
+typedef struct
+{
+    uint32_t Address; /* Absolute, or relative to the address in force at the chunk start if isLead */
+    bool isLead;
+    vector<uint8_t> Byte;
+} FileBin_IntelHex_RunType;
+
+/*
+ * Records of one chunk. Data records ahead of the first address record depend on the extended
+ * address in force at the chunk start, which is only known once the previous chunks are merged.
+ */
+typedef struct
+{
+    const uint8_t *pBegin;
+    const uint8_t *pEnd;
+    vector<FileBin_IntelHex_RunType> Run;
+    bool hasBase; /* An address record was seen, Base applies to the next chunk */
+    uint32_t Base;
+    bool isOk;
+} FileBin_IntelHex_ChunkType;
+
+/* Decodes the records of a chunk in place, stops at the first bad record with the data before it kept */
+static void IntelHexDecodeChunk(FileBin_IntelHex_ChunkType& Chunk)
 {
-    uint32_t Page, Offset;
+    const uint8_t *pLine = Chunk.pBegin;
 
-    if (GetMemPageOffset(&Page, &Offset, Address))
+    Chunk.hasBase = false;
+    Chunk.Base = 0;
+    Chunk.isOk = false;
+
+    while (pLine < Chunk.pEnd)
     {
+        const uint8_t *pNext = static_cast<const uint8_t *>(memchr(pLine, '\n', Chunk.pEnd - pLine));
+        size_t lineLen = (pNext ? pNext : Chunk.pEnd) - pLine;
+        pNext = pNext ? (pNext + 1) : Chunk.pEnd;
+
+        FileBin_IntelHex_Record record;
+        uint32_t sum = 0;
 
-        if (this->Page.at(Page).Byte.size() < (Offset + 4))
+        if (!record.ParseHeader(pLine, lineLen, &sum))
         {
-            cout << "Error writing memory" << endl;
             return;
         }
 
-        this->Page.at(Page).Byte.at(Offset) = value & 0xFF;
-        this->Page.at(Page).Byte.at(Offset+1) =(value >> 8u) & 0xFF;;
-        this->Page.at(Page).Byte.at(Offset+2) =(value >> 16u) & 0xFF;;
-        this->Page.at(Page).Byte.at(Offset+3) =(value >> 24u) & 0xFF;;
+        /* New data definition record, appended to the run if it follows it */
+        if (record.RecordType == 0x00)
+        {
+            uint32_t address = Chunk.Base + record.Address;
+            bool isLead = !Chunk.hasBase;
+
+            if (Chunk.Run.empty() || (Chunk.Run.back().isLead != isLead) ||
+                ((Chunk.Run.back().Address + Chunk.Run.back().Byte.size()) != address))
+            {
+                Chunk.Run.push_back({address, isLead, {}});
+            }
+
+            vector<uint8_t>& run = Chunk.Run.back().Byte;
+            size_t runLen = run.size();
+
+            run.resize(runLen + record.ByteCount);
+            if (!record.ParseData(pLine, run.data() + runLen, sum))
+            {
+                run.resize(runLen);
+                return;
+            }
+        }
+        else
+        {
+            uint8_t data[255];
+
+            if (!record.ParseData(pLine, data, sum))
+            {
+                return;
+            }
+
+            /* Extended segment address, or extended linear address record */
+            if (((record.RecordType == 0x02) || (record.RecordType == 0x04)) && (record.ByteCount >= 2))
+            {
+                Chunk.hasBase = true;
+                Chunk.Base = ((data[0] << 8u) + data[1]) << ((record.RecordType == 0x02) ? 4u : 16u);
+            }
+        }
+
+        pLine = pNext;
     }
 
+    Chunk.isOk = true;
 }
 
-void FileBin_IntelHex_Memory::WriteMem_sint32(uint32_t Address, int32_t value)
+/*
+ * Line chunks of a record file are decoded in parallel, then their runs are merged into the extents.
+ * StatsName prefixes the phase names, TraceName names the chunk scopes.
+ */
+static bool IntelHexLoadChunks(vector<FileBin_IntelHex_Page>& Page, const uint8_t *pBuffer, size_t Length,
+                               void (*DecodeChunk)(FileBin_IntelHex_ChunkType&), const char *StatsName, const char *TraceName)
 {
-    uint32_t Page, Offset;
+    /* Chunks end on a line end so that no record is split */
+    vector<FileBin_IntelHex_ChunkType> chunk;
+    const uint8_t *pEnd = pBuffer + Length;
+
+    for (const uint8_t *pChunk = pBuffer; pChunk < pEnd; )
+    {
+        const uint8_t *pCut = ((size_t)(pEnd - pChunk) > LIBPARSER_INTELHEX_CHUNK) ? (pChunk + LIBPARSER_INTELHEX_CHUNK) : pEnd;
+        const uint8_t *pNewLine = (pCut < pEnd) ? static_cast<const uint8_t *>(memchr(pCut, '\n', pEnd - pCut)) : nullptr;
+
+        pCut = pNewLine ? (pNewLine + 1) : pEnd;
+        chunk.push_back(FileBin_IntelHex_ChunkType());
+        chunk.back().pBegin = pChunk;
+        chunk.back().pEnd = pCut;
+        pChunk = pCut;
+    }
 
-    if (GetMemPageOffset(&Page, &Offset, Address))
     {
+        FileBin_StatsTimer timer(std::string(StatsName) + ".decode", Length);
 
-        if (this->Page.at(Page).Byte.size() < (Offset + 3 + 1))
+        FileBin_ThreadPool::Shared().ParallelFor(static_cast<uint32_t>(chunk.size()), 1, [&](uint32_t begin, uint32_t end)
         {
-            cout << "Error writing memory" << endl;
-            return;
+            for (uint32_t i = begin; i < end; i++)
+            {
+                FILEBIN_TRACE_SCOPE_ARG(TraceName, i);
+                DecodeChunk(chunk[i]);
+            }
+        });
+    }
+
+    FileBin_StatsTimer timer(std::string(StatsName) + ".merge");
+
+    /* In file order: lead runs take the address in force, up to the first bad record */
+    vector<FileBin_IntelHex_RunType*> run;
+    uint32_t base = 0;
+    bool isOk = true;
+
+    for (FileBin_IntelHex_ChunkType& c : chunk)
+    {
+        for (FileBin_IntelHex_RunType& r : c.Run)
+        {
+            if (r.isLead)
+            {
+                r.Address += base;
+            }
+            if (r.Byte.size() > 0)
+            {
+                run.push_back(&r);
+            }
         }
 
-        this->Page.at(Page).Byte.at(Offset) = value & 0xFF;
-        this->Page.at(Page).Byte.at(Offset+1) =(value >> 8u) & 0xFF;;
-        this->Page.at(Page).Byte.at(Offset+2) =(value >> 16u) & 0xFF;;
-        this->Page.at(Page).Byte.at(Offset+3) =(value >> 24u) & 0xFF;;
+        base = c.hasBase ? c.Base : base;
+
+        if (!c.isOk)
+        {
+            isOk = false;
+            break;
+        }
     }
 
-}
+    /* Address ordered extents of the runs, touching runs are joined */
+    vector<FileBin_IntelHex_RunType*> order(run);
 
-void FileBin_IntelHex_Memory::WriteMem_float32(uint32_t Address, float value)
-{
-    uint32_t Page, Offset;
+    std::stable_sort(order.begin(), order.end(), [](const FileBin_IntelHex_RunType* a, const FileBin_IntelHex_RunType* b)
+    {
+        return a->Address < b->Address;
+    });
 
-    if (GetMemPageOffset(&Page, &Offset, Address))
+    for (uint32_t i = 0; i < order.size(); i++)
     {
+        uint64_t runEnd = (uint64_t)order[i]->Address + order[i]->Byte.size();
 
-        if (this->Page.at(Page).Byte.size() < (Offset + 3 + 1))
+        if ((Page.size() > 0) && (order[i]->Address <= ((uint64_t)Page.back().BaseAddress + Page.back().Length_Bytes)))
         {
-            cout << "Error writing memory" << endl;
-            return;
+            FileBin_IntelHex_Page& page = Page.back();
+            page.Length_Bytes = static_cast<uint32_t>(std::max<uint64_t>(page.Length_Bytes, runEnd - page.BaseAddress));
+        }
+        else
+        {
+            FileBin_IntelHex_Page newPage;
+            newPage.BaseAddress = order[i]->Address;
+            newPage.Length_Bytes = static_cast<uint32_t>(order[i]->Byte.size());
+            Page.push_back(std::move(newPage));
         }
+    }
 
-        union {
-            float a;
-            unsigned char bytes[4];
-          } thing;
+    for (FileBin_IntelHex_Page& page : Page)
+    {
+        page.Allocate();
+    }
 
-        thing.a = value;
+    /* In file order, so a byte programmed twice (a malformed file) keeps the last record */
+    for (FileBin_IntelHex_RunType* r : run)
+    {
+        auto next = std::upper_bound(Page.begin(), Page.end(), r->Address, [](uint32_t a, const FileBin_IntelHex_Page& p)
+        {
+            return a < p.BaseAddress;
+        });
 
-         this->Page.at(Page).Byte.at(Offset) = thing.bytes[0];
-         this->Page.at(Page).Byte.at(Offset+1) = thing.bytes[1];
-         this->Page.at(Page).Byte.at(Offset+2) = thing.bytes[2];
-         this->Page.at(Page).Byte.at(Offset+3) = thing.bytes[3];
+        (next - 1)->Write(r->Address - (next - 1)->BaseAddress, static_cast<uint32_t>(r->Byte.size()), r->Byte.data());
     }
 
+    return isOk;
 }
 
-bool FileBin_IntelHex_Memory::Save(string filename)
+bool FileBin_IntelHex_Memory::LoadHex(const uint8_t *pBuffer, size_t Length)
 {
-    // Attempt to load file
-    QFile file(filename.c_str());
-    //QDataStream in(&file);
+    bool isOk = IntelHexLoadChunks(this->Page, pBuffer, Length, IntelHexDecodeChunk, "hex", "hex.chunk");
 
-    if (!file.open(QIODevice::WriteOnly | QFile::Truncate))
+    this->Share();
+    this->ClearDirty();
+    this->PageHit = 0;
+    return isOk;
+}
+
+/* Address bytes of an S-record type digit, 0 for S4 and anything that is no record */
+static inline uint32_t SRecAddressBytes(uint8_t Type)
+{
+    switch (Type)
     {
-        //QMessageBox::information(this, tr("Unable to open file"),
-        //file.errorString());
-        return false;
+        case '0': case '1': case '5': case '9': return 2;
+        case '2': case '6': case '8':           return 3;
+        case '3': case '7':                     return 4;
+        default:                                return 0;
     }
+}
+
+/* Every S-record carries its full address, so the runs of a chunk never depend on the previous chunks */
+static void SRecDecodeChunk(FileBin_IntelHex_ChunkType& Chunk)
+{
+    const uint8_t *pLine = Chunk.pBegin;
 
-    //this->Page.size()
-    for (uint32_t i = 0 ; i < this->Page.size() ; i++)
+    Chunk.hasBase = false;
+    Chunk.Base = 0;
+    Chunk.isOk = false;
+
+    while (pLine < Chunk.pEnd)
     {
+        const uint8_t *pNext = static_cast<const uint8_t *>(memchr(pLine, '\n', Chunk.pEnd - pLine));
+        size_t lineLen = (pNext ? pNext : Chunk.pEnd) - pLine;
+        pNext = pNext ? (pNext + 1) : Chunk.pEnd;
 
-        uint8_t recordArray[255];
-        recordArray[0] = ':';
-        recordArray[1] = FileBin_IntelHex_Record::Lib_IntelHex_NumToAscii(0);
-        recordArray[2] = FileBin_IntelHex_Record::Lib_IntelHex_NumToAscii(2);
-        recordArray[3] = FileBin_IntelHex_Record::Lib_IntelHex_NumToAscii(0);
-        recordArray[4] = FileBin_IntelHex_Record::Lib_IntelHex_NumToAscii(0);
-        recordArray[5] = FileBin_IntelHex_Record::Lib_IntelHex_NumToAscii(0);
-        recordArray[6] = FileBin_IntelHex_Record::Lib_IntelHex_NumToAscii(0);
-        recordArray[7] = FileBin_IntelHex_Record::Lib_IntelHex_NumToAscii(0);
-        recordArray[8] = FileBin_IntelHex_Record::Lib_IntelHex_NumToAscii(4);
+        /* Type, then the byte count of address, data and checksum */
+        uint32_t addressBytes = ((lineLen >= 4u) && (pLine[0] == 'S')) ? SRecAddressBytes(pLine[1]) : 0;
+        uint8_t count;
 
-        uint32_t baseAddr = this->Page.at(i).BaseAddress;
-        //cout << "base " << (baseAddr>>24u) << endl;
-        recordArray[9] = FileBin_IntelHex_Record::Lib_IntelHex_NumToAscii((baseAddr >> 28u) & 0xF);
-        recordArray[10] = FileBin_IntelHex_Record::Lib_IntelHex_NumToAscii((baseAddr >> 24u) & 0xF);
-        recordArray[11] = FileBin_IntelHex_Record::Lib_IntelHex_NumToAscii((baseAddr >> 20u) & 0xF);
-        recordArray[12] = FileBin_IntelHex_Record::Lib_IntelHex_NumToAscii((baseAddr >> 16u) & 0xF);
+        if ((addressBytes == 0) || (!FileBin_HexCodec::DecodeByte(&pLine[2], &count)) ||
+            (count < (addressBytes + 1u)) || (lineLen < (4u + (2u * count))))
+        {
+            return;
+        }
 
+        uint8_t field[4];
+        uint32_t sum = count;
+        uint32_t address = 0;
+        uint32_t dataBytes = count - addressBytes - 1u;
+        const uint8_t *pData = &pLine[4u + (2u * addressBytes)];
+        uint8_t crc;
 
-        uint8_t crc = 0;
+        if (!FileBin_HexCodec::Decode(&pLine[4], addressBytes, field, &sum))
+        {
+            return;
+        }
+        for (uint32_t i = 0; i < addressBytes; i++)
+        {
+            address = (address << 8u) | field[i];
+        }
 
-        crc -= 0x02;
-        crc -= 0x00;
-        crc -= 0x04;
-        crc -= baseAddr >> 24u;
-        crc -= baseAddr >> 16u;
+        /* S1/S2/S3 data records, appended to the run if they follow it */
+        if ((pLine[1] >= '1') && (pLine[1] <= '3'))
+        {
+            if (Chunk.Run.empty() || ((Chunk.Run.back().Address + Chunk.Run.back().Byte.size()) != address))
+            {
+                Chunk.Run.push_back({address, false, {}});
+            }
 
+            vector<uint8_t>& run = Chunk.Run.back().Byte;
+            size_t runLen = run.size();
 
-        recordArray[13] = FileBin_IntelHex_Record::Lib_IntelHex_NumToAscii((crc >> 4) & 0xF);
-        recordArray[14] = FileBin_IntelHex_Record::Lib_IntelHex_NumToAscii((crc) & 0xF);
-        recordArray[15] = 13;
-        recordArray[16] = 0;
-        file.write((const char *)recordArray);
-        file.write("\n");
-        for (uint32_t j = 0 ; j < this->Page.at(i).Byte.size() ; j++)
+            run.resize(runLen + dataBytes);
+            if ((!FileBin_HexCodec::Decode(pData, dataBytes, run.data() + runLen, &sum)) ||
+                (!FileBin_HexCodec::DecodeByte(pData + (2u * dataBytes), &crc)) || (crc != static_cast<uint8_t>(~sum)))
+            {
+                run.resize(runLen);
+                return;
+            }
+        }
+        else
         {
-            recordArray[1] = FileBin_IntelHex_Record::Lib_IntelHex_NumToAscii(1);
-            recordArray[2] = FileBin_IntelHex_Record::Lib_IntelHex_NumToAscii(0);
+            uint8_t data[255];
 
-            recordArray[3] = FileBin_IntelHex_Record::Lib_IntelHex_NumToAscii((j >> 12u) & 0xf);
-            recordArray[4] = FileBin_IntelHex_Record::Lib_IntelHex_NumToAscii((j >> 8u) & 0xf);
-            recordArray[5] = FileBin_IntelHex_Record::Lib_IntelHex_NumToAscii((j >> 4u) & 0xf);
-            recordArray[6] = FileBin_IntelHex_Record::Lib_IntelHex_NumToAscii((j >> 0u) & 0xf);
-            recordArray[7] = FileBin_IntelHex_Record::Lib_IntelHex_NumToAscii(0);
-            recordArray[8] = FileBin_IntelHex_Record::Lib_IntelHex_NumToAscii(0);
+            if ((!FileBin_HexCodec::Decode(pData, dataBytes, data, &sum)) ||
+                (!FileBin_HexCodec::DecodeByte(pData + (2u * dataBytes), &crc)) || (crc != static_cast<uint8_t>(~sum)))
+            {
+                return;
+            }
+        }
 
-            uint8_t byte;// = this->Page.at(i).Byte.at(j);
-            uint8_t byteCnt = 0;
-            uint8_t crc = 0;
-            crc -= 0x10;
-            crc -= (j >> 8u) & 0xFF;
-            crc -= (j >> 0u) & 0xFF;
+        pLine = pNext;
+    }
 
-            //cout << "crc1 " << (int)j << endl;
+    Chunk.isOk = true;
+}
 
+bool FileBin_IntelHex_Memory::LoadSRec(const uint8_t *pBuffer, size_t Length)
+{
+    bool isOk = IntelHexLoadChunks(this->Page, pBuffer, Length, SRecDecodeChunk, "srec", "srec.chunk");
 
-            /* There is at least 1 byte to process */
-            while (1)
-            {
-                if (j < this->Page.at(i).Byte.size())
-                {
-                    byte = this->Page.at(i).Byte.at(j);
-                    crc -= byte;
-                }
-                else
-                {
-                    /* Padding */
-                    byte = 0;
-                }
+    this->Share();
+    this->ClearDirty();
+    this->PageHit = 0;
+    return isOk;
+}
 
-                recordArray[9 + (byteCnt*2)] = FileBin_IntelHex_Record::Lib_IntelHex_NumToAscii((byte >> 4u) & 0xf);
-                recordArray[10 + (byteCnt*2)] = FileBin_IntelHex_Record::Lib_IntelHex_NumToAscii((byte >> 0u) & 0xf);
-                recordArray[11 + (byteCnt*2)] = FileBin_IntelHex_Record::Lib_IntelHex_NumToAscii((crc >> 4u) & 0xf);
-                recordArray[12 + (byteCnt*2)] = FileBin_IntelHex_Record::Lib_IntelHex_NumToAscii((crc >> 0u) & 0xf);
-                recordArray[13 + (byteCnt*2)] = 13;
-                recordArray[14 + (byteCnt*2)] = 0;
+bool FileBin_IntelHex_Memory::LoadBin(const uint8_t *pBuffer, size_t Length, uint32_t BaseAddress)
+{
+    this->PageHit = 0;
 
+    if (Length == 0)
+    {
+        return true;
+    }
+    if (static_cast<uint64_t>(Length) > (0x100000000ull - BaseAddress))
+    {
+        LOG(std::string(" ERRO] Lib_IntelHex_Memory::") + __func__ + ": Binary of " + std::to_string(Length) +
+            " bytes does not fit above base address " + std::to_string(BaseAddress));
+        return false;
+    }
 
-                byteCnt++;
-                if (byteCnt >= 16)
-                {
-                    break;
-                }
-                else
-                {
-                    j++;
-                }
-            }
+    FileBin_StatsTimer timer("bin", static_cast<uint64_t>(Length));
+    FileBin_IntelHex_Page newPage;
 
-           // cout << "crc " << (int)crc << endl;
+    /* One copy straight into the blocks, then deduplicated against the images already loaded */
+    newPage.BaseAddress = BaseAddress;
+    newPage.Length_Bytes = static_cast<uint32_t>(Length);
+    newPage.Allocate();
+    newPage.Write(0, newPage.Length_Bytes, pBuffer);
+    this->Page.push_back(std::move(newPage));
+    this->Share();
+    this->ClearDirty();
 
+    return true;
+}
 
-            file.write((const char *)recordArray);
-            file.write("\n");
-        }
+Lib_FirwareBinType FileBin_IntelHex_Memory::TypeFromExtension(const char *filePathAbs)
+{
+    string path(filePathAbs);
+    size_t dot = path.find_last_of("./\\");
+
+    if ((dot == string::npos) || (path[dot] != '.'))
+    {
+        return LIB_FIRMWAREBIN__UNKNOWN;
     }
 
-    file.close();
-    return true;
+    string ext = path.substr(dot + 1);
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return static_cast<char>(tolower(c)); });
+
+    if ((ext == "hex") || (ext == "ihx") || (ext == "ihex"))
+    {
+        return LIB_FIRMWAREBIN_HEX;
+    }
+    if ((ext == "s19") || (ext == "s28") || (ext == "s37") || (ext == "srec") || (ext == "mot") || (ext == "mhx"))
+    {
+        return LIB_FIRMWAREBIN_SREC;
+    }
+    if (ext == "bin")
+    {
+        return LIB_FIRMWAREBIN_BIN;
+    }
+
+    return LIB_FIRMWAREBIN__UNKNOWN;
 }
 
-bool FileBin_IntelHex_Memory::Load(const char *filePathAbs, Lib_FirwareBinType FirmwareBinType)
+Lib_FirwareBinType FileBin_IntelHex_Memory::DetectType(const char *filePathAbs, const uint8_t *pBuffer, size_t Length)
+{
+    /* The first record decides, whatever the extension says */
+    size_t i = 0;
+
+    while ((i < Length) && ((pBuffer[i] == ' ') || (pBuffer[i] == '\t') || (pBuffer[i] == '\r') || (pBuffer[i] == '\n')))
+    {
+        i++;
+    }
+
+    if ((i < Length) && (pBuffer[i] == ':') && ((i + 1) < Length) && (FileBin_HexCodec::NibbleTable[pBuffer[i + 1]] != FILEBIN_HEXCODEC_INVALID))
+    {
+        return LIB_FIRMWAREBIN_HEX;
+    }
+    if (((i + 1) < Length) && (pBuffer[i] == 'S') && (SRecAddressBytes(pBuffer[i + 1]) != 0))
+    {
+        return LIB_FIRMWAREBIN_SREC;
+    }
+
+    /* Not a record file (or empty), the extension may still tell */
+    Lib_FirwareBinType type = TypeFromExtension(filePathAbs);
+
+    return ((Length == 0) && (type != LIB_FIRMWAREBIN__UNKNOWN)) ? type : LIB_FIRMWAREBIN_BIN;
+}
+
+bool FileBin_IntelHex_Memory::Load(const char *filePathAbs, Lib_FirwareBinType FirmwareBinType, uint32_t BaseAddress)
 {
     /* Attempt to load file */
     QFile file(filePathAbs);
@@ -609,102 +1207,44 @@ bool FileBin_IntelHex_Memory::Load(const char *filePathAbs, Lib_FirwareBinType F
         return false;
     }
 
+    FileBin_StatsTimer timer("hex.load", static_cast<uint64_t>(file.size()));
+
     this->Clear();
 
+    /* Records are scanned in the mapping, an empty file cannot be mapped and simply has no pages */
+    FileBin_MappedFile mapped;
+    bool isMapped = (file.size() > 0) && mapped.open(filePathAbs);
 
-    if (FirmwareBinType == LIB_FIRMWAREBIN_HEX)
+    if (FirmwareBinType == LIB_FIRMWAREBIN__UNKNOWN)
     {
+        FirmwareBinType = DetectType(filePathAbs, isMapped ? mapped.data : nullptr, isMapped ? mapped.size : 0);
+    }
 
-        while (!file.atEnd())
-        {
-            QByteArray line = file.readLine();
-            FileBin_IntelHex_Record newRecord;
-
-            if (!newRecord.Parse((uint8_t *)line.toStdString().c_str(), line.toStdString().length()))
-            {
-                LOG(std::string(" ERRO] Lib_IntelHex_Memory::") + __func__ + ": Error parsing .hex file");
-                file.close();
-                return false;
-            }
-
-            if (newRecord.RecordType == 0x02)
-            {
-                // if coming from a previous page, fill in the padding zeroes
-                if ((this->Page.size() > 0) && ((this->Page.back().Byte.size() % 32) != 0))
-                {
-                    uint32_t lengthToPad = 32 - (this->Page.back().Byte.size() % 32);
-
-                    for (uint32_t j = 0; j < lengthToPad ; j++)
-                    {
-                        this->Page.back().Byte.push_back(0);
-                        this->Page.back().Length_Bytes++;
-                    }
-                }
-
-                FileBin_IntelHex_Page newPage;
-                newPage.BaseAddress = (((newRecord.Data.at(0) << 8u) + newRecord.Data.at(1)) << 4u);
-                this->Page.push_back(newPage);
-            }
-
-            /* New segment definition record */
-            else if (newRecord.RecordType == 0x04)
-            {
-                // if coming from a previous page, fill in the padding zeroes
-                /* TODO this strongly depends on architecture, tricore requires 32bit alignment */
-                if ((this->Page.size() > 0) && ((this->Page.back().Byte.size() % 32) != 0))
-                {
-                    uint32_t lengthToPad = 32 - (this->Page.back().Byte.size() % 32);
-
-                    for (uint32_t j = 0; j < lengthToPad ; j++)
-                    {
-                        this->Page.back().Byte.push_back(0);
-                        this->Page.back().Length_Bytes++;
-                    }
-                }
+    if ((FirmwareBinType == LIB_FIRMWAREBIN_HEX) || (FirmwareBinType == LIB_FIRMWAREBIN_SREC))
+    {
+        bool isOk = (file.size() == 0);
 
-                FileBin_IntelHex_Page newPage;
-                newPage.BaseAddress = (((newRecord.Data.at(0) << 8u) + newRecord.Data.at(1)) << 16u);
-                this->Page.push_back(newPage);
-            }
+        if (isMapped)
+        {
+            isOk = (FirmwareBinType == LIB_FIRMWAREBIN_HEX) ? this->LoadHex(mapped.data, mapped.size) : this->LoadSRec(mapped.data, mapped.size);
+        }
 
-            /* New data definition record */
-            else if (newRecord.RecordType == 0x00)
-            {
-                if (this->Page.size() > 0)
-                {
-                    for (uint32_t j = this->Page.back().Length_Bytes; j < newRecord.Address; j++)
-                    {
-                        this->Page.back().Byte.push_back(0);
-                        this->Page.back().Length_Bytes++;
-                    }
-
-                    for (uint32_t j = 0; j < newRecord.ByteCount; j++)
-                    {
-                        this->Page.back().Byte.push_back(newRecord.Data.at(j));
-                        this->Page.back().Length_Bytes++;
-                    }
-                }
-            }
+        if (!isOk)
+        {
+            LOG(std::string(" ERRO] Lib_IntelHex_Memory::") + __func__ + ": Error parsing " +
+                ((FirmwareBinType == LIB_FIRMWAREBIN_HEX) ? ".hex" : "S-record") + " file");
+            file.close();
+            return false;
         }
     }
     else if (FirmwareBinType == LIB_FIRMWAREBIN_BIN)
     {
-        uint8_t byte;
-        FileBin_IntelHex_Page newPage;
-
-        uint32_t lenFound = 0u;
-
-        newPage.BaseAddress = lenFound;
-        this->Page.push_back(newPage);
-
-        while ((!file.atEnd()))
+        /* Mapped whole, an empty binary simply has no pages */
+        if (isMapped ? !this->LoadBin(mapped.data, mapped.size, BaseAddress) : (file.size() != 0))
         {
-
-            // return value from 'file.read' should always be sizeof(char).
-            file.read((char *)&byte,sizeof(uint8_t));
-            this->Page.back().Byte.push_back(byte);
-            this->Page.back().Length_Bytes++;
-            lenFound++;
+            LOG(std::string(" ERRO] Lib_IntelHex_Memory::") + __func__ + ": Error loading .bin file");
+            file.close();
+            return false;
         }
     }
 
@@ -0,0 +1,366 @@
+/**
+ *  \file       FileBin_LeafTable.cpp
+ *  \brief      Flat structure-of-arrays table of every calibratable scalar
+ *
+ *  \version    1.0
+ *  \date       Oct 18, 2026
+ *  \author     Xavier Descarrega - DEVE embedded designs <info@deve.tech>
+ *
+ *  \copyright  MIT License
+ *
+ *              Copyright (c) 2026 Xavier Descarrega
+ *
+ *              Permission is hereby granted, free of charge, to any person obtaining a copy
+ *              of this software and associated documentation files (the "Software"), to deal
+ *              in the Software without restriction, including without limitation the rights
+ *              to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *              copies of the Software, and to permit persons to whom the Software is
+ *              furnished to do so, subject to the following conditions:
+ *
+ *              The above copyright notice and this permission notice shall be included in all
+ *              copies or substantial portions of the Software.
+ *
+ *              THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *              IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *              FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *              AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ *              LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *              OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *              SOFTWARE.
+ *
+ */
+
+#include "FileBin_LeafTable.h"
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+/*
+ * Locates Addr in the (address ordered) pages. Returns the page holding Addr or, when Addr falls in a
+ * gap, Pages.size() with Gap set to the bytes until the next page. Cursor remembers the last page so
+ * that ascending accesses do not search again.
+ */
+static size_t LeafTablePage(const vector<FileBin_IntelHex_Page>& Pages, uint32_t Addr, size_t& Cursor, uint32_t& Gap)
+{
+    if ((Cursor < Pages.size()) && (Addr >= Pages[Cursor].BaseAddress) && ((Addr - Pages[Cursor].BaseAddress) < Pages[Cursor].Length_Bytes))
+    {
+        return Cursor;
+    }
+
+    auto next = std::upper_bound(Pages.begin(), Pages.end(), Addr, [](uint32_t a, const FileBin_IntelHex_Page& p)
+    {
+        return a < p.BaseAddress;
+    });
+
+    if (next != Pages.begin())
+    {
+        const FileBin_IntelHex_Page& page = *(next - 1);
+        if ((Addr - page.BaseAddress) < page.Length_Bytes)
+        {
+            Cursor = static_cast<size_t>((next - 1) - Pages.begin());
+            return Cursor;
+        }
+    }
+
+    Gap = (next == Pages.end()) ? 0xFFFFFFFFu : (next->BaseAddress - Addr);
+    return Pages.size();
+}
+
+/* Copies Len bytes of the image to Dst, returns false if any byte is outside the image (read as 0) */
+static bool LeafTableRead(const FileBin_IntelHex_Memory& Mem, uint32_t Addr, uint32_t Len, uint8_t* Dst, size_t& Cursor)
+{
+    const vector<FileBin_IntelHex_Page>& Pages = Mem.Page;
+    bool complete = true;
+
+    while (Len > 0)
+    {
+        uint32_t gap = 0;
+        size_t p = LeafTablePage(Pages, Addr, Cursor, gap);
+        uint32_t chunk;
+
+        if (p == Pages.size())
+        {
+            chunk = std::min(Len, gap);
+            std::memset(Dst, 0, chunk);
+            complete = false;
+        }
+        else
+        {
+            uint32_t offset = Addr - Pages[p].BaseAddress;
+            chunk = std::min<uint32_t>(Len, Pages[p].Length_Bytes - offset);
+            Pages[p].Read(offset, chunk, Dst);
+        }
+
+        Addr += chunk;
+        Dst += chunk;
+        Len -= chunk;
+    }
+
+    return complete;
+}
+
+/* Stores Len bytes of Src in the image, tracked as dirty. Returns false if any byte is outside the image (dropped) */
+static bool LeafTableWrite(FileBin_IntelHex_Memory& Mem, uint32_t Addr, uint32_t Len, const uint8_t* Src, size_t& Cursor)
+{
+    bool complete = true;
+
+    while (Len > 0)
+    {
+        uint32_t gap = 0;
+        size_t p = LeafTablePage(Mem.Page, Addr, Cursor, gap);
+        uint32_t chunk;
+
+        if (p == Mem.Page.size())
+        {
+            chunk = std::min(Len, gap);
+            complete = false;
+        }
+        else
+        {
+            uint32_t offset = Addr - Mem.Page[p].BaseAddress;
+            chunk = std::min<uint32_t>(Len, Mem.Page[p].Length_Bytes - offset);
+            Mem.Update(static_cast<uint32_t>(p), offset, chunk, Src);
+        }
+
+        Addr += chunk;
+        Src += chunk;
+        Len -= chunk;
+    }
+
+    return complete;
+}
+
+/* Bitfields share their storage unit with the neighbour fields, only the field bits of Src are stored */
+static bool LeafTableStoreBitField(FileBin_IntelHex_Memory& Mem, uint32_t Addr, const FileBin_DWARF_BitFieldType& BitField, const uint8_t* Src, size_t& Cursor)
+{
+    uint8_t unit[8];
+    bool complete = LeafTableRead(Mem, Addr, BitField.Bytes, unit, Cursor);
+
+    uint64_t field = FileBin_DWARF_BitFieldLoad(Src, BitField.Bytes) >> BitField.Shift;
+    uint64_t merged = FileBin_DWARF_BitFieldSet(BitField, FileBin_DWARF_BitFieldLoad(unit, BitField.Bytes), static_cast<int64_t>(field));
+    for (uint32_t i = 0; i < BitField.Bytes; i++)
+    {
+        unit[i] = static_cast<uint8_t>(merged >> (i * 8));
+    }
+
+    return LeafTableWrite(Mem, Addr, BitField.Bytes, unit, Cursor) && complete;
+}
+
+void FileBin_LeafTable::Clear()
+{
+    this->Addr.clear();
+    this->Size.clear();
+    this->Type.clear();
+    this->Count.clear();
+    this->Stride.clear();
+    this->PathId.clear();
+    this->Parent.clear();
+    this->ValueOffset.clear();
+    this->BitField.clear();
+    this->IsSortedByAddress = false;
+}
+
+void FileBin_LeafTable::Build(const FileBin_SymbolIndex& Index)
+{
+    this->Clear();
+
+    uint32_t leafCnt = 0;
+    for (uint32_t id = 0; id < Index.Size(); id++)
+    {
+        const FileBin_SymbolIndex_EntryType& e = Index.GetEntry(id);
+        leafCnt += (e.IsLeaf && (e.Size > 0)) ? 1 : 0;
+    }
+
+    this->Addr.reserve(leafCnt);
+    this->Size.reserve(leafCnt);
+    this->Type.reserve(leafCnt);
+    this->Count.reserve(leafCnt);
+    this->Stride.reserve(leafCnt);
+    this->PathId.reserve(leafCnt);
+    this->Parent.reserve(leafCnt);
+    this->ValueOffset.reserve(leafCnt + 1);
+    this->BitField.reserve(leafCnt);
+
+    uint32_t offset = 0;
+    for (uint32_t id = 0; id < Index.Size(); id++)
+    {
+        const FileBin_SymbolIndex_EntryType& e = Index.GetEntry(id);
+        if (!e.IsLeaf || (e.Size == 0))
+        {
+            continue;
+        }
+
+        uint32_t stride = (e.ElemSize > 0) ? e.ElemSize : e.Size;
+        this->Addr.push_back(e.Addr);
+        this->Size.push_back(e.Size);
+        this->Type.push_back(static_cast<uint8_t>(e.DataType));
+        this->Count.push_back(e.Size / stride);
+        this->Stride.push_back(stride);
+        this->PathId.push_back(id);
+        this->Parent.push_back(e.Parent);
+        this->ValueOffset.push_back(offset);
+        this->BitField.push_back(e.BitField);
+        offset += e.Size;
+    }
+    this->ValueOffset.push_back(offset);
+}
+
+void FileBin_LeafTable::SortByAddress()
+{
+    uint32_t rows = this->Rows();
+    std::vector<uint32_t> order(rows);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b)
+    {
+        return this->Addr[a] < this->Addr[b];
+    });
+
+    auto permute = [&order](auto& column)
+    {
+        std::remove_reference_t<decltype(column)> sorted(column.size());
+        for (size_t i = 0; i < order.size(); i++)
+        {
+            sorted[i] = column[order[i]];
+        }
+        column.swap(sorted);
+    };
+
+    permute(this->Addr);
+    permute(this->Size);
+    permute(this->Type);
+    permute(this->Count);
+    permute(this->Stride);
+    permute(this->PathId);
+    permute(this->Parent);
+    permute(this->BitField);
+
+    /* Value buffer follows the new row order */
+    uint32_t offset = 0;
+    for (uint32_t i = 0; i < rows; i++)
+    {
+        this->ValueOffset[i] = offset;
+        offset += this->Size[i];
+    }
+    this->IsSortedByAddress = true;
+}
+
+bool FileBin_LeafTable::SortedByAddress() const
+{
+    return this->IsSortedByAddress;
+}
+
+uint32_t FileBin_LeafTable::Rows() const
+{
+    return static_cast<uint32_t>(this->Addr.size());
+}
+
+uint32_t FileBin_LeafTable::ValueBytes() const
+{
+    return this->ValueOffset.empty() ? 0 : this->ValueOffset.back();
+}
+
+bool FileBin_LeafTable::ReadLeaf(const FileBin_IntelHex_Memory& Mem, uint32_t Row, uint8_t* Dst) const
+{
+    size_t cursor = 0;
+    return LeafTableRead(Mem, this->Addr[Row], this->Size[Row], Dst, cursor);
+}
+
+bool FileBin_LeafTable::WriteLeaf(FileBin_IntelHex_Memory& Mem, uint32_t Row, const uint8_t* Src) const
+{
+    size_t cursor = 0;
+    if (this->BitField[Row].Bytes != 0)
+    {
+        return LeafTableStoreBitField(Mem, this->Addr[Row], this->BitField[Row], Src, cursor);
+    }
+    return LeafTableWrite(Mem, this->Addr[Row], this->Size[Row], Src, cursor);
+}
+
+bool FileBin_LeafTable::ReadScalar(const FileBin_IntelHex_Memory& Mem, uint32_t Row, int64_t& Value) const
+{
+    FileBin_DWARF_VarInfoLenType type = static_cast<FileBin_DWARF_VarInfoLenType>(this->Type[Row]);
+    if ((this->Count[Row] != 1) || (this->Size[Row] > 8) || (type == FileBin_VARINFO_TYPE_FLOAT32) || (type == FileBin_VARINFO_TYPE_FLOAT64))
+    {
+        return false;
+    }
+
+    uint8_t unit[8];
+    size_t cursor = 0;
+    bool complete = LeafTableRead(Mem, this->Addr[Row], this->Size[Row], unit, cursor);
+    uint64_t raw = FileBin_DWARF_BitFieldLoad(unit, this->Size[Row]);
+
+    if (this->BitField[Row].Bytes != 0)
+    {
+        Value = FileBin_DWARF_BitFieldGet(this->BitField[Row], raw);
+    }
+    else
+    {
+        /* Whole integers are a bitfield covering the full unit */
+        bool isSigned = (type == FileBin_VARINFO_TYPE_SINT8) || (type == FileBin_VARINFO_TYPE_SINT16) ||
+                        (type == FileBin_VARINFO_TYPE_SINT32) || (type == FileBin_VARINFO_TYPE_SINT64);
+        FileBin_DWARF_BitFieldType whole = {static_cast<uint8_t>(this->Size[Row]), 0, static_cast<uint8_t>(this->Size[Row] * 8), isSigned};
+        Value = FileBin_DWARF_BitFieldGet(whole, raw);
+    }
+    return complete;
+}
+
+bool FileBin_LeafTable::WriteScalar(FileBin_IntelHex_Memory& Mem, uint32_t Row, int64_t Value) const
+{
+    FileBin_DWARF_VarInfoLenType type = static_cast<FileBin_DWARF_VarInfoLenType>(this->Type[Row]);
+    if ((this->Count[Row] != 1) || (this->Size[Row] > 8) || (type == FileBin_VARINFO_TYPE_FLOAT32) || (type == FileBin_VARINFO_TYPE_FLOAT64))
+    {
+        return false;
+    }
+
+    uint8_t unit[8];
+    uint64_t raw = (this->BitField[Row].Bytes != 0) ? (static_cast<uint64_t>(Value) << this->BitField[Row].Shift) : static_cast<uint64_t>(Value);
+    for (uint32_t i = 0; i < 8; i++)
+    {
+        unit[i] = static_cast<uint8_t>(raw >> (i * 8));
+    }
+    return this->WriteLeaf(Mem, Row, unit);
+}
+
+uint32_t FileBin_LeafTable::Read(const FileBin_IntelHex_Memory& Mem, std::vector<uint8_t>& Values) const
+{
+    Values.resize(this->ValueBytes());
+
+    uint32_t missing = 0;
+    size_t cursor = 0;
+    for (uint32_t i = 0; i < this->Rows(); i++)
+    {
+        if (!LeafTableRead(Mem, this->Addr[i], this->Size[i], Values.data() + this->ValueOffset[i], cursor))
+        {
+            missing++;
+        }
+    }
+    return missing;
+}
+
+uint32_t FileBin_LeafTable::Write(FileBin_IntelHex_Memory& Mem, const std::vector<uint8_t>& Values) const
+{
+    if (Values.size() < this->ValueBytes())
+    {
+        return this->Rows();
+    }
+
+    uint32_t missing = 0;
+    size_t cursor = 0;
+    for (uint32_t i = 0; i < this->Rows(); i++)
+    {
+        bool complete;
+        if (this->BitField[i].Bytes != 0)
+        {
+            complete = LeafTableStoreBitField(Mem, this->Addr[i], this->BitField[i], Values.data() + this->ValueOffset[i], cursor);
+        }
+        else
+        {
+            complete = LeafTableWrite(Mem, this->Addr[i], this->Size[i], Values.data() + this->ValueOffset[i], cursor);
+        }
+
+        if (!complete)
+        {
+            missing++;
+        }
+    }
+    return missing;
+}
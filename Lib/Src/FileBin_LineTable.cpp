@@ -0,0 +1,737 @@
+/**
+ *  \file       FileBin_LineTable.cpp
+ *  \brief      Address to source line index decoded from .debug_line
+ *
+ *  \version    1.0
+ *  \date       Oct 18, 2026
+ *  \author     Xavier Descarrega - DEVE embedded designs <info@deve.tech>
+ *
+ *  \copyright  MIT License
+ *
+ *              Copyright (c) 2026 Xavier Descarrega
+ *
+ *              Permission is hereby granted, free of charge, to any person obtaining a copy
+ *              of this software and associated documentation files (the "Software"), to deal
+ *              in the Software without restriction, including without limitation the rights
+ *              to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *              copies of the Software, and to permit persons to whom the Software is
+ *              furnished to do so, subject to the following conditions:
+ *
+ *              The above copyright notice and this permission notice shall be included in all
+ *              copies or substantial portions of the Software.
+ *
+ *              THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *              IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *              FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *              AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ *              LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *              OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *              SOFTWARE.
+ *
+ */
+
+#include "FileBin_LineTable.h"
+#include "FileBin_DWARF_Def.h"
+#include "FileBin_ThreadPool.h"
+#include "FileBin_Stats.h"
+#include <algorithm>
+#include <iostream>
+#include <unordered_map>
+
+#define LIBPARSER_LINETABLE_STD_OPCODES 13 /* DW_LNS_copy .. DW_LNS_set_isa, 0 is the extended opcode escape */
+
+typedef struct
+{
+    uint32_t Addr;
+    uint32_t Line;
+    uint32_t File; /* Unit local until merged */
+} FileBin_LineTable_RowType;
+
+typedef struct
+{
+    uint16_t Version;
+    uint8_t AddrSize;
+    uint8_t MinInstLen;
+    bool DefaultIsStmt;
+    int8_t LineBase;
+    uint8_t LineRange;
+    uint8_t OpcodeBase;
+    const uint8_t* StdOpcodeLen; /* Operand count of standard opcodes 1 .. OpcodeBase-1 */
+} FileBin_LineTable_HeaderType;
+
+/* Line number state machine registers, only the ones stored in the table */
+typedef struct
+{
+    uint32_t Address;
+    uint32_t File;
+    uint32_t Line;
+    bool IsStmt;
+    const FileBin_LineTable_HeaderType* Header;
+    std::vector<FileBin_LineTable_RowType>* Out;
+} FileBin_LineTable_StateType;
+
+typedef struct
+{
+    std::vector<FileBin_LineTable_RowType> Row;
+    std::vector<std::string> File;
+    uint8_t FileFirst;
+    bool Ok;
+} FileBin_LineTable_UnitOutType;
+
+typedef void (*FileBin_LineTable_OpFn)(FileBin_LineTable_StateType& State, const uint8_t*& Ptr, const uint8_t* End);
+
+static uint64_t LineReadULEB(const uint8_t*& ptr, const uint8_t* end)
+{
+    uint64_t result = 0;
+    unsigned shift = 0;
+
+    while (ptr < end)
+    {
+        uint8_t byte = *ptr++;
+        if (shift < 64)
+        {
+            result |= uint64_t(byte & 0x7F) << shift;
+        }
+        shift += 7;
+
+        if ((byte & 0x80) == 0)
+        {
+            break;
+        }
+    }
+
+    return result;
+}
+
+static int64_t LineReadSLEB(const uint8_t*& ptr, const uint8_t* end)
+{
+    int64_t result = 0;
+    unsigned shift = 0;
+    uint8_t byte = 0;
+
+    while (ptr < end)
+    {
+        byte = *ptr++;
+        if (shift < 64)
+        {
+            result |= int64_t(byte & 0x7F) << shift;
+        }
+        shift += 7;
+
+        if ((byte & 0x80) == 0)
+        {
+            break;
+        }
+    }
+
+    if ((shift < 64) && (byte & 0x40))
+    {
+        result |= -(int64_t(1) << shift);
+    }
+
+    return result;
+}
+
+/* Little endian integer of Len bytes, the pointer is advanced even past 8 bytes */
+static uint64_t LineReadLE(const uint8_t*& ptr, const uint8_t* end, uint32_t Len)
+{
+    uint64_t value = 0;
+
+    for (uint32_t i = 0; (i < Len) && (ptr < end); i++, ptr++)
+    {
+        if (i < 8)
+        {
+            value |= uint64_t(*ptr) << (8 * i);
+        }
+    }
+
+    return value;
+}
+
+static std::string LineReadCStr(const uint8_t*& ptr, const uint8_t* end)
+{
+    const uint8_t* start = ptr;
+
+    while ((ptr < end) && (*ptr != 0))
+    {
+        ptr++;
+    }
+
+    std::string str(reinterpret_cast<const char*>(start), ptr - start);
+
+    if (ptr < end)
+    {
+        ptr++;
+    }
+
+    return str;
+}
+
+static bool LineIsAbsolute(const std::string& Path)
+{
+    return (!Path.empty()) && ((Path[0] == '/') || (Path[0] == '\\') || ((Path.size() > 1) && (Path[1] == ':')));
+}
+
+static std::string LineJoinPath(const std::string& Dir, const std::string& Name)
+{
+    if (Dir.empty() || LineIsAbsolute(Name))
+    {
+        return Name;
+    }
+
+    if ((Dir.back() == '/') || (Dir.back() == '\\'))
+    {
+        return Dir + Name;
+    }
+
+    return Dir + "/" + Name;
+}
+
+static void LineEmit(FileBin_LineTable_StateType& State)
+{
+    std::vector<FileBin_LineTable_RowType>& out = *State.Out;
+
+    /* Rows that do not change the source position add nothing to a lookup */
+    if ((!out.empty()) && (out.back().File == State.File) && (out.back().Line == State.Line))
+    {
+        return;
+    }
+
+    out.push_back({State.Address, State.Line, State.File});
+}
+
+static void LineOpCopy(FileBin_LineTable_StateType& State, const uint8_t*& Ptr, const uint8_t* End)
+{
+    (void)Ptr;
+    (void)End;
+    LineEmit(State);
+}
+
+static void LineOpAdvancePc(FileBin_LineTable_StateType& State, const uint8_t*& Ptr, const uint8_t* End)
+{
+    State.Address += static_cast<uint32_t>(LineReadULEB(Ptr, End)) * State.Header->MinInstLen;
+}
+
+static void LineOpAdvanceLine(FileBin_LineTable_StateType& State, const uint8_t*& Ptr, const uint8_t* End)
+{
+    State.Line += static_cast<int32_t>(LineReadSLEB(Ptr, End));
+}
+
+static void LineOpSetFile(FileBin_LineTable_StateType& State, const uint8_t*& Ptr, const uint8_t* End)
+{
+    State.File = static_cast<uint32_t>(LineReadULEB(Ptr, End));
+}
+
+static void LineOpSkipULEB(FileBin_LineTable_StateType& State, const uint8_t*& Ptr, const uint8_t* End)
+{
+    (void)State;
+    LineReadULEB(Ptr, End);
+}
+
+static void LineOpNegateStmt(FileBin_LineTable_StateType& State, const uint8_t*& Ptr, const uint8_t* End)
+{
+    (void)Ptr;
+    (void)End;
+    State.IsStmt = !State.IsStmt;
+}
+
+static void LineOpNone(FileBin_LineTable_StateType& State, const uint8_t*& Ptr, const uint8_t* End)
+{
+    (void)State;
+    (void)Ptr;
+    (void)End;
+}
+
+static void LineOpConstAddPc(FileBin_LineTable_StateType& State, const uint8_t*& Ptr, const uint8_t* End)
+{
+    (void)Ptr;
+    (void)End;
+    const FileBin_LineTable_HeaderType* header = State.Header;
+    State.Address += ((255u - header->OpcodeBase) / header->LineRange) * header->MinInstLen;
+}
+
+static void LineOpFixedAdvancePc(FileBin_LineTable_StateType& State, const uint8_t*& Ptr, const uint8_t* End)
+{
+    State.Address += static_cast<uint32_t>(LineReadLE(Ptr, End, 2));
+}
+
+/* Standard opcodes by number, the ones above LIBPARSER_LINETABLE_STD_OPCODES are skipped using StdOpcodeLen */
+static const FileBin_LineTable_OpFn LineStdOp[LIBPARSER_LINETABLE_STD_OPCODES] =
+{
+    nullptr,               /* 0: extended opcode */
+    LineOpCopy,            /* DW_LNS_copy */
+    LineOpAdvancePc,       /* DW_LNS_advance_pc */
+    LineOpAdvanceLine,     /* DW_LNS_advance_line */
+    LineOpSetFile,         /* DW_LNS_set_file */
+    LineOpSkipULEB,        /* DW_LNS_set_column */
+    LineOpNegateStmt,      /* DW_LNS_negate_stmt */
+    LineOpNone,            /* DW_LNS_set_basic_block */
+    LineOpConstAddPc,      /* DW_LNS_const_add_pc */
+    LineOpFixedAdvancePc,  /* DW_LNS_fixed_advance_pc */
+    LineOpNone,            /* DW_LNS_set_prologue_end */
+    LineOpNone,            /* DW_LNS_set_epilogue_begin */
+    LineOpSkipULEB,        /* DW_LNS_set_isa */
+};
+
+static void LineReset(FileBin_LineTable_StateType& State)
+{
+    State.Address = 0;
+    State.File = 1;
+    State.Line = 1;
+    State.IsStmt = State.Header->DefaultIsStmt;
+}
+
+/* Value of a DWARF 5 directory/file entry field, strings go to Str and constants to Val */
+static bool LineReadEntryForm(const uint8_t*& ptr, const uint8_t* end, uint64_t form, const uint8_t* fileData, size_t fileSize,
+                              const FileBin_LineTable_SectionType& Section, std::string& Str, uint64_t& Val)
+{
+    switch (form)
+    {
+        case DW_FORM_string:
+            Str = LineReadCStr(ptr, end);
+            return true;
+
+        case DW_FORM_line_strp:
+        case DW_FORM_strp:
+        {
+            uint64_t offset = ((form == DW_FORM_line_strp) ? Section.LineStrOffset : Section.StrOffset) + LineReadLE(ptr, end, 4);
+            if (offset < fileSize)
+            {
+                const uint8_t* str = fileData + offset;
+                Str = LineReadCStr(str, fileData + fileSize);
+            }
+            return true;
+        }
+
+        case DW_FORM_strx1: LineReadLE(ptr, end, 1); return true;
+        case DW_FORM_strx2: LineReadLE(ptr, end, 2); return true;
+        case DW_FORM_strx3: LineReadLE(ptr, end, 3); return true;
+        case DW_FORM_strx4: LineReadLE(ptr, end, 4); return true;
+        case DW_FORM_strx:  LineReadULEB(ptr, end); return true;
+
+        case DW_FORM_udata: Val = LineReadULEB(ptr, end); return true;
+        case DW_FORM_data1: Val = LineReadLE(ptr, end, 1); return true;
+        case DW_FORM_data2: Val = LineReadLE(ptr, end, 2); return true;
+        case DW_FORM_data4: Val = LineReadLE(ptr, end, 4); return true;
+        case DW_FORM_data8: Val = LineReadLE(ptr, end, 8); return true;
+        case DW_FORM_data16: LineReadLE(ptr, end, 16); return true;
+
+        case DW_FORM_block:
+        {
+            uint64_t len = LineReadULEB(ptr, end);
+            ptr = (len < static_cast<uint64_t>(end - ptr)) ? (ptr + len) : end;
+            return true;
+        }
+
+        default:
+            return false;
+    }
+}
+
+/* DWARF 5 directory or file name table, Dir is empty while the directories themselves are read */
+static bool LineReadEntryTable(const uint8_t*& ptr, const uint8_t* end, const uint8_t* fileData, size_t fileSize,
+                               const FileBin_LineTable_SectionType& Section, const std::string& CompDir,
+                               const std::vector<std::string>* Dir, std::vector<std::string>& Out)
+{
+    if (ptr >= end)
+    {
+        return false;
+    }
+
+    uint8_t formatCnt = *ptr++;
+    std::vector<std::pair<uint64_t, uint64_t>> format;
+
+    for (uint8_t i = 0; i < formatCnt; i++)
+    {
+        uint64_t type = LineReadULEB(ptr, end);
+        uint64_t form = LineReadULEB(ptr, end);
+        format.push_back({type, form});
+    }
+
+    uint64_t entryCnt = LineReadULEB(ptr, end);
+
+    for (uint64_t i = 0; (i < entryCnt) && (ptr < end); i++)
+    {
+        std::string path;
+        uint64_t dirIdx = 0;
+
+        for (const auto& field : format)
+        {
+            std::string str;
+            uint64_t val = 0;
+
+            if (!LineReadEntryForm(ptr, end, field.second, fileData, fileSize, Section, str, val))
+            {
+                return false;
+            }
+
+            if (field.first == DW_LNCT_path)
+            {
+                path = str;
+            }
+            else if (field.first == DW_LNCT_directory_index)
+            {
+                dirIdx = val;
+            }
+        }
+
+        if (Dir == nullptr)
+        {
+            /* Entry 0 is the compilation directory, the others are relative to it */
+            Out.push_back(LineJoinPath(Out.empty() ? CompDir : Out[0], path));
+        }
+        else
+        {
+            Out.push_back(LineJoinPath((dirIdx < Dir->size()) ? (*Dir)[dirIdx] : std::string(), path));
+        }
+    }
+
+    return true;
+}
+
+static void LineDecodeUnit(const uint8_t* fileData, size_t fileSize, const FileBin_LineTable_SectionType& Section,
+                           const FileBin_LineTable_UnitType& Unit, FileBin_LineTable_UnitOutType& Out)
+{
+    Out.Ok = false;
+    Out.FileFirst = 1;
+
+    if (!Unit.HasStmtList)
+    {
+        /* No line program, e.g. a data only unit */
+        Out.Ok = true;
+        return;
+    }
+
+    if (Unit.StmtList >= Section.LineLen)
+    {
+        return;
+    }
+
+    const uint8_t* sectionEnd = fileData + Section.LineOffset + Section.LineLen;
+    const uint8_t* ptr = fileData + Section.LineOffset + Unit.StmtList;
+
+    if (ptr + 4 > sectionEnd)
+    {
+        return;
+    }
+
+    uint32_t unitLen = static_cast<uint32_t>(LineReadLE(ptr, sectionEnd, 4));
+    if ((unitLen >= 0xFFFFFFF0u) || (unitLen > static_cast<uint64_t>(sectionEnd - ptr)))
+    {
+        /* 64-bit DWARF or truncated */
+        return;
+    }
+
+    const uint8_t* end = ptr + unitLen;
+
+    FileBin_LineTable_HeaderType header;
+    header.Version = static_cast<uint16_t>(LineReadLE(ptr, end, 2));
+    header.AddrSize = Unit.AddrSize;
+
+    if ((header.Version < 2) || (header.Version > 5))
+    {
+        return;
+    }
+
+    if (header.Version >= 5)
+    {
+        header.AddrSize = static_cast<uint8_t>(LineReadLE(ptr, end, 1));
+        LineReadLE(ptr, end, 1); /* segment_selector_size */
+    }
+
+    uint32_t headerLen = static_cast<uint32_t>(LineReadLE(ptr, end, 4));
+    if (headerLen > static_cast<uint64_t>(end - ptr))
+    {
+        return;
+    }
+
+    const uint8_t* program = ptr + headerLen;
+
+    header.MinInstLen = static_cast<uint8_t>(LineReadLE(ptr, program, 1));
+    if (header.Version >= 4)
+    {
+        LineReadLE(ptr, program, 1); /* maximum_operations_per_instruction, VLIW only */
+    }
+    header.DefaultIsStmt = (LineReadLE(ptr, program, 1) != 0);
+    header.LineBase = static_cast<int8_t>(LineReadLE(ptr, program, 1));
+    header.LineRange = static_cast<uint8_t>(LineReadLE(ptr, program, 1));
+    header.OpcodeBase = static_cast<uint8_t>(LineReadLE(ptr, program, 1));
+    header.StdOpcodeLen = ptr;
+
+    if ((header.LineRange == 0) || (header.OpcodeBase == 0) || (header.OpcodeBase - 1 > program - ptr))
+    {
+        return;
+    }
+    ptr += header.OpcodeBase - 1;
+
+    std::vector<std::string> dir;
+
+    if (header.Version <= 4)
+    {
+        dir.push_back(Unit.CompDir);
+        while ((ptr < program) && (*ptr != 0))
+        {
+            dir.push_back(LineJoinPath(Unit.CompDir, LineReadCStr(ptr, program)));
+        }
+        ptr++;
+
+        while ((ptr < program) && (*ptr != 0))
+        {
+            std::string name = LineReadCStr(ptr, program);
+            uint64_t dirIdx = LineReadULEB(ptr, program);
+            LineReadULEB(ptr, program); /* mtime */
+            LineReadULEB(ptr, program); /* length */
+            Out.File.push_back(LineJoinPath((dirIdx < dir.size()) ? dir[dirIdx] : std::string(), name));
+        }
+    }
+    else
+    {
+        Out.FileFirst = 0;
+
+        if ((!LineReadEntryTable(ptr, program, fileData, fileSize, Section, Unit.CompDir, nullptr, dir)) ||
+            (!LineReadEntryTable(ptr, program, fileData, fileSize, Section, Unit.CompDir, &dir, Out.File)))
+        {
+            return;
+        }
+    }
+
+    /* Line number program */
+    FileBin_LineTable_StateType state;
+    state.Header = &header;
+    state.Out = &Out.Row;
+    LineReset(state);
+
+    ptr = program;
+
+    while (ptr < end)
+    {
+        uint8_t opcode = *ptr++;
+
+        if (opcode >= header.OpcodeBase)
+        {
+            /* Special opcode: address and line advance packed in the opcode */
+            uint32_t adjusted = opcode - header.OpcodeBase;
+            state.Address += (adjusted / header.LineRange) * header.MinInstLen;
+            state.Line += header.LineBase + static_cast<int32_t>(adjusted % header.LineRange);
+            LineEmit(state);
+        }
+        else if (opcode == 0)
+        {
+            uint64_t len = LineReadULEB(ptr, end);
+            if ((len == 0) || (len > static_cast<uint64_t>(end - ptr)))
+            {
+                break;
+            }
+
+            const uint8_t* next = ptr + len;
+            uint8_t subOpcode = *ptr++;
+
+            switch (subOpcode)
+            {
+                case DW_LNE_end_sequence:
+                {
+                    state.Out->push_back({state.Address, 0, FILEBIN_LINETABLE_NONE});
+                    LineReset(state);
+                    break;
+                }
+
+                case DW_LNE_set_address:
+                {
+                    state.Address = static_cast<uint32_t>(LineReadLE(ptr, next, static_cast<uint32_t>(len - 1)));
+                    break;
+                }
+
+                case DW_LNE_define_file:
+                {
+                    std::string name = LineReadCStr(ptr, next);
+                    uint64_t dirIdx = LineReadULEB(ptr, next);
+                    Out.File.push_back(LineJoinPath((dirIdx < dir.size()) ? dir[dirIdx] : std::string(), name));
+                    break;
+                }
+
+                default:
+                    break;
+            }
+
+            ptr = next;
+        }
+        else if (opcode < LIBPARSER_LINETABLE_STD_OPCODES)
+        {
+            LineStdOp[opcode](state, ptr, end);
+        }
+        else
+        {
+            /* Standard opcode unknown to this decoder, skip its ULEB operands */
+            for (uint8_t i = 0; i < header.StdOpcodeLen[opcode - 1]; i++)
+            {
+                LineReadULEB(ptr, end);
+            }
+        }
+    }
+
+    Out.Ok = true;
+}
+
+uint32_t FileBin_LineTable::Build(const uint8_t* FileData, size_t FileSize, const FileBin_LineTable_SectionType& Section, const std::vector<FileBin_LineTable_UnitType>& Unit)
+{
+    FileBin_StatsTimer timer("dwarf.line_decode", Section.LineLen);
+
+    this->Clear();
+
+    uint32_t unitCnt = static_cast<uint32_t>(Unit.size());
+    this->UnitFileBase.assign(unitCnt, 0);
+    this->UnitFileCnt.assign(unitCnt, 0);
+    this->UnitFileFirst.assign(unitCnt, 1);
+
+    if ((FileData == nullptr) || (Section.LineLen == 0) || (static_cast<uint64_t>(Section.LineOffset) + Section.LineLen > FileSize))
+    {
+        return 0;
+    }
+
+    std::vector<FileBin_LineTable_UnitOutType> out(unitCnt);
+
+    FileBin_ThreadPool::Shared().ParallelFor(unitCnt, 1, [&](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t i = begin; i < end; i++)
+        {
+            LineDecodeUnit(FileData, FileSize, Section, Unit[i], out[i]);
+        }
+    });
+
+    /* Unit local file indices to unique paths */
+    std::unordered_map<std::string, uint32_t> fileId;
+    std::vector<FileBin_LineTable_RowType> row;
+    uint32_t failCnt = 0;
+    size_t rowCnt = 0;
+
+    for (const auto& unit : out)
+    {
+        rowCnt += unit.Row.size();
+    }
+    row.reserve(rowCnt);
+
+    for (uint32_t u = 0; u < unitCnt; u++)
+    {
+        FileBin_LineTable_UnitOutType& unit = out[u];
+
+        failCnt += (!unit.Ok);
+
+        this->UnitFileBase[u] = static_cast<uint32_t>(this->UnitFileId.size());
+        this->UnitFileCnt[u] = static_cast<uint32_t>(unit.File.size());
+        this->UnitFileFirst[u] = unit.FileFirst;
+
+        for (auto& name : unit.File)
+        {
+            auto it = fileId.emplace(name, static_cast<uint32_t>(this->FileName.size()));
+            if (it.second)
+            {
+                this->FileName.push_back(name);
+            }
+            this->UnitFileId.push_back(it.first->second);
+        }
+
+        for (const auto& r : unit.Row)
+        {
+            const std::string* file = this->FileOf(u, r.File);
+            uint32_t id = (file != nullptr) ? static_cast<uint32_t>(file - this->FileName.data()) : FILEBIN_LINETABLE_NONE;
+            row.push_back({r.Addr, r.Line, (r.File == FILEBIN_LINETABLE_NONE) ? FILEBIN_LINETABLE_NONE : id});
+        }
+
+        std::vector<FileBin_LineTable_RowType>().swap(unit.Row);
+    }
+
+    /* At equal addresses the end of a sequence goes first so that the next sequence wins the lookup */
+    std::stable_sort(row.begin(), row.end(), [](const FileBin_LineTable_RowType& a, const FileBin_LineTable_RowType& b)
+    {
+        if (a.Addr != b.Addr)
+        {
+            return a.Addr < b.Addr;
+        }
+        return (a.File != FILEBIN_LINETABLE_NONE) < (b.File != FILEBIN_LINETABLE_NONE);
+    });
+
+    this->Addr.reserve(row.size());
+    this->Line.reserve(row.size());
+    this->File.reserve(row.size());
+
+    for (const auto& r : row)
+    {
+        if ((!this->File.empty()) && (this->File.back() == r.File) && (this->Line.back() == r.Line))
+        {
+            continue;
+        }
+
+        this->Addr.push_back(r.Addr);
+        this->Line.push_back(r.Line);
+        this->File.push_back(r.File);
+    }
+
+    this->Addr.shrink_to_fit();
+    this->Line.shrink_to_fit();
+    this->File.shrink_to_fit();
+
+    FileBin_Stats::Global().CounterSet("dwarf.line_rows", this->Addr.size());
+
+    if (failCnt > 0)
+    {
+        std::cout << "[ERROR] Unable to decode the line program of " << failCnt << " compilation units" << std::endl;
+    }
+
+    return failCnt;
+}
+
+void FileBin_LineTable::Clear()
+{
+    this->Addr.clear();
+    this->Line.clear();
+    this->File.clear();
+    this->FileName.clear();
+    this->UnitFileId.clear();
+    this->UnitFileBase.clear();
+    this->UnitFileCnt.clear();
+    this->UnitFileFirst.clear();
+}
+
+uint32_t FileBin_LineTable::Rows() const
+{
+    return static_cast<uint32_t>(this->Addr.size());
+}
+
+bool FileBin_LineTable::Find(uint32_t Address, FileBin_LineTable_ResultType& Result) const
+{
+    auto it = std::upper_bound(this->Addr.begin(), this->Addr.end(), Address);
+
+    if (it == this->Addr.begin())
+    {
+        return false;
+    }
+
+    size_t idx = static_cast<size_t>(it - this->Addr.begin()) - 1;
+
+    if (this->File[idx] == FILEBIN_LINETABLE_NONE)
+    {
+        return false;
+    }
+
+    Result.Addr = this->Addr[idx];
+    Result.Line = this->Line[idx];
+    Result.File = &this->FileName[this->File[idx]];
+
+    return true;
+}
+
+const std::string* FileBin_LineTable::FileOf(uint32_t UnitIdx, uint32_t FileIdx) const
+{
+    if ((UnitIdx >= this->UnitFileBase.size()) || (FileIdx < this->UnitFileFirst[UnitIdx]))
+    {
+        return nullptr;
+    }
+
+    uint32_t idx = FileIdx - this->UnitFileFirst[UnitIdx];
+    if (idx >= this->UnitFileCnt[UnitIdx])
+    {
+        return nullptr;
+    }
+
+    return &this->FileName[this->UnitFileId[this->UnitFileBase[UnitIdx] + idx]];
+}
@@ -0,0 +1,303 @@
+/**
+ *  \file       FileBin_Stats.cpp
+ *  \brief      Load pipeline timers and counters
+ *
+ *  \version    1.0
+ *  \date       Oct 18, 2026
+ *  \author     Xavier Descarrega - DEVE embedded designs <info@deve.tech>
+ *
+ *  \copyright  MIT License
+ *
+ *              Copyright (c) 2026 Xavier Descarrega
+ *
+ *              Permission is hereby granted, free of charge, to any person obtaining a copy
+ *              of this software and associated documentation files (the "Software"), to deal
+ *              in the Software without restriction, including without limitation the rights
+ *              to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *              copies of the Software, and to permit persons to whom the Software is
+ *              furnished to do so, subject to the following conditions:
+ *
+ *              The above copyright notice and this permission notice shall be included in all
+ *              copies or substantial portions of the Software.
+ *
+ *              THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *              IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *              FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *              AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ *              LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *              OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *              SOFTWARE.
+ *
+ */
+
+#include "FileBin_Stats.h"
+#include "FileBin_Trace.h"
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <sstream>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+static std::atomic<uint64_t> StatsAllocCount{0};
+static std::atomic<uint64_t> StatsAllocBytes{0};
+
+#if defined(FILEBIN_STATS_ALLOC_HOOK)
+/* Replaces the global allocator to count every allocation of the process */
+void* operator new(std::size_t Size)
+{
+    StatsAllocCount.fetch_add(1, std::memory_order_relaxed);
+    StatsAllocBytes.fetch_add(Size, std::memory_order_relaxed);
+    if (void* p = std::malloc(Size ? Size : 1))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t Size)
+{
+    return ::operator new(Size);
+}
+
+void operator delete(void* Ptr) noexcept
+{
+    std::free(Ptr);
+}
+
+void operator delete[](void* Ptr) noexcept
+{
+    std::free(Ptr);
+}
+
+void operator delete(void* Ptr, std::size_t) noexcept
+{
+    std::free(Ptr);
+}
+
+void operator delete[](void* Ptr, std::size_t) noexcept
+{
+    std::free(Ptr);
+}
+#endif
+
+static std::string StatsJSONEscape(const std::string& Text)
+{
+    std::string out;
+    for (char c : Text)
+    {
+        if ((c == '"') || (c == '\\'))
+        {
+            out += '\\';
+            out += c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20)
+        {
+            char buf[8];
+            std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+            out += buf;
+        }
+        else
+        {
+            out += c;
+        }
+    }
+    return out;
+}
+
+FileBin_Stats& FileBin_Stats::Global()
+{
+    static FileBin_Stats stats;
+    return stats;
+}
+
+FileBin_Stats_PhaseType* FileBin_Stats::Phase(const std::string& Name)
+{
+    std::lock_guard<std::mutex> lock(this->Lock);
+
+    for (auto& phase : this->PhaseList)
+    {
+        if (phase.Name == Name)
+        {
+            return &phase;
+        }
+    }
+    this->PhaseList.emplace_back();
+    this->PhaseList.back().Name = Name;
+    return &this->PhaseList.back();
+}
+
+FileBin_Stats_CounterType* FileBin_Stats::Counter(const std::string& Name)
+{
+    std::lock_guard<std::mutex> lock(this->Lock);
+
+    for (auto& counter : this->CounterList)
+    {
+        if (counter.Name == Name)
+        {
+            return &counter;
+        }
+    }
+    this->CounterList.emplace_back();
+    this->CounterList.back().Name = Name;
+    return &this->CounterList.back();
+}
+
+void FileBin_Stats::PhaseAdd(FileBin_Stats_PhaseType* Phase, uint64_t Ns, uint64_t Bytes)
+{
+    Phase->Calls.fetch_add(1, std::memory_order_relaxed);
+    Phase->TimeNs.fetch_add(Ns, std::memory_order_relaxed);
+    Phase->Bytes.fetch_add(Bytes, std::memory_order_relaxed);
+
+    uint64_t max = Phase->MaxNs.load(std::memory_order_relaxed);
+    while ((Ns > max) && !Phase->MaxNs.compare_exchange_weak(max, Ns, std::memory_order_relaxed))
+    {
+    }
+}
+
+void FileBin_Stats::CounterAdd(const std::string& Name, uint64_t Value)
+{
+    this->Counter(Name)->Value.fetch_add(Value, std::memory_order_relaxed);
+}
+
+void FileBin_Stats::CounterSet(const std::string& Name, uint64_t Value)
+{
+    this->Counter(Name)->Value.store(Value, std::memory_order_relaxed);
+}
+
+void FileBin_Stats::Reset()
+{
+    std::lock_guard<std::mutex> lock(this->Lock);
+
+    for (auto& phase : this->PhaseList)
+    {
+        phase.Calls = 0;
+        phase.TimeNs = 0;
+        phase.MaxNs = 0;
+        phase.Bytes = 0;
+    }
+    for (auto& counter : this->CounterList)
+    {
+        counter.Value = 0;
+    }
+}
+
+std::vector<FileBin_Stats_SnapshotType> FileBin_Stats::Phases() const
+{
+    std::lock_guard<std::mutex> lock(this->Lock);
+
+    std::vector<FileBin_Stats_SnapshotType> list;
+    for (const auto& phase : this->PhaseList)
+    {
+        list.push_back({phase.Name, phase.Calls.load(), phase.TimeNs.load(), phase.MaxNs.load(), phase.Bytes.load()});
+    }
+    return list;
+}
+
+std::vector<FileBin_Stats_SnapshotType> FileBin_Stats::Counters() const
+{
+    std::lock_guard<std::mutex> lock(this->Lock);
+
+    std::vector<FileBin_Stats_SnapshotType> list;
+    for (const auto& counter : this->CounterList)
+    {
+        list.push_back({counter.Name, counter.Value.load(), 0, 0, 0});
+    }
+    return list;
+}
+
+/* {"phases":[{"name","calls","total_ms","max_ms","bytes"}...],"counters":{...},"process_*"} */
+std::string FileBin_Stats::ToJSON() const
+{
+    std::ostringstream out;
+    out.precision(3);
+    out << std::fixed;
+
+    out << "{\n  \"phases\": [";
+    bool first = true;
+    for (const auto& phase : this->Phases())
+    {
+        out << (first ? "\n" : ",\n");
+        out << "    {\"name\": \"" << StatsJSONEscape(phase.Name) << "\", \"calls\": " << phase.Calls
+            << ", \"total_ms\": " << (phase.TimeNs / 1e6) << ", \"max_ms\": " << (phase.MaxNs / 1e6)
+            << ", \"bytes\": " << phase.Bytes << "}";
+        first = false;
+    }
+    out << "\n  ],\n  \"counters\": {";
+    first = true;
+    for (const auto& counter : this->Counters())
+    {
+        out << (first ? "\n" : ",\n");
+        out << "    \"" << StatsJSONEscape(counter.Name) << "\": " << counter.Calls;
+        first = false;
+    }
+    out << "\n  },\n";
+    out << "  \"process_alloc_count\": " << AllocCount() << ",\n";
+    out << "  \"process_alloc_bytes\": " << AllocBytes() << ",\n";
+    out << "  \"process_peak_rss_bytes\": " << PeakRSSBytes() << "\n}\n";
+
+    return out.str();
+}
+
+uint64_t FileBin_Stats::PeakRSSBytes()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+    {
+        return static_cast<uint64_t>(pmc.PeakWorkingSetSize);
+    }
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+    {
+        return 0;
+    }
+#if defined(__APPLE__)
+    return static_cast<uint64_t>(usage.ru_maxrss); /* Bytes on macOS */
+#else
+    return static_cast<uint64_t>(usage.ru_maxrss) * 1024u; /* KiB on Linux */
+#endif
+#endif
+}
+
+uint64_t FileBin_Stats::AllocCount()
+{
+    return StatsAllocCount.load(std::memory_order_relaxed);
+}
+
+uint64_t FileBin_Stats::AllocBytes()
+{
+    return StatsAllocBytes.load(std::memory_order_relaxed);
+}
+
+FileBin_StatsTimer::FileBin_StatsTimer(FileBin_Stats_PhaseType* Phase, uint64_t Bytes) : PhaseRef(Phase), BytesDone(Bytes), Start(std::chrono::steady_clock::now())
+{
+}
+
+FileBin_StatsTimer::FileBin_StatsTimer(const std::string& Phase, uint64_t Bytes) : FileBin_StatsTimer(FileBin_Stats::Global().Phase(Phase), Bytes)
+{
+}
+
+FileBin_StatsTimer::~FileBin_StatsTimer()
+{
+    uint64_t ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - this->Start).count());
+    FileBin_Stats::Global().PhaseAdd(this->PhaseRef, ns, this->BytesDone);
+
+#if defined(FILEBIN_TRACE)
+    /* Phases double as trace events, the byte count shows the CU size in the timeline */
+    uint64_t end = FileBin_Trace::Now();
+    FileBin_Trace::Record(this->PhaseRef->Name.c_str(), end - ns, end, this->BytesDone);
+#endif
+}
+
+void FileBin_StatsTimer::AddBytes(uint64_t Bytes)
+{
+    this->BytesDone += Bytes;
+}
@@ -0,0 +1,651 @@
+/**
+ *  \file       FileBin_SymbolIndex.cpp
+ *  \brief      Prefix and substring search over fully qualified symbol paths
+ *
+ *  \version    1.0
+ *  \date       Oct 18, 2026
+ *  \author     Xavier Descarrega - DEVE embedded designs <info@deve.tech>
+ *
+ *  \copyright  MIT License
+ *
+ *              Copyright (c) 2026 Xavier Descarrega
+ *
+ *              Permission is hereby granted, free of charge, to any person obtaining a copy
+ *              of this software and associated documentation files (the "Software"), to deal
+ *              in the Software without restriction, including without limitation the rights
+ *              to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *              copies of the Software, and to permit persons to whom the Software is
+ *              furnished to do so, subject to the following conditions:
+ *
+ *              The above copyright notice and this permission notice shall be included in all
+ *              copies or substantial portions of the Software.
+ *
+ *              THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *              IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *              FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *              AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ *              LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *              OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *              SOFTWARE.
+ *
+ */
+
+#include "FileBin_SymbolIndex.h"
+#include "FileBin_ThreadPool.h"
+#include <algorithm>
+#include <numeric>
+
+#define LIBPARSER_SYMBOLINDEX_TRIGRAM_BUCKETS 65536
+#define LIBPARSER_SYMBOLINDEX_CHUNK 16384 /* Entries per sort/trigram build task */
+#define LIBPARSER_SYMBOLINDEX_MAX_ELEMENTS 4096 /* Larger arrays of structs are indexed by field only */
+#define LIBPARSER_SYMBOLINDEX_FUZZY_COMMON 8 /* Fuzzy lookups ignore trigrams found in more than 1/8 of the paths */
+
+/* Entries produced by a single CU, concatenated in CU order once every CU is walked */
+typedef struct
+{
+    std::vector<FileBin_SymbolIndex_EntryType> Entry;
+    std::string PathData;
+    std::vector<uint32_t> PathEnd;
+} FileBin_SymbolIndex_PartType;
+
+static uint32_t SymbolBytes(const std::vector<uint32_t>& Size)
+{
+    if (Size.empty())
+    {
+        return 0;
+    }
+    uint32_t bytes = 1;
+    for (uint32_t s : Size)
+    {
+        bytes *= s;
+    }
+    return bytes;
+}
+
+/* True when a non-qualifier node (member) hangs below node, looking through qualifiers only */
+static bool SymbolHasMembers(const FileBin_DWARF_VarInfoType* node)
+{
+    while (node)
+    {
+        if (!node->isQualifier || (node->child && SymbolHasMembers(node->child)))
+        {
+            return true;
+        }
+        node = node->next;
+    }
+    return false;
+}
+
+/* Returns the CU local id of the new entry, entries start as leaves until a member is emitted below */
+static uint32_t SymbolIndexEmit(FileBin_SymbolIndex_PartType& part, uint32_t CUIdx, uint32_t Parent, const std::string& Path, uint32_t Addr, uint32_t Size, uint32_t ElemSize, FileBin_DWARF_VarInfoLenType DataType, FileBin_DWARF_BitFieldType BitField = {})
+{
+    uint32_t id = static_cast<uint32_t>(part.Entry.size());
+
+    part.PathData += Path;
+    part.PathEnd.push_back(static_cast<uint32_t>(part.PathData.size()));
+    part.Entry.push_back({CUIdx, Addr, Size, ElemSize, Parent, DataType, true, BitField});
+
+    if (Parent != FILEBIN_SYMBOLINDEX_NO_PARENT)
+    {
+        part.Entry[Parent].IsLeaf = false;
+    }
+    return id;
+}
+
+/* Extra is the offset of the array element being walked, it applies to the whole subtree */
+static void SymbolIndexWalk(FileBin_SymbolIndex_PartType& part, uint32_t CUIdx, const FileBin_DWARF_VarInfoType* node, uint32_t base, uint32_t Extra, uint32_t Parent, const std::string& Prefix, char Sep)
+{
+    while (node)
+    {
+        if (node->isQualifier || node->data.empty())
+        {
+            /* Qualifiers and anonymous struct/union members add nothing to the path */
+            if (node->child)
+            {
+                SymbolIndexWalk(part, CUIdx, node->child, FileBin_DWARF_SymbolChildBase(node, base), Extra, Parent, Prefix, Sep);
+            }
+            node = node->next;
+            continue;
+        }
+
+        std::string path = Prefix;
+        path += Sep;
+        path.append(node->data.begin(), node->data.end());
+
+        uint32_t addr = FileBin_DWARF_SymbolAddr(node, base) + Extra;
+        uint32_t childBase = FileBin_DWARF_SymbolChildBase(node, base);
+        uint32_t bytes = SymbolBytes(node->Size);
+        uint32_t elemSize = (node->Size.size() > 1) ? node->Size.back() : bytes;
+        uint32_t id = SymbolIndexEmit(part, CUIdx, Parent, path, addr, bytes, elemSize, node->DataType, node->BitField);
+
+        if (node->child && SymbolHasMembers(node->child))
+        {
+            uint32_t elemCnt = 1;
+            for (size_t d = 0; (d + 1) < node->Size.size(); d++)
+            {
+                elemCnt *= node->Size[d];
+            }
+
+            if ((node->Size.size() > 1) && (elemCnt <= LIBPARSER_SYMBOLINDEX_MAX_ELEMENTS))
+            {
+                /* Array of structs, one entry per element and per element field */
+                uint32_t dimCnt = static_cast<uint32_t>(node->Size.size() - 1);
+                std::vector<uint32_t> idx(dimCnt, 0);
+
+                for (uint32_t e = 0; e < elemCnt; e++)
+                {
+                    std::string elemPath = path;
+                    for (uint32_t i : idx)
+                    {
+                        elemPath += '[';
+                        elemPath += std::to_string(i);
+                        elemPath += ']';
+                    }
+
+                    uint32_t elemId = SymbolIndexEmit(part, CUIdx, id, elemPath, addr + e * elemSize, elemSize, elemSize, node->DataType);
+                    SymbolIndexWalk(part, CUIdx, node->child, childBase, Extra + e * elemSize, elemId, elemPath, '.');
+
+                    /* Row major increment of the element index */
+                    for (uint32_t d = dimCnt; d-- > 0;)
+                    {
+                        if (++idx[d] < node->Size[d])
+                        {
+                            break;
+                        }
+                        idx[d] = 0;
+                    }
+                }
+            }
+            else
+            {
+                SymbolIndexWalk(part, CUIdx, node->child, childBase, Extra, id, path, '.');
+            }
+        }
+
+        node = node->next;
+    }
+}
+
+static std::string SymbolIndexCUName(const FileBin_DWARF_VarInfoType* cu)
+{
+    std::string name(cu->data.begin(), cu->data.end());
+
+    size_t slash = name.find_last_of("/\\");
+    if (slash != std::string::npos)
+    {
+        name.erase(0, slash + 1);
+    }
+    size_t dot = name.find_last_of('.');
+    if ((dot != std::string::npos) && (dot > 0))
+    {
+        name.erase(dot);
+    }
+    return name;
+}
+
+static inline uint32_t LowerAscii(char c)
+{
+    uint32_t u = static_cast<unsigned char>(c);
+    return ((u - 'A') < 26u) ? (u | 0x20u) : u;
+}
+
+static inline uint32_t TrigramBucket(const char* c)
+{
+    uint32_t key = (LowerAscii(c[0]) << 16) | (LowerAscii(c[1]) << 8) | LowerAscii(c[2]);
+    return (key * 2654435761u) >> 16;
+}
+
+/* Distinct trigram buckets of text, sorted */
+static void TrigramBuckets(std::string_view text, std::vector<uint32_t>& out)
+{
+    out.clear();
+    for (size_t i = 0; (i + 2) < text.size(); i++)
+    {
+        out.push_back(TrigramBucket(text.data() + i));
+    }
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+}
+
+static std::string ToLower(const std::string& text)
+{
+    std::string lower(text);
+    for (char& c : lower)
+    {
+        c = static_cast<char>(LowerAscii(c));
+    }
+    return lower;
+}
+
+void FileBin_SymbolIndex::Clear()
+{
+    this->Entry.clear();
+    this->PathData.clear();
+    this->PathOffset.clear();
+    this->Sorted.clear();
+    this->Trie.clear();
+    this->TrigramOffset.clear();
+    this->TrigramPosting.clear();
+}
+
+uint32_t FileBin_SymbolIndex::Size() const
+{
+    return static_cast<uint32_t>(this->Entry.size());
+}
+
+std::string_view FileBin_SymbolIndex::GetPath(uint32_t Id) const
+{
+    return std::string_view(this->PathData.data() + this->PathOffset[Id], this->PathOffset[Id + 1] - this->PathOffset[Id]);
+}
+
+const FileBin_SymbolIndex_EntryType& FileBin_SymbolIndex::GetEntry(uint32_t Id) const
+{
+    return this->Entry[Id];
+}
+
+void FileBin_SymbolIndex::Build(FileBin_DWARF* dwarf)
+{
+    this->Clear();
+
+    uint32_t cuCnt = dwarf->GetCUCount();
+    std::vector<FileBin_SymbolIndex_PartType> part(cuCnt);
+
+    FileBin_ThreadPool::Shared().ParallelFor(cuCnt, 1, [&](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t idx = begin; idx < end; idx++)
+        {
+            FileBin_DWARF_VarInfoType* cu = dwarf->AcquireCU(idx);
+            if (cu != nullptr)
+            {
+                std::string name = SymbolIndexCUName(cu);
+                SymbolIndexWalk(part[idx], idx, cu->child, 0, 0, FILEBIN_SYMBOLINDEX_NO_PARENT, name, '/');
+            }
+            dwarf->ReleaseCU(idx);
+        }
+    });
+
+    size_t entryCnt = 0;
+    size_t pathBytes = 0;
+    for (const auto& p : part)
+    {
+        entryCnt += p.Entry.size();
+        pathBytes += p.PathData.size();
+    }
+
+    this->Entry.reserve(entryCnt);
+    this->PathData.reserve(pathBytes);
+    this->PathOffset.reserve(entryCnt + 1);
+    this->PathOffset.push_back(0);
+
+    for (auto& p : part)
+    {
+        uint32_t base = static_cast<uint32_t>(this->PathData.size());
+        uint32_t idBase = static_cast<uint32_t>(this->Entry.size());
+        for (auto& e : p.Entry)
+        {
+            if (e.Parent != FILEBIN_SYMBOLINDEX_NO_PARENT)
+            {
+                e.Parent += idBase;
+            }
+        }
+        this->Entry.insert(this->Entry.end(), p.Entry.begin(), p.Entry.end());
+        this->PathData += p.PathData;
+        for (uint32_t e : p.PathEnd)
+        {
+            this->PathOffset.push_back(base + e);
+        }
+        p = FileBin_SymbolIndex_PartType();
+    }
+
+    this->BuildSort();
+
+    this->Trie.emplace_back();
+    this->Trie[0] = {0, 0, 0, 0, 0, 0, this->Size()};
+    if (this->Size() > 0)
+    {
+        this->BuildTrie(0, this->Size(), 0, 0);
+    }
+
+    this->BuildTrigram();
+}
+
+/* Chunks are sorted in parallel then merged pairwise */
+void FileBin_SymbolIndex::BuildSort()
+{
+    uint32_t n = this->Size();
+    this->Sorted.resize(n);
+    std::iota(this->Sorted.begin(), this->Sorted.end(), 0);
+
+    auto less = [this](uint32_t a, uint32_t b)
+    {
+        std::string_view pa = this->GetPath(a);
+        std::string_view pb = this->GetPath(b);
+        int cmp = pa.compare(pb);
+        return (cmp < 0) || ((cmp == 0) && (a < b));
+    };
+
+    uint32_t chunkCnt = (n + LIBPARSER_SYMBOLINDEX_CHUNK - 1) / LIBPARSER_SYMBOLINDEX_CHUNK;
+    FileBin_ThreadPool::Shared().ParallelFor(chunkCnt, 1, [&](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t c = begin; c < end; c++)
+        {
+            auto first = this->Sorted.begin() + c * LIBPARSER_SYMBOLINDEX_CHUNK;
+            auto last = this->Sorted.begin() + std::min<uint32_t>(n, (c + 1) * LIBPARSER_SYMBOLINDEX_CHUNK);
+            std::sort(first, last, less);
+        }
+    });
+
+    for (uint64_t width = LIBPARSER_SYMBOLINDEX_CHUNK; width < n; width *= 2)
+    {
+        uint32_t pairCnt = static_cast<uint32_t>((n + 2 * width - 1) / (2 * width));
+        FileBin_ThreadPool::Shared().ParallelFor(pairCnt, 1, [&](uint32_t begin, uint32_t end)
+        {
+            for (uint32_t p = begin; p < end; p++)
+            {
+                uint64_t lo = p * 2 * width;
+                uint64_t mid = std::min<uint64_t>(n, lo + width);
+                uint64_t hi = std::min<uint64_t>(n, lo + 2 * width);
+                std::inplace_merge(this->Sorted.begin() + lo, this->Sorted.begin() + mid, this->Sorted.begin() + hi, less);
+            }
+        });
+    }
+}
+
+/* Node NodeIdx covers Sorted[Begin, End), all of them share their first Depth characters */
+void FileBin_SymbolIndex::BuildTrie(uint32_t Begin, uint32_t End, uint32_t Depth, uint32_t NodeIdx)
+{
+    /* Paths ending at Depth sort first and stay on this node */
+    uint32_t first = Begin;
+    while ((first < End) && (this->GetPath(this->Sorted[first]).size() == Depth))
+    {
+        first++;
+    }
+
+    /* One child per distinct character at Depth */
+    std::vector<uint32_t> groupBegin;
+    for (uint32_t i = first; i < End; i++)
+    {
+        if ((i == first) || (this->GetPath(this->Sorted[i])[Depth] != this->GetPath(this->Sorted[i - 1])[Depth]))
+        {
+            groupBegin.push_back(i);
+        }
+    }
+    groupBegin.push_back(End);
+
+    uint32_t childCnt = static_cast<uint32_t>(groupBegin.size() - 1);
+    uint32_t firstChild = static_cast<uint32_t>(this->Trie.size());
+    this->Trie.resize(this->Trie.size() + childCnt);
+    this->Trie[NodeIdx].FirstChild = firstChild;
+    this->Trie[NodeIdx].ChildCnt = childCnt;
+
+    for (uint32_t g = 0; g < childCnt; g++)
+    {
+        uint32_t gb = groupBegin[g];
+        uint32_t ge = groupBegin[g + 1];
+
+        /* Sorted range, the common prefix of the group is the one of its first and last path */
+        std::string_view pFirst = this->GetPath(this->Sorted[gb]);
+        std::string_view pLast = this->GetPath(this->Sorted[ge - 1]);
+        uint32_t lcp = Depth + 1;
+        while ((lcp < pFirst.size()) && (lcp < pLast.size()) && (pFirst[lcp] == pLast[lcp]))
+        {
+            lcp++;
+        }
+
+        this->Trie[firstChild + g] = {this->Sorted[gb], Depth, lcp - Depth, 0, 0, gb, ge};
+        this->BuildTrie(gb, ge, lcp, firstChild + g);
+    }
+}
+
+/* Posting lists are filled chunk by chunk in entry order, so every list comes out sorted */
+void FileBin_SymbolIndex::BuildTrigram()
+{
+    uint32_t n = this->Size();
+    uint32_t chunkCnt = std::min<uint32_t>((n + LIBPARSER_SYMBOLINDEX_CHUNK - 1) / LIBPARSER_SYMBOLINDEX_CHUNK, (FileBin_ThreadPool::Shared().Size() + 1) * 4);
+    uint32_t chunkLen = (chunkCnt > 0) ? ((n + chunkCnt - 1) / chunkCnt) : 0;
+    std::vector<uint32_t> count(static_cast<size_t>(chunkCnt) * LIBPARSER_SYMBOLINDEX_TRIGRAM_BUCKETS, 0);
+
+    /* Calls fn(id, bucket) once per distinct bucket of every entry in the chunk */
+    auto forEachTrigram = [this, n, chunkLen](uint32_t c, std::vector<uint32_t>& stamp, auto&& fn)
+    {
+        uint32_t last = std::min<uint32_t>(n, (c + 1) * chunkLen);
+        for (uint32_t id = c * chunkLen; id < last; id++)
+        {
+            std::string_view path = this->GetPath(id);
+            for (size_t i = 0; (i + 2) < path.size(); i++)
+            {
+                uint32_t b = TrigramBucket(path.data() + i);
+                if (stamp[b] != (id + 1))
+                {
+                    stamp[b] = id + 1;
+                    fn(id, b);
+                }
+            }
+        }
+    };
+
+    FileBin_ThreadPool::Shared().ParallelFor(chunkCnt, 1, [&](uint32_t begin, uint32_t end)
+    {
+        std::vector<uint32_t> stamp(LIBPARSER_SYMBOLINDEX_TRIGRAM_BUCKETS, 0);
+        for (uint32_t c = begin; c < end; c++)
+        {
+            uint32_t* cnt = count.data() + static_cast<size_t>(c) * LIBPARSER_SYMBOLINDEX_TRIGRAM_BUCKETS;
+            forEachTrigram(c, stamp, [cnt](uint32_t, uint32_t b) { cnt[b]++; });
+        }
+    });
+
+    /* Turn the counts into write positions: bucket major, chunk minor */
+    this->TrigramOffset.assign(LIBPARSER_SYMBOLINDEX_TRIGRAM_BUCKETS + 1, 0);
+    uint32_t pos = 0;
+    for (uint32_t b = 0; b < LIBPARSER_SYMBOLINDEX_TRIGRAM_BUCKETS; b++)
+    {
+        this->TrigramOffset[b] = pos;
+        for (uint32_t c = 0; c < chunkCnt; c++)
+        {
+            uint32_t& cnt = count[static_cast<size_t>(c) * LIBPARSER_SYMBOLINDEX_TRIGRAM_BUCKETS + b];
+            uint32_t tmp = cnt;
+            cnt = pos;
+            pos += tmp;
+        }
+    }
+    this->TrigramOffset[LIBPARSER_SYMBOLINDEX_TRIGRAM_BUCKETS] = pos;
+    this->TrigramPosting.resize(pos);
+
+    FileBin_ThreadPool::Shared().ParallelFor(chunkCnt, 1, [&](uint32_t begin, uint32_t end)
+    {
+        std::vector<uint32_t> stamp(LIBPARSER_SYMBOLINDEX_TRIGRAM_BUCKETS, 0);
+        for (uint32_t c = begin; c < end; c++)
+        {
+            uint32_t* wr = count.data() + static_cast<size_t>(c) * LIBPARSER_SYMBOLINDEX_TRIGRAM_BUCKETS;
+            forEachTrigram(c, stamp, [this, wr](uint32_t id, uint32_t b) { this->TrigramPosting[wr[b]++] = id; });
+        }
+    });
+}
+
+std::vector<uint32_t> FileBin_SymbolIndex::FindPrefix(const std::string& Prefix, uint32_t MaxResults) const
+{
+    std::vector<uint32_t> result;
+    if (this->Trie.empty())
+    {
+        return result;
+    }
+
+    uint32_t nodeIdx = 0;
+    uint32_t depth = 0;
+    while (depth < Prefix.size())
+    {
+        const FileBin_SymbolIndex_TrieNodeType& node = this->Trie[nodeIdx];
+        unsigned char c = static_cast<unsigned char>(Prefix[depth]);
+
+        /* Children are in character order */
+        auto first = this->Trie.begin() + node.FirstChild;
+        auto last = first + node.ChildCnt;
+        auto child = std::lower_bound(first, last, c, [this](const FileBin_SymbolIndex_TrieNodeType& t, unsigned char ch)
+        {
+            return static_cast<unsigned char>(this->GetPath(t.LabelEntry)[t.LabelBegin]) < ch;
+        });
+        if ((child == last) || (static_cast<unsigned char>(this->GetPath(child->LabelEntry)[child->LabelBegin]) != c))
+        {
+            return result;
+        }
+
+        std::string_view label = this->GetPath(child->LabelEntry).substr(child->LabelBegin, child->LabelLen);
+        size_t cmpLen = std::min<size_t>(label.size(), Prefix.size() - depth);
+        if (label.compare(0, cmpLen, Prefix, depth, cmpLen) != 0)
+        {
+            return result;
+        }
+
+        depth += static_cast<uint32_t>(cmpLen);
+        nodeIdx = static_cast<uint32_t>(child - this->Trie.begin());
+    }
+
+    const FileBin_SymbolIndex_TrieNodeType& match = this->Trie[nodeIdx];
+    uint32_t end = std::min(match.EntryEnd, match.EntryBegin + MaxResults);
+    result.assign(this->Sorted.begin() + match.EntryBegin, this->Sorted.begin() + end);
+    return result;
+}
+
+bool FileBin_SymbolIndex::Contains(uint32_t Id, const std::string& LowerText) const
+{
+    std::string_view path = this->GetPath(Id);
+    auto it = std::search(path.begin(), path.end(), LowerText.begin(), LowerText.end(), [](char a, char b)
+    {
+        return static_cast<char>(LowerAscii(a)) == b;
+    });
+    return it != path.end();
+}
+
+std::vector<uint32_t> FileBin_SymbolIndex::FindSubstring(const std::string& Text, uint32_t MaxResults) const
+{
+    std::vector<uint32_t> result;
+    std::string lower = ToLower(Text);
+
+    if (lower.size() < 3)
+    {
+        /* No trigram to look up, plain scan */
+        for (uint32_t id = 0; (id < this->Size()) && (result.size() < MaxResults); id++)
+        {
+            if (this->Contains(id, lower))
+            {
+                result.push_back(id);
+            }
+        }
+        return result;
+    }
+
+    if (this->TrigramOffset.empty())
+    {
+        return result;
+    }
+
+    std::vector<uint32_t> tri;
+    TrigramBuckets(lower, tri);
+    this->SortByPostingLen(tri);
+
+    /* Walk the shortest posting list, the others are probed through cursors that only move forward */
+    std::vector<const uint32_t*> cursor(tri.size());
+    for (size_t t = 0; t < tri.size(); t++)
+    {
+        cursor[t] = this->TrigramPosting.data() + this->TrigramOffset[tri[t]];
+    }
+    const uint32_t* last = this->TrigramPosting.data() + this->TrigramOffset[tri[0] + 1];
+
+    for (const uint32_t* p = cursor[0]; (p < last) && (result.size() < MaxResults); p++)
+    {
+        uint32_t id = *p;
+        bool inAll = true;
+        for (size_t t = 1; t < tri.size(); t++)
+        {
+            const uint32_t* listEnd = this->TrigramPosting.data() + this->TrigramOffset[tri[t] + 1];
+            cursor[t] = std::lower_bound(cursor[t], listEnd, id);
+            if (cursor[t] == listEnd)
+            {
+                return result;
+            }
+            if (*cursor[t] != id)
+            {
+                inAll = false;
+                break;
+            }
+        }
+
+        /* Buckets are hashed and trigrams are unordered, candidates still need a real match */
+        if (inAll && this->Contains(id, lower))
+        {
+            result.push_back(id);
+        }
+    }
+    return result;
+}
+
+std::vector<uint32_t> FileBin_SymbolIndex::FindFuzzy(const std::string& Text, uint32_t MaxResults) const
+{
+    std::vector<uint32_t> result;
+    if (Text.size() < 3)
+    {
+        return this->FindSubstring(Text, MaxResults);
+    }
+    if (this->TrigramOffset.empty())
+    {
+        return result;
+    }
+
+    std::vector<uint32_t> tri;
+    TrigramBuckets(Text, tri);
+    this->SortByPostingLen(tri);
+
+    /* Trigrams found in most paths (CU names, common prefixes) do not tell entries apart, skip them */
+    uint32_t common = std::max<uint32_t>(this->Size() / LIBPARSER_SYMBOLINDEX_FUZZY_COMMON, 1);
+    size_t used = 1;
+    while ((used < tri.size()) && (this->PostingLen(tri[used]) <= common))
+    {
+        used++;
+    }
+    tri.resize(used);
+    uint32_t threshold = std::min<uint32_t>(static_cast<uint32_t>((tri.size() + 1) / 2), 255);
+
+    std::vector<uint8_t> hits(this->Size(), 0);
+    std::vector<uint32_t> cand;
+    for (uint32_t b : tri)
+    {
+        for (uint32_t p = this->TrigramOffset[b]; p < this->TrigramOffset[b + 1]; p++)
+        {
+            uint32_t id = this->TrigramPosting[p];
+            if ((hits[id] < 255) && (++hits[id] == threshold))
+            {
+                cand.push_back(id);
+            }
+        }
+    }
+
+    /* Most shared trigrams first, then the shortest (closest) path */
+    auto better = [this, &hits](uint32_t a, uint32_t b)
+    {
+        if (hits[a] != hits[b])
+        {
+            return hits[a] > hits[b];
+        }
+        size_t la = this->GetPath(a).size();
+        size_t lb = this->GetPath(b).size();
+        return (la != lb) ? (la < lb) : (a < b);
+    };
+
+    size_t keep = std::min<size_t>(cand.size(), MaxResults);
+    std::partial_sort(cand.begin(), cand.begin() + keep, cand.end(), better);
+    cand.resize(keep);
+    return cand;
+}
+
+uint32_t FileBin_SymbolIndex::PostingLen(uint32_t Bucket) const
+{
+    return this->TrigramOffset[Bucket + 1] - this->TrigramOffset[Bucket];
+}
+
+void FileBin_SymbolIndex::SortByPostingLen(std::vector<uint32_t>& Buckets) const
+{
+    std::sort(Buckets.begin(), Buckets.end(), [this](uint32_t a, uint32_t b)
+    {
+        return this->PostingLen(a) < this->PostingLen(b);
+    });
+}
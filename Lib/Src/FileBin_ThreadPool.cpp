@@ -0,0 +1,331 @@
+/**
+ *  \file       FileBin_ThreadPool.cpp
+ *  \brief      Work-stealing thread pool
+ *
+ *  \version    1.0
+ *  \date       Oct 18, 2026
+ *  \author     Xavier Descarrega - DEVE embedded designs <info@deve.tech>
+ *
+ *  \copyright  MIT License
+ *
+ *              Copyright (c) 2026 Xavier Descarrega
+ *
+ *              Permission is hereby granted, free of charge, to any person obtaining a copy
+ *              of this software and associated documentation files (the "Software"), to deal
+ *              in the Software without restriction, including without limitation the rights
+ *              to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *              copies of the Software, and to permit persons to whom the Software is
+ *              furnished to do so, subject to the following conditions:
+ *
+ *              The above copyright notice and this permission notice shall be included in all
+ *              copies or substantial portions of the Software.
+ *
+ *              THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *              IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *              FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *              AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ *              LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *              OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *              SOFTWARE.
+ *
+ */
+
+#include "FileBin_ThreadPool.h"
+#include "FileBin_Trace.h"
+#include <algorithm>
+#include <exception>
+
+struct FileBin_ThreadPool_JobType
+{
+    const std::function<void(uint32_t, uint32_t)>* Fn;
+    uint32_t Grain;
+    std::atomic<uint32_t> Remaining; /* Indices not processed yet, the job is done at 0 */
+    std::mutex ErrorLock;
+    std::exception_ptr Error;
+};
+
+/* Pool and deque index of the current thread, lets nested ParallelFor calls push to their own deque */
+static thread_local FileBin_ThreadPool* CurrentPool = nullptr;
+static thread_local uint32_t CurrentIdx = 0;
+static thread_local uint32_t StealSeed = 0;
+
+FileBin_ThreadPool_Deque::FileBin_ThreadPool_Deque() : Top(0), Bottom(0)
+{
+    for (int64_t i = 0; i < Capacity; i++)
+    {
+        this->Buffer[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+bool FileBin_ThreadPool_Deque::Push(FileBin_ThreadPool_TaskType* task)
+{
+    int64_t b = this->Bottom.load(std::memory_order_relaxed);
+    int64_t t = this->Top.load(std::memory_order_acquire);
+
+    if ((b - t) >= Capacity)
+    {
+        return false;
+    }
+
+    this->Buffer[b & (Capacity - 1)].store(task, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    this->Bottom.store(b + 1, std::memory_order_relaxed);
+
+    return true;
+}
+
+FileBin_ThreadPool_TaskType* FileBin_ThreadPool_Deque::Pop()
+{
+    int64_t b = this->Bottom.load(std::memory_order_relaxed) - 1;
+    this->Bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = this->Top.load(std::memory_order_relaxed);
+
+    if (t > b)
+    {
+        /* Empty */
+        this->Bottom.store(b + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    FileBin_ThreadPool_TaskType* task = this->Buffer[b & (Capacity - 1)].load(std::memory_order_relaxed);
+
+    if (t == b)
+    {
+        /* Last entry, race against thieves for it */
+        if (!this->Top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+            task = nullptr;
+        }
+        this->Bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    return task;
+}
+
+FileBin_ThreadPool_TaskType* FileBin_ThreadPool_Deque::Steal()
+{
+    int64_t t = this->Top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t b = this->Bottom.load(std::memory_order_acquire);
+
+    if (t >= b)
+    {
+        return nullptr;
+    }
+
+    FileBin_ThreadPool_TaskType* task = this->Buffer[t & (Capacity - 1)].load(std::memory_order_relaxed);
+
+    if (!this->Top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+    {
+        return nullptr;
+    }
+
+    return task;
+}
+
+FileBin_ThreadPool::FileBin_ThreadPool(uint32_t ThreadCnt) : Pending(0), Sleeping(0), Stop(false)
+{
+    for (uint32_t i = 0; i < ThreadCnt; i++)
+    {
+        this->WorkerQueue.push_back(new FileBin_ThreadPool_Deque());
+    }
+
+    /* Queues must all exist before any worker starts stealing */
+    for (uint32_t i = 0; i < ThreadCnt; i++)
+    {
+        this->Worker.emplace_back(&FileBin_ThreadPool::WorkerLoop, this, i);
+    }
+}
+
+FileBin_ThreadPool::~FileBin_ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(this->SleepLock);
+        this->Stop.store(true);
+    }
+    this->SleepCond.notify_all();
+
+    for (auto& th : this->Worker)
+    {
+        th.join();
+    }
+
+    for (auto* queue : this->WorkerQueue)
+    {
+        delete queue;
+    }
+
+    for (auto* task : this->Inject)
+    {
+        delete task;
+    }
+}
+
+uint32_t FileBin_ThreadPool::Size() const
+{
+    return static_cast<uint32_t>(this->Worker.size());
+}
+
+FileBin_ThreadPool& FileBin_ThreadPool::Shared()
+{
+    /* The thread calling ParallelFor takes part in the work, hence one worker less */
+    static FileBin_ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+    return pool;
+}
+
+void FileBin_ThreadPool::Submit(FileBin_ThreadPool_TaskType* task)
+{
+    this->Pending.fetch_add(1);
+
+    if ((CurrentPool != this) || (!this->WorkerQueue[CurrentIdx]->Push(task)))
+    {
+        std::lock_guard<std::mutex> lock(this->InjectLock);
+        this->Inject.push_back(task);
+    }
+
+    if (this->Sleeping.load() > 0)
+    {
+        std::lock_guard<std::mutex> lock(this->SleepLock);
+        this->SleepCond.notify_one();
+    }
+}
+
+FileBin_ThreadPool_TaskType* FileBin_ThreadPool::Acquire()
+{
+    FileBin_ThreadPool_TaskType* task = nullptr;
+    uint32_t queueCnt = static_cast<uint32_t>(this->WorkerQueue.size());
+
+    if (CurrentPool == this)
+    {
+        task = this->WorkerQueue[CurrentIdx]->Pop();
+    }
+
+    if ((!task) && (this->Pending.load() > 0))
+    {
+        std::lock_guard<std::mutex> lock(this->InjectLock);
+        if (!this->Inject.empty())
+        {
+            task = this->Inject.front();
+            this->Inject.pop_front();
+        }
+    }
+
+    for (uint32_t i = 0; (!task) && (i < queueCnt); i++)
+    {
+        task = this->WorkerQueue[(StealSeed + i) % queueCnt]->Steal();
+    }
+
+    if (task)
+    {
+        this->Pending.fetch_sub(1);
+    }
+    else
+    {
+        StealSeed++;
+    }
+
+    return task;
+}
+
+void FileBin_ThreadPool::Run(FileBin_ThreadPool_TaskType* task)
+{
+    FileBin_ThreadPool_JobType* job = task->Job;
+
+    /* Keep the left half, expose the right one to thieves */
+    while ((task->End - task->Begin) > job->Grain)
+    {
+        uint32_t mid = task->Begin + (task->End - task->Begin) / 2;
+        this->Submit(new FileBin_ThreadPool_TaskType{job, mid, task->End});
+        task->End = mid;
+    }
+
+    try
+    {
+        FILEBIN_TRACE_SCOPE_ARG("pool.task", task->Begin);
+        (*job->Fn)(task->Begin, task->End);
+    }
+    catch (...)
+    {
+        std::lock_guard<std::mutex> lock(job->ErrorLock);
+        if (!job->Error)
+        {
+            job->Error = std::current_exception();
+        }
+    }
+
+    job->Remaining.fetch_sub(task->End - task->Begin, std::memory_order_acq_rel);
+    delete task;
+}
+
+void FileBin_ThreadPool::WorkerLoop(uint32_t Idx)
+{
+    CurrentPool = this;
+    CurrentIdx = Idx;
+    StealSeed = Idx + 1;
+
+    FILEBIN_TRACE_THREAD_NAME("pool worker " + std::to_string(Idx));
+
+    while (!this->Stop.load())
+    {
+        FileBin_ThreadPool_TaskType* task = this->Acquire();
+
+        if (task)
+        {
+            this->Run(task);
+            continue;
+        }
+
+        FILEBIN_TRACE_SCOPE("pool.idle");
+        std::unique_lock<std::mutex> lock(this->SleepLock);
+        this->Sleeping.fetch_add(1);
+        this->SleepCond.wait(lock, [this] { return this->Stop.load() || (this->Pending.load() > 0); });
+        this->Sleeping.fetch_sub(1);
+    }
+}
+
+void FileBin_ThreadPool::ParallelFor(uint32_t Count, uint32_t Grain, const std::function<void(uint32_t, uint32_t)>& fn)
+{
+    if (Count == 0)
+    {
+        return;
+    }
+
+    if (Grain == 0)
+    {
+        Grain = 1;
+    }
+
+    if ((Count <= Grain) || this->Worker.empty())
+    {
+        fn(0, Count);
+        return;
+    }
+
+    FileBin_ThreadPool_JobType job;
+    job.Fn = &fn;
+    job.Grain = Grain;
+    job.Remaining.store(Count);
+
+    this->Run(new FileBin_ThreadPool_TaskType{&job, 0, Count});
+
+    /* Help with any pending work (this job or others) instead of blocking */
+    while (job.Remaining.load(std::memory_order_acquire) != 0)
+    {
+        FileBin_ThreadPool_TaskType* task = this->Acquire();
+
+        if (task)
+        {
+            this->Run(task);
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    if (job.Error)
+    {
+        std::rethrow_exception(job.Error);
+    }
+}
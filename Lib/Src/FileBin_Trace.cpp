@@ -0,0 +1,182 @@
+/**
+ *  \file       FileBin_Trace.cpp
+ *  \brief      Per-thread trace events exported as Chrome trace JSON
+ *
+ *  \version    1.0
+ *  \date       Oct 18, 2026
+ *  \author     Xavier Descarrega - DEVE embedded designs <info@deve.tech>
+ *
+ *  \copyright  MIT License
+ *
+ *              Copyright (c) 2026 Xavier Descarrega
+ *
+ *              Permission is hereby granted, free of charge, to any person obtaining a copy
+ *              of this software and associated documentation files (the "Software"), to deal
+ *              in the Software without restriction, including without limitation the rights
+ *              to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *              copies of the Software, and to permit persons to whom the Software is
+ *              furnished to do so, subject to the following conditions:
+ *
+ *              The above copyright notice and this permission notice shall be included in all
+ *              copies or substantial portions of the Software.
+ *
+ *              THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *              IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *              FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *              AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ *              LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *              OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *              SOFTWARE.
+ *
+ */
+
+#include "FileBin_Trace.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+static_assert((LIBPARSER_TRACE_RING_EVENTS & (LIBPARSER_TRACE_RING_EVENTS - 1)) == 0, "Trace ring size must be a power of two");
+
+typedef struct
+{
+    std::vector<FileBin_Trace_EventType> Event;
+    std::atomic<uint64_t> Head{0}; /* Events ever written, only the owner thread stores it */
+    std::string ThreadName;
+    uint32_t ThreadId;
+} FileBin_Trace_RingType;
+
+/* Buffers outlive their threads so that pool workers which exit still show up in the export */
+static std::mutex TraceLock;
+static std::vector<std::unique_ptr<FileBin_Trace_RingType>> TraceRing;
+static std::atomic<uint64_t> TraceSinceNs{0};
+static thread_local FileBin_Trace_RingType* TraceLocal = nullptr;
+
+static const std::chrono::steady_clock::time_point TraceEpoch = std::chrono::steady_clock::now();
+
+static FileBin_Trace_RingType* TraceLocalRing()
+{
+    if (TraceLocal == nullptr)
+    {
+        std::unique_ptr<FileBin_Trace_RingType> ring(new FileBin_Trace_RingType());
+        ring->Event.resize(LIBPARSER_TRACE_RING_EVENTS);
+
+        std::lock_guard<std::mutex> lock(TraceLock);
+        ring->ThreadId = static_cast<uint32_t>(TraceRing.size()) + 1;
+        ring->ThreadName = "thread " + std::to_string(ring->ThreadId);
+        TraceLocal = ring.get();
+        TraceRing.push_back(std::move(ring));
+    }
+
+    return TraceLocal;
+}
+
+static std::string TraceJSONEscape(const std::string& Text)
+{
+    std::string out;
+    for (char c : Text)
+    {
+        if ((c == '"') || (c == '\\'))
+        {
+            out += '\\';
+            out += c;
+        }
+        else if (static_cast<unsigned char>(c) >= 0x20)
+        {
+            out += c;
+        }
+    }
+    return out;
+}
+
+uint64_t FileBin_Trace::Now()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - TraceEpoch).count());
+}
+
+void FileBin_Trace::Record(const char* Name, uint64_t BeginNs, uint64_t EndNs, uint64_t Arg)
+{
+    FileBin_Trace_RingType* ring = TraceLocalRing();
+    uint64_t head = ring->Head.load(std::memory_order_relaxed);
+
+    ring->Event[head & (LIBPARSER_TRACE_RING_EVENTS - 1)] = {Name, BeginNs, EndNs - BeginNs, Arg};
+    ring->Head.store(head + 1, std::memory_order_release);
+}
+
+void FileBin_Trace::SetThreadName(const std::string& Name)
+{
+    FileBin_Trace_RingType* ring = TraceLocalRing();
+
+    std::lock_guard<std::mutex> lock(TraceLock);
+    ring->ThreadName = Name;
+}
+
+void FileBin_Trace::Clear()
+{
+    TraceSinceNs.store(Now());
+}
+
+std::string FileBin_Trace::ToJSON()
+{
+    std::lock_guard<std::mutex> lock(TraceLock);
+
+    uint64_t since = TraceSinceNs.load();
+    uint64_t dropped = 0;
+    bool first = true;
+    char buf[64];
+
+    std::ostringstream out;
+    out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+
+    for (const auto& ring : TraceRing)
+    {
+        out << (first ? "\n" : ",\n");
+        out << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << ring->ThreadId
+            << ", \"args\": {\"name\": \"" << TraceJSONEscape(ring->ThreadName) << "\"}}";
+        first = false;
+
+        uint64_t head = ring->Head.load(std::memory_order_acquire);
+        uint64_t begin = (head > LIBPARSER_TRACE_RING_EVENTS) ? (head - LIBPARSER_TRACE_RING_EVENTS) : 0;
+        dropped += begin;
+
+        for (uint64_t i = begin; i < head; i++)
+        {
+            const FileBin_Trace_EventType& event = ring->Event[i & (LIBPARSER_TRACE_RING_EVENTS - 1)];
+
+            if (event.BeginNs < since)
+            {
+                continue;
+            }
+
+            /* Timestamps are in microseconds, keep the nanoseconds as decimals */
+            std::snprintf(buf, sizeof(buf), "%llu.%03llu", static_cast<unsigned long long>(event.BeginNs / 1000u),
+                          static_cast<unsigned long long>(event.BeginNs % 1000u));
+            out << ",\n{\"name\": \"" << TraceJSONEscape(event.Name) << "\", \"cat\": \"fynix\", \"ph\": \"X\", \"pid\": 1, \"tid\": "
+                << ring->ThreadId << ", \"ts\": " << buf;
+            std::snprintf(buf, sizeof(buf), "%llu.%03llu", static_cast<unsigned long long>(event.DurationNs / 1000u),
+                          static_cast<unsigned long long>(event.DurationNs % 1000u));
+            out << ", \"dur\": " << buf << ", \"args\": {\"arg\": " << event.Arg << "}}";
+        }
+    }
+
+    out << "\n], \"otherData\": {\"dropped_events\": " << dropped << "}}\n";
+
+    return out.str();
+}
+
+bool FileBin_Trace::WriteJSON(const std::string& FileName)
+{
+    std::ofstream out(FileName);
+
+    if (!out)
+    {
+        return false;
+    }
+
+    out << ToJSON();
+    return static_cast<bool>(out);
+}
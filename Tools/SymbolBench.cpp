@@ -0,0 +1,113 @@
+/**
+ *  \file       SymbolBench.cpp
+ *  \brief      Symbol resolution regression benchmark (see gen_symbol_bench.py)
+ *
+ *  \version    1.0
+ *  \date       Oct 18, 2026
+ *  \author     Xavier Descarrega - DEVE embedded designs <info@deve.tech>
+ *
+ *  \copyright  MIT License
+ *
+ *              Copyright (c) 2026 Xavier Descarrega
+ *
+ *              Permission is hereby granted, free of charge, to any person obtaining a copy
+ *              of this software and associated documentation files (the "Software"), to deal
+ *              in the Software without restriction, including without limitation the rights
+ *              to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *              copies of the Software, and to permit persons to whom the Software is
+ *              furnished to do so, subject to the following conditions:
+ *
+ *              The above copyright notice and this permission notice shall be included in all
+ *              copies or substantial portions of the Software.
+ *
+ *              THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *              IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *              FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *              AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER
+ *              LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *              OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *              SOFTWARE.
+ *
+ */
+
+#include "FileBin_ELF.h"
+#include "FileBin_DWARF.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+/* Symbol nodes under node and the longest child list among them */
+static void SymbolBenchCount(const FileBin_DWARF_VarInfoType* node, uint64_t& nodeCnt, uint64_t& widest)
+{
+    for (; node; node = node->next)
+    {
+        uint64_t childCnt = 0;
+        for (const FileBin_DWARF_VarInfoType* c = node->child; c; c = c->next)
+        {
+            childCnt++;
+        }
+        nodeCnt++;
+        widest = std::max(widest, childCnt);
+        SymbolBenchCount(node->child, nodeCnt, widest);
+    }
+}
+
+/*
+ * Usage: FynixSymbolBench <elf> [runs] [max_ms]
+ * Parses the ELF runs times and reports the best DWARF parse time. Exits with 1 if the best run is
+ * slower than max_ms, a quadratic child append takes tens of seconds on the default synthetic CU.
+ */
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " <elf> [runs] [max_ms]" << std::endl;
+        return 2;
+    }
+
+    uint32_t runs = (argc > 2) ? static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10)) : 3;
+    double maxMs = (argc > 3) ? std::strtod(argv[3], nullptr) : 0.0;
+    double bestMs = 0.0;
+    uint64_t nodeCnt = 0;
+    uint64_t widest = 0;
+
+    FileBin_ELF elf;
+    if (elf.Parse(argv[1]) != 0)
+    {
+        std::cerr << "Cannot parse " << argv[1] << std::endl;
+        return 2;
+    }
+
+    for (uint32_t r = 0; r < std::max(runs, 1u); r++)
+    {
+        FileBin_DWARF dwarf;
+        dwarf.SetSymbolTable(elf.GetObjectSymbols());
+
+        auto start = std::chrono::steady_clock::now();
+        uint8_t result = dwarf.Parse(argv[1], elf.GetAbbrevOffset(), elf.GetAbbrevLen(), elf.GetInfoOffset(), elf.GetInfoLen(), elf.GetStrOffset());
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        if (result != 0)
+        {
+            std::cerr << "DWARF parse failed (" << static_cast<int>(result) << ")" << std::endl;
+            return 2;
+        }
+
+        nodeCnt = 0;
+        widest = 0;
+        SymbolBenchCount(dwarf.SymbolRoot, nodeCnt, widest);
+        bestMs = (0 == r) ? ms : std::min(bestMs, ms);
+        std::cout << "run " << r << ": " << ms << " ms" << std::endl;
+    }
+
+    std::cout << "symbols " << nodeCnt << ", widest child list " << widest << ", best " << bestMs << " ms" << std::endl;
+
+    if ((maxMs > 0.0) && (bestMs > maxMs))
+    {
+        std::cerr << "Slower than " << maxMs << " ms" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,38 @@
+#!/usr/bin/env python3
+#
+#  \file       gen_symbol_bench.py
+#  \brief      Writes the synthetic CU of the symbol resolution benchmark
+#
+#  One translation unit with a struct of 3,000 members and 50,000 struct globals, the shape of the
+#  generated parameter CUs that made symbol tree building quadratic. Build it with debug info for a
+#  32-bit target and pass the ELF to FynixSymbolBench, e.g.
+#
+#      python3 Tools/gen_symbol_bench.py SymbolBenchCU.c
+#      gcc -m32 -g -c SymbolBenchCU.c -o SymbolBenchCU.o
+#      ld -m elf_i386 -e main SymbolBenchCU.o -o SymbolBenchCU.elf
+#      FynixSymbolBench SymbolBenchCU.elf
+#
+
+import argparse
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Synthetic CU for FynixSymbolBench")
+    parser.add_argument("output", help="C source to write")
+    parser.add_argument("--globals", type=int, default=50000, help="struct globals in the CU")
+    parser.add_argument("--members", type=int, default=3000, help="members of the big struct")
+    args = parser.parse_args()
+
+    with open(args.output, "w") as f:
+        f.write("typedef struct { float a; unsigned short b[8]; } T_t;\n")
+        f.write("typedef struct { ")
+        f.write(" ".join("int m%d;" % i for i in range(args.members)))
+        f.write(" } Big_t;\n")
+        f.write("Big_t big;\n")
+        for i in range(args.globals):
+            f.write("T_t g%d;\n" % i)
+        f.write("int main(void){return 0;}\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -41,11 +41,15 @@
 #include <QLineEdit>
 #include <QStylePainter>
 #include <QFileDialog>
+#include <QInputDialog>
 #include <QColor>
 #include <QTreeWidget>
 #include <QScrollBar>
 #include <QEvent>
 #include <QRegularExpression>
+#include <algorithm>
+#include <iostream>
+#include "FileBin_Stats.h"
 
 #include "WidgetTreeTextBox.hpp"
 #include "WidgetTreeComboBox.hpp"
@@ -355,6 +359,9 @@ class ClickableHeader : public QHeaderView
         using BinFileCloseCallback = std::function<void(int section, int icon, string filename)>;
         IconClickedCallback onBinFileClose;
 
+        /* Save of the changed sectors only */
+        IconClickedCallback onDeltaSave;
+
         ClickableHeader(Qt::Orientation orientation, QWidget *parent = nullptr) : QHeaderView(orientation, parent)
         {
             parentT = (QTreeWidget *)parent;
@@ -535,15 +542,26 @@ class ClickableHeader : public QHeaderView
             case Icon_Save:
             {
                 qDebug() << "Save icon pressed on section" << section;
+                QString filter;
                 QString fname = QFileDialog::getSaveFileName(
                     this,
                     "Save calibrated binary",
                     ".",
-                    "Intel hex (*.hex)"
+                    "Intel hex (*.hex);;Motorola S-record (*.s19 *.s28 *.s37 *.srec *.mot);;"
+                    "Changed sectors, Intel hex (*.hex);;Changed sectors, Motorola S-record (*.s19 *.s28 *.s37 *.srec *.mot);;"
+                    "Changed sectors, binary patch (*.bin)",
+                    &filter
                     );
                 if (!fname.isEmpty())
                 {
-                    onIconClicked(section, static_cast<int>(icon), fname.toStdString());
+                    if (filter.startsWith("Changed sectors"))
+                    {
+                        onDeltaSave(section, static_cast<int>(icon), fname.toStdString());
+                    }
+                    else
+                    {
+                        onIconClicked(section, static_cast<int>(icon), fname.toStdString());
+                    }
                 }
                 event->accept();
                 return;
@@ -644,9 +662,10 @@ QTreeWidget  *m_treeWidget;   // Left: Hierarchy/Symbols
 QTreeWidget *m_symbolTree;
 
 
-BinCalibToolWidget::BinCalibToolWidget(QWidget *parent, FileBin_ELF *elf) : QWidget(parent)
+BinCalibToolWidget::BinCalibToolWidget(QWidget *parent, FileBin_ELF *elf, FileBin_DWARF *dwarf) : QWidget(parent)
 {
     this->ELFData = elf;
+    this->DWARFData = dwarf;
     this->BaseFileData.clear();
     IsViewAdvanced = false;
     //this->BaseFileCnt = 0;
@@ -696,6 +715,28 @@ BinCalibToolWidget::BinCalibToolWidget(QWidget *parent, FileBin_ELF *elf) : QWid
     actionViewAdvanced->setChecked(true);
     // m_toolBar->addSeparator();
 
+    // Symbol search, completions come from the symbol index and are refreshed on every edit
+    m_searchBox = new QLineEdit(this);
+    m_searchBox->setPlaceholderText("Search symbol...");
+    m_searchBox->setClearButtonEnabled(true);
+    m_searchBox->setMaximumWidth(320);
+    m_searchModel = new QStringListModel(this);
+    QCompleter* searchCompleter = new QCompleter(m_searchModel, this);
+    searchCompleter->setCompletionMode(QCompleter::UnfilteredPopupCompletion);
+    searchCompleter->setMaxVisibleItems(20);
+    m_searchBox->setCompleter(searchCompleter);
+    m_toolBar->addSeparator();
+    m_toolBar->addWidget(m_searchBox);
+
+    connect(m_searchBox, &QLineEdit::textEdited, this, &BinCalibToolWidget::onSymbolSearchEdited);
+    connect(searchCompleter, QOverload<const QString&>::of(&QCompleter::activated), this, &BinCalibToolWidget::onSymbolSearchActivated);
+    connect(m_searchBox, &QLineEdit::returnPressed, this, [this]()
+            {
+                // Enter without picking a completion jumps to the best match
+                if (m_searchModel->rowCount() > 0)
+                    this->onSymbolSearchActivated(m_searchModel->stringList().first());
+            });
+
     mainLayout->addWidget(m_toolBar);
 
     // 3. Splitter
@@ -739,6 +780,17 @@ BinCalibToolWidget::BinCalibToolWidget(QWidget *parent, FileBin_ELF *elf) : QWid
         this->BaseFileData.at(section-4)->mem->Save(filename);
     };
 
+    header->onDeltaSave = [this](int section, int icon, string filename){
+        qDebug() << "Delta save in section" << section << "icon" << icon;
+        FileBin_IntelHex_Memory *mem = this->BaseFileData.at(section-4)->mem;
+
+        /* Once exported, the next delta is relative to what the target now holds */
+        if (mem->SaveDelta(filename))
+        {
+            mem->ClearDirty();
+        }
+    };
+
     header->onBinFileClose = [this](int section, int icon, string filename){
         qDebug() << "Icon clicked in section" << section << "icon" << icon;
         //this->BaseFileData.at(section-4)->mem->Save(filename);
@@ -894,7 +946,7 @@ BinCalibToolWidget::BinCalibToolWidget(QWidget *parent, FileBin_ELF *elf) : QWid
                     this,
                     tr("Open File"),
                     QString(),                       // initial directory
-                    tr("ELF Files (*.elf);;Intel HEX Files (*.hex);;All Files (*)")            // filter
+                    tr("ELF Files (*.elf);;Intel HEX Files (*.hex);;S-record Files (*.s19 *.s28 *.s37 *.srec *.mot);;Binary Files (*.bin);;All Files (*)")            // filter
                     );
 
                 if (fileName.isEmpty())
@@ -913,11 +965,9 @@ BinCalibToolWidget::BinCalibToolWidget(QWidget *parent, FileBin_ELF *elf) : QWid
 
                     //IsMasterFileLoaded = true;
                 }
-                else if (extension == "hex")
+                else if (FileBin_IntelHex_Memory::TypeFromExtension(fileName.toStdString().c_str()) != LIB_FIRMWAREBIN__UNKNOWN)
                 {
-                    FileBin_IntelHex_Memory *newBaseFile = new FileBin_IntelHex_Memory();
-                    newBaseFile->Load(fileName.toStdString().c_str(), LIB_FIRMWAREBIN_HEX);
-                    this->Calib_BaseFile_AddNew(fileName.toStdString(), newBaseFile);
+                    this->Calib_BaseFile_Open(fileName);
                     //qDebug() << "Dropped image file:" << fileName;
                     ///if (!Mem2[this->BaseFileCnt].Load(filePath.toStdString().c_str(), LIB_FIRMWAREBIN_HEX))
                     //{
@@ -975,6 +1025,76 @@ QTreeWidgetItem* BinCalibToolWidget::copyItemWithoutColumn(QTreeWidgetItem* item
     return newItem;
 }
 
+/* Storage unit of a bitfield, little endian */
+static uint64_t BitFieldUnitRead(FileBin_IntelHex_Memory* mem, uint32_t Addr, const FileBin_DWARF_BitFieldType& bf)
+{
+    uint8_t unit[8] = {0};
+    mem->ReadArray<uint8_t>(Addr, bf.Bytes, unit);
+    return FileBin_DWARF_BitFieldLoad(unit, bf.Bytes);
+}
+
+/* Bytes read for a scalar widget, 0 for types without a value widget */
+static uint32_t DataTypeBytes(FileBin_DWARF_VarInfoLenType Type)
+{
+    switch (Type)
+    {
+        case FileBin_VARINFO_TYPE_BOOLEAN:
+        case FileBin_VARINFO_TYPE_UINT8:
+        case FileBin_VARINFO_TYPE_SINT8:
+        case FileBin_VARINFO_TYPE_ENUM:     return 1;
+        case FileBin_VARINFO_TYPE_UINT16:
+        case FileBin_VARINFO_TYPE_SINT16:   return 2;
+        case FileBin_VARINFO_TYPE_UINT32:
+        case FileBin_VARINFO_TYPE_SINT32:
+        case FileBin_VARINFO_TYPE_FLOAT32:  return 4;
+        default:                            return 0;
+    }
+}
+
+/* Shows Count consecutive elements starting at data entry Idx */
+template <typename T>
+static void DataParseArray(FileBin_IntelHex_Memory* mem, const vector<SymbolDataType *>& data, uint32_t Idx, uint32_t Count)
+{
+    vector<T> value(Count);
+    mem->ReadArray<T>(data.at(Idx)->Addr, Count, value.data());
+
+    for (uint32_t j = 0; j < Count; j++)
+    {
+        ((WidgetTreeTextBox *)data.at(Idx + j)->WidgetData)->SetVal(QString::number(value[j]));
+    }
+}
+
+/* Elements of the scalar array leaf starting at Addr, 1 if no such leaf has Width byte elements of Type */
+static uint32_t LeafArrayCount(const FileBin_LeafTable& Table, uint32_t Addr, uint32_t Width, FileBin_DWARF_VarInfoLenType Type)
+{
+    if (!Table.SortedByAddress())
+    {
+        return 1;
+    }
+
+    /* Union members may start at the same address */
+    for (auto it = std::lower_bound(Table.Addr.begin(), Table.Addr.end(), Addr); (it != Table.Addr.end()) && (*it == Addr); ++it)
+    {
+        size_t row = static_cast<size_t>(it - Table.Addr.begin());
+        if ((Table.Count[row] > 1) && (Table.Stride[row] == Width) && (Table.Type[row] == static_cast<uint8_t>(Type)) && (Table.BitField[row].Bytes == 0))
+        {
+            return Table.Count[row];
+        }
+    }
+
+    return 1;
+}
+
+static void BitFieldUnitWrite(FileBin_IntelHex_Memory* mem, uint32_t Addr, const FileBin_DWARF_BitFieldType& bf, uint64_t unit)
+{
+    uint8_t bytes[8];
+    for (uint32_t i = 0; i < bf.Bytes; i++)
+    {
+        bytes[i] = static_cast<uint8_t>(unit >> (i * 8));
+    }
+    mem->WriteArray<uint8_t>(Addr, bf.Bytes, bytes);
+}
+
  void BinCalibToolWidget::Calib_BaseFile_DataParse(FileBin_VarInfoType* node, uint32_t BaseFileIdx, FileBin_IntelHex_Memory *newFileBin)
  {
     uint32_t childIdx = 0;
@@ -988,54 +1108,93 @@ QTreeWidgetItem* BinCalibToolWidget::copyItemWithoutColumn(QTreeWidgetItem* item
             break;
         }
 
-        switch (this->BaseFileData.at(BaseFileIdx)->data.at(i)->node->DataType)
+        /* Unprogrammed memory is left blank rather than shown as zero */
+        const FileBin_DWARF_BitFieldType& bitField = this->BaseFileData.at(BaseFileIdx)->data.at(i)->node->BitField;
+        FileBin_DWARF_VarInfoLenType dataType = this->BaseFileData.at(BaseFileIdx)->data.at(i)->node->DataType;
+        uint32_t width = (bitField.Bytes != 0) ? bitField.Bytes : DataTypeBytes(dataType);
+        if ((width != 0) && (!newFileBin->IsProgrammed(this->BaseFileData.at(BaseFileIdx)->data.at(i)->Addr, width)))
+        {
+            if (dataType != FileBin_VARINFO_TYPE_ENUM)
+            {
+                ((WidgetTreeTextBox *)this->BaseFileData.at(BaseFileIdx)->data.at(i)->WidgetData)->SetVal(QString());
+            }
+            continue;
+        }
+
+        /* Bitfields are shown as the extracted field whatever the type of their storage unit */
+        if (bitField.Bytes != 0)
+        {
+            uint64_t unit = BitFieldUnitRead(newFileBin, this->BaseFileData.at(BaseFileIdx)->data.at(i)->Addr, bitField);
+            WidgetTreeTextBox *lineedit = (WidgetTreeTextBox *)this->BaseFileData.at(BaseFileIdx)->data.at(i)->WidgetData;
+            lineedit->SetVal(QString::number(FileBin_DWARF_BitFieldGet(bitField, unit)));
+            continue;
+        }
+
+        /* A scalar array is one leaf of the table, its elements are read with one lookup. The rows are still
+           checked to follow each other in the tree */
+        uint32_t leafCount = (width != 0) ? LeafArrayCount(this->LeafTable, this->BaseFileData.at(BaseFileIdx)->data.at(i)->Addr, width, dataType) : 1;
+        uint32_t count = 1;
+        while ((count < leafCount) && ((i + count) < this->BaseFileData.at(BaseFileIdx)->data.size()) &&
+               (this->BaseFileData.at(BaseFileIdx)->data.at(i + count)->node) &&
+               (this->BaseFileData.at(BaseFileIdx)->data.at(i + count)->node->DataType == dataType) &&
+               (this->BaseFileData.at(BaseFileIdx)->data.at(i + count)->node->BitField.Bytes == 0) &&
+               (this->BaseFileData.at(BaseFileIdx)->data.at(i + count)->Addr == (this->BaseFileData.at(BaseFileIdx)->data.at(i)->Addr + (count * width))))
+        {
+            count++;
+        }
+
+        /* A partly programmed array is shown element by element */
+        if ((count > 1) && (!newFileBin->IsProgrammed(this->BaseFileData.at(BaseFileIdx)->data.at(i)->Addr, count * width)))
+        {
+            count = 1;
+        }
+
+        switch (dataType)
         {
+            case FileBin_VARINFO_TYPE_BOOLEAN:
             case FileBin_VARINFO_TYPE_UINT8:
             {
-                WidgetTreeTextBox *lineedit = (WidgetTreeTextBox *)this->BaseFileData.at(BaseFileIdx)->data.at(i)->WidgetData;
-                lineedit->SetVal(QString::number(newFileBin->ReadMem_uint8(nullptr, 0, this->BaseFileData.at(BaseFileIdx)->data.at(i)->node->Addr)));
+                DataParseArray<uint8_t>(newFileBin, this->BaseFileData.at(BaseFileIdx)->data, i, count);
                 break;
             }
             case FileBin_VARINFO_TYPE_SINT8:
             {
-                WidgetTreeTextBox *lineedit = (WidgetTreeTextBox *)this->BaseFileData.at(BaseFileIdx)->data.at(i)->WidgetData;
-                lineedit->SetVal(QString::number(newFileBin->ReadMem_sint8(nullptr, 0, this->BaseFileData.at(BaseFileIdx)->data.at(i)->node->Addr)));
+                DataParseArray<int8_t>(newFileBin, this->BaseFileData.at(BaseFileIdx)->data, i, count);
                 break;
             }
             case FileBin_VARINFO_TYPE_UINT16:
             {
-                WidgetTreeTextBox *lineedit = (WidgetTreeTextBox *)this->BaseFileData.at(BaseFileIdx)->data.at(i)->WidgetData;
-                lineedit->SetVal(QString::number(newFileBin->ReadMem_uint16(nullptr, 0, this->BaseFileData.at(BaseFileIdx)->data.at(i)->node->Addr)));
+                DataParseArray<uint16_t>(newFileBin, this->BaseFileData.at(BaseFileIdx)->data, i, count);
                 break;
             }
             case FileBin_VARINFO_TYPE_SINT16:
             {
-                WidgetTreeTextBox *lineedit = (WidgetTreeTextBox *)this->BaseFileData.at(BaseFileIdx)->data.at(i)->WidgetData;
-                lineedit->SetVal(QString::number(newFileBin->ReadMem_sint16(nullptr, 0, this->BaseFileData.at(BaseFileIdx)->data.at(i)->node->Addr)));
+                DataParseArray<int16_t>(newFileBin, this->BaseFileData.at(BaseFileIdx)->data, i, count);
                 break;
             }
             case FileBin_VARINFO_TYPE_UINT32:
             {
-                WidgetTreeTextBox *lineedit = (WidgetTreeTextBox *)this->BaseFileData.at(BaseFileIdx)->data.at(i)->WidgetData;
-                lineedit->SetVal(QString::number(newFileBin->ReadMem_uint32(this->BaseFileData.at(BaseFileIdx)->data.at(i)->node->Addr)));
+                DataParseArray<uint32_t>(newFileBin, this->BaseFileData.at(BaseFileIdx)->data, i, count);
                 break;
             }
             case FileBin_VARINFO_TYPE_SINT32:
             {
-                WidgetTreeTextBox *lineedit = (WidgetTreeTextBox *)this->BaseFileData.at(BaseFileIdx)->data.at(i)->WidgetData;
-                lineedit->SetVal(QString::number(newFileBin->ReadMem_sint32(nullptr, 0, this->BaseFileData.at(BaseFileIdx)->data.at(i)->node->Addr)));
+                DataParseArray<int32_t>(newFileBin, this->BaseFileData.at(BaseFileIdx)->data, i, count);
                 break;
             }
             case FileBin_VARINFO_TYPE_FLOAT32:
             {
-                WidgetTreeTextBox *lineedit = (WidgetTreeTextBox *)this->BaseFileData.at(BaseFileIdx)->data.at(i)->WidgetData;
-                lineedit->SetVal(QString::number(newFileBin->ReadMem_float32(nullptr, 0, this->BaseFileData.at(BaseFileIdx)->data.at(i)->node->Addr)));
+                DataParseArray<float>(newFileBin, this->BaseFileData.at(BaseFileIdx)->data, i, count);
                 break;
             }
             case FileBin_VARINFO_TYPE_ENUM:
             {
-                WidgetTreeComboBox *dataWidget = (WidgetTreeComboBox *)this->BaseFileData.at(BaseFileIdx)->data.at(i)->WidgetData;
-                dataWidget->setIdx(newFileBin->ReadMem_uint8(nullptr, 0, this->BaseFileData.at(BaseFileIdx)->data.at(i)->node->Addr));
+                vector<uint8_t> value(count);
+                newFileBin->ReadArray<uint8_t>(this->BaseFileData.at(BaseFileIdx)->data.at(i)->Addr, count, value.data());
+                for (uint32_t j = 0; j < count; j++)
+                {
+                    ((WidgetTreeComboBox *)this->BaseFileData.at(BaseFileIdx)->data.at(i + j)->WidgetData)->setIdx(value[j]);
+                }
                 break;
             }
             default:
@@ -1043,6 +1202,8 @@ QTreeWidgetItem* BinCalibToolWidget::copyItemWithoutColumn(QTreeWidgetItem* item
                 break;
             }
         }
+
+        i += count - 1;
     }
  }
 
@@ -1065,63 +1226,76 @@ QTreeWidgetItem* BinCalibToolWidget::copyItemWithoutColumn(QTreeWidgetItem* item
         return;
     }
 
-    cout << "Writing memory BinFile type: " << (int)InfoNode->DataType <<  " Idx: " << BinIdx << " Symbol Idx: " << SymbolIdx << " Addr: 0x" << std::hex << InfoNode->Addr <<  endl;
+    uint32_t Addr = this->BaseFileData.at(BinIdx)->data.at(SymbolIdx)->Addr;
+
+    cout << "Writing memory BinFile type: " << (int)InfoNode->DataType <<  " Idx: " << BinIdx << " Symbol Idx: " << SymbolIdx << " Addr: 0x" << std::hex << Addr <<  endl;
+
+    /* Read-modify-write of the storage unit, the neighbour fields are kept */
+    const FileBin_DWARF_BitFieldType& bitField = this->BaseFileData.at(BinIdx)->data.at(SymbolIdx)->node->BitField;
+    if (bitField.Bytes != 0)
+    {
+        WidgetTreeTextBox* textBox = (WidgetTreeTextBox*)this->BaseFileData.at(BinIdx)->data.at(SymbolIdx)->WidgetData;
+        FileBin_IntelHex_Memory* mem = this->BaseFileData.at(BinIdx)->mem;
+        uint64_t unit = BitFieldUnitRead(mem, Addr, bitField);
+        BitFieldUnitWrite(mem, Addr, bitField, FileBin_DWARF_BitFieldSet(bitField, unit, textBox->text().toLongLong()));
+        return;
+    }
 
     switch(this->BaseFileData.at(BinIdx)->data.at(SymbolIdx)->node->DataType)
     {
         case FileBin_VARINFO_TYPE_BOOLEAN:
         {
             WidgetTreeTextBox* textBox = (WidgetTreeTextBox*)this->BaseFileData.at(BinIdx)->data.at(SymbolIdx)->WidgetData;
-            this->BaseFileData.at(BinIdx)->mem->WriteMem_boolean(InfoNode->Addr, textBox->text().toFloat());
+            this->BaseFileData.at(BinIdx)->mem->Write<uint8_t>(Addr, textBox->text().toFloat());
             break;
         }
 
         case FileBin_VARINFO_TYPE_UINT8:
         {
             WidgetTreeTextBox* textBox = (WidgetTreeTextBox*)this->BaseFileData.at(BinIdx)->data.at(SymbolIdx)->WidgetData;
-            this->BaseFileData.at(BinIdx)->mem->WriteMem_uint8(InfoNode->Addr, textBox->text().toUInt());
+            this->BaseFileData.at(BinIdx)->mem->Write<uint8_t>(Addr, textBox->text().toUInt());
             break;
         }
 
         case FileBin_VARINFO_TYPE_SINT8:
         {
             WidgetTreeTextBox* textBox = (WidgetTreeTextBox*)this->BaseFileData.at(BinIdx)->data.at(SymbolIdx)->WidgetData;
-            this->BaseFileData.at(BinIdx)->mem->WriteMem_sint8(InfoNode->Addr, textBox->text().toInt());
+            this->BaseFileData.at(BinIdx)->mem->Write<int8_t>(Addr, textBox->text().toInt());
             break;
         }
 
         case FileBin_VARINFO_TYPE_UINT16:
         {
             WidgetTreeTextBox* textBox = (WidgetTreeTextBox*)this->BaseFileData.at(BinIdx)->data.at(SymbolIdx)->WidgetData;
-            this->BaseFileData.at(BinIdx)->mem->WriteMem_uint16(InfoNode->Addr, textBox->text().toUInt());
+            this->BaseFileData.at(BinIdx)->mem->Write<uint16_t>(Addr, textBox->text().toUInt());
             break;
         }
 
         case FileBin_VARINFO_TYPE_SINT16:
         {
             WidgetTreeTextBox* textBox = (WidgetTreeTextBox*)this->BaseFileData.at(BinIdx)->data.at(SymbolIdx)->WidgetData;
-            this->BaseFileData.at(BinIdx)->mem->WriteMem_sint16(InfoNode->Addr, textBox->text().toInt());
+            this->BaseFileData.at(BinIdx)->mem->Write<int16_t>(Addr, textBox->text().toInt());
             break;
         }
 
         case FileBin_VARINFO_TYPE_UINT32:
         {
             WidgetTreeTextBox* textBox = (WidgetTreeTextBox*)this->BaseFileData.at(BinIdx)->data.at(SymbolIdx)->WidgetData;
-            this->BaseFileData.at(BinIdx)->mem->WriteMem_uint32(InfoNode->Addr, textBox->text().toUInt());
+            this->BaseFileData.at(BinIdx)->mem->Write<uint32_t>(Addr, textBox->text().toUInt());
             break;
         }
 
         case FileBin_VARINFO_TYPE_SINT32:
         {
             WidgetTreeTextBox* textBox = (WidgetTreeTextBox*)this->BaseFileData.at(BinIdx)->data.at(SymbolIdx)->WidgetData;
-            this->BaseFileData.at(BinIdx)->mem->WriteMem_sint32(InfoNode->Addr, textBox->text().toInt());
+            this->BaseFileData.at(BinIdx)->mem->Write<int32_t>(Addr, textBox->text().toInt());
             break;
         }
 
         case FileBin_VARINFO_TYPE_FLOAT32:
         {
             WidgetTreeTextBox* textBox = (WidgetTreeTextBox*)this->BaseFileData.at(BinIdx)->data.at(SymbolIdx)->WidgetData;
-            this->BaseFileData.at(BinIdx)->mem->WriteMem_float32(InfoNode->Addr, textBox->text().toFloat());
+            this->BaseFileData.at(BinIdx)->mem->Write<float>(Addr, textBox->text().toFloat());
             break;
         }
 
@@ -1129,7 +1303,7 @@ QTreeWidgetItem* BinCalibToolWidget::copyItemWithoutColumn(QTreeWidgetItem* item
         {
 
             WidgetTreeComboBox* comboBox = (WidgetTreeComboBox*)this->BaseFileData.at(BinIdx)->data.at(SymbolIdx)->WidgetData;
-            this->BaseFileData.at(BinIdx)->mem->WriteMem_uint8(InfoNode->Addr, comboBox->currentIndex());
+            this->BaseFileData.at(BinIdx)->mem->Write<uint8_t>(Addr, comboBox->currentIndex());
             break;
         }
 
@@ -1140,7 +1314,7 @@ QTreeWidgetItem* BinCalibToolWidget::copyItemWithoutColumn(QTreeWidgetItem* item
     }
 }
 
-void BinCalibToolWidget::Calib_BaseFile_WidgetPopulate(FileBin_VarInfoType* node, QTreeWidgetItem* item, uint32_t BaseFileIdx)
+void BinCalibToolWidget::Calib_BaseFile_WidgetPopulate(FileBin_VarInfoType* node, QTreeWidgetItem* item, uint32_t BaseFileIdx, uint32_t BaseAddr)
 {
 
     uint32_t childIdx = 0;
@@ -1151,6 +1325,8 @@ void BinCalibToolWidget::Calib_BaseFile_WidgetPopulate(FileBin_VarInfoType* node
         // Skip qualifier nodes for the row but still recurse into children
         if (!node->isQualifier)
         {
+            uint32_t addr = FileBin_DWARF_SymbolAddr(node, BaseAddr);
+
             /* Multi-dimensional symbol */
             if (node->Size.size() > 1)
             {
@@ -1169,9 +1345,28 @@ void BinCalibToolWidget::Calib_BaseFile_WidgetPopulate(FileBin_VarInfoType* node
             }
             else
             {
-                if (FileBin_VARINFO_TYPE_BOOLEAN == node->DataType)
+                if (node->BitField.Bytes != 0)
                 {
-                    std::vector<uint8_t> raw = this->ELFData->readSymbolFromELF(node->Addr, node->Size.at(0));
+                    std::vector<uint8_t> raw = this->ELFData->readSymbolFromELF(addr, node->BitField.Bytes);
+                    int64_t value = FileBin_DWARF_BitFieldGet(node->BitField, FileBin_DWARF_BitFieldLoad(raw.data(), raw.size()));
+
+                    WidgetTreeTextBox *widgetData = new WidgetTreeTextBox(this, false, 0, BaseFileIdx, BaseFileData.at(BaseFileIdx)->data.size(), value);
+
+                    tree->setItemWidget(item->child(childIdx), 4 + BaseFileIdx, widgetData);
+
+                    QObject::connect(widgetData, &WidgetTreeTextBox::editingFinishedWithInts, [this, node](int firstInt, int secondInt) {
+                        BinMemWrite(node, firstInt, secondInt);
+                    });
+
+                    SymbolDataType *newDataInfo = new SymbolDataType();
+                    newDataInfo->node = node;
+                    newDataInfo->Addr = addr;
+                    newDataInfo->WidgetData = widgetData;
+                    BaseFileData.at(BaseFileIdx)->data.push_back(newDataInfo);
+                }
+                else if (FileBin_VARINFO_TYPE_BOOLEAN == node->DataType)
+                {
+                    std::vector<uint8_t> raw = this->ELFData->readSymbolFromELF(addr, node->Size.at(0));
 
                     bool value = 0;
 
@@ -1190,12 +1385,13 @@ void BinCalibToolWidget::Calib_BaseFile_WidgetPopulate(FileBin_VarInfoType* node
 
                     SymbolDataType *newDataInfo = new SymbolDataType();
                     newDataInfo->node = node;
+                    newDataInfo->Addr = addr;
                     newDataInfo->WidgetData = widgetData;
                     BaseFileData.at(BaseFileIdx)->data.push_back(newDataInfo);
                 }
                 else if (FileBin_VARINFO_TYPE_UINT8 == node->DataType)
                 {
-                    std::vector<uint8_t> raw = this->ELFData->readSymbolFromELF(node->Addr, node->Size.at(0));
+                    std::vector<uint8_t> raw = this->ELFData->readSymbolFromELF(addr, node->Size.at(0));
 
                     uint8_t value = 0;
                     if (raw.size() >= 1)
@@ -1213,12 +1409,13 @@ void BinCalibToolWidget::Calib_BaseFile_WidgetPopulate(FileBin_VarInfoType* node
 
                     SymbolDataType *newDataInfo = new SymbolDataType();
                     newDataInfo->node = node;
+                    newDataInfo->Addr = addr;
                     newDataInfo->WidgetData = widgetData;
                     BaseFileData.at(BaseFileIdx)->data.push_back(newDataInfo);
                 }
                 else if (FileBin_VARINFO_TYPE_SINT8 == node->DataType)
                 {
-                     std::vector<uint8_t> raw = ELFData->readSymbolFromELF(node->Addr, node->Size.at(0));
+                     std::vector<uint8_t> raw = ELFData->readSymbolFromELF(addr, node->Size.at(0));
 
                     int8_t value = 0;
                     if (raw.size() >= 1)
@@ -1236,12 +1433,13 @@ void BinCalibToolWidget::Calib_BaseFile_WidgetPopulate(FileBin_VarInfoType* node
 
                     SymbolDataType *newDataInfo = new SymbolDataType();
                     newDataInfo->node = node;
+                    newDataInfo->Addr = addr;
                     newDataInfo->WidgetData = widgetData;
                     BaseFileData.at(BaseFileIdx)->data.push_back(newDataInfo);
                 }
                 else if (FileBin_VARINFO_TYPE_UINT16 == node->DataType)
                 {
-                    std::vector<uint8_t> raw = ELFData->readSymbolFromELF(node->Addr, node->Size.at(0));
+                    std::vector<uint8_t> raw = ELFData->readSymbolFromELF(addr, node->Size.at(0));
 
                     uint16_t value = 0;
                     if (raw.size() >= 2)
@@ -1260,12 +1458,13 @@ void BinCalibToolWidget::Calib_BaseFile_WidgetPopulate(FileBin_VarInfoType* node
 
                     SymbolDataType *newDataInfo = new SymbolDataType();
                     newDataInfo->node = node;
+                    newDataInfo->Addr = addr;
                     newDataInfo->WidgetData = widgetData;
                     BaseFileData.at(BaseFileIdx)->data.push_back(newDataInfo);
                 }
                 else if (FileBin_VARINFO_TYPE_SINT16 == node->DataType)
                 {
-                    std::vector<uint8_t> raw = ELFData->readSymbolFromELF(node->Addr, node->Size.at(0));
+                    std::vector<uint8_t> raw = ELFData->readSymbolFromELF(addr, node->Size.at(0));
 
                     int16_t value = 0;
                     if (raw.size() >= 2)
@@ -1284,12 +1483,13 @@ void BinCalibToolWidget::Calib_BaseFile_WidgetPopulate(FileBin_VarInfoType* node
 
                     SymbolDataType *newDataInfo = new SymbolDataType();
                     newDataInfo->node = node;
+                    newDataInfo->Addr = addr;
                     newDataInfo->WidgetData = widgetData;
                     BaseFileData.at(BaseFileIdx)->data.push_back(newDataInfo);
                 }
                 else if (FileBin_VARINFO_TYPE_UINT32 == node->DataType)
                 {
-                    std::vector<uint8_t> raw = ELFData->readSymbolFromELF(node->Addr, node->Size.at(0));
+                    std::vector<uint8_t> raw = ELFData->readSymbolFromELF(addr, node->Size.at(0));
 
                     uint32_t value = 0;
 
@@ -1311,12 +1511,13 @@ void BinCalibToolWidget::Calib_BaseFile_WidgetPopulate(FileBin_VarInfoType* node
 
                     SymbolDataType *newDataInfo = new SymbolDataType();
                     newDataInfo->node = node;
+                    newDataInfo->Addr = addr;
                     newDataInfo->WidgetData = widgetData;
                     BaseFileData.at(BaseFileIdx)->data.push_back(newDataInfo);
                 }
                 else if (FileBin_VARINFO_TYPE_SINT32 == node->DataType)
                 {
-                    std::vector<uint8_t> raw = ELFData->readSymbolFromELF(node->Addr, node->Size.at(0));
+                    std::vector<uint8_t> raw = ELFData->readSymbolFromELF(addr, node->Size.at(0));
 
                     int32_t value = 0;
 
@@ -1341,12 +1542,13 @@ void BinCalibToolWidget::Calib_BaseFile_WidgetPopulate(FileBin_VarInfoType* node
 
                     SymbolDataType *newDataInfo = new SymbolDataType();
                     newDataInfo->node = node;
+                    newDataInfo->Addr = addr;
                     newDataInfo->WidgetData = widgetData;
                     BaseFileData.at(BaseFileIdx)->data.push_back(newDataInfo);
                 }
                 else if (FileBin_VARINFO_TYPE_FLOAT32 == node->DataType)
                 {
-                    std::vector<uint8_t> raw = ELFData->readSymbolFromELF(node->Addr, node->Size.at(0));
+                    std::vector<uint8_t> raw = ELFData->readSymbolFromELF(addr, node->Size.at(0));
 
                     float value = 0.0f;
 
@@ -1373,6 +1575,7 @@ void BinCalibToolWidget::Calib_BaseFile_WidgetPopulate(FileBin_VarInfoType* node
 
                     SymbolDataType *newDataInfo = new SymbolDataType();
                     newDataInfo->node = node;
+                    newDataInfo->Addr = addr;
                     newDataInfo->WidgetData = widgetData;
                     BaseFileData.at(BaseFileIdx)->data.push_back(newDataInfo);
                 }
@@ -1382,7 +1585,7 @@ void BinCalibToolWidget::Calib_BaseFile_WidgetPopulate(FileBin_VarInfoType* node
 
                     if (node->Size.size() > 0)
                     {
-                        std::vector<uint8_t> raw = ELFData->readSymbolFromELF(node->Addr, node->Size.at(0));
+                        std::vector<uint8_t> raw = ELFData->readSymbolFromELF(addr, node->Size.at(0));
                         val = raw.at(0);
                     }
 
@@ -1404,6 +1607,7 @@ void BinCalibToolWidget::Calib_BaseFile_WidgetPopulate(FileBin_VarInfoType* node
 
                     SymbolDataType *newDataInfo = new SymbolDataType();
                     newDataInfo->node = node;
+                    newDataInfo->Addr = addr;
                     newDataInfo->WidgetData = widgetData;
                     BaseFileData.at(BaseFileIdx)->data.push_back(newDataInfo);
                 }
@@ -1418,12 +1622,12 @@ void BinCalibToolWidget::Calib_BaseFile_WidgetPopulate(FileBin_VarInfoType* node
 
             if (node->child)
             {
-                this->Calib_BaseFile_WidgetPopulate(node->child, item->child(childIdx), BaseFileIdx);
+                this->Calib_BaseFile_WidgetPopulate(node->child, item->child(childIdx), BaseFileIdx, addr);
             }
         }
         else if (node->child)
         {
-            this->Calib_BaseFile_WidgetPopulate(node->child, item, BaseFileIdx);
+            this->Calib_BaseFile_WidgetPopulate(node->child, item, BaseFileIdx, BaseAddr);
         }
 
         node = node->next;
@@ -1484,7 +1688,7 @@ static QString formatType(uint32_t typeId)
     }
 }
 
-void populateTreeWidgetRecursive(FileBin_DWARF_VarInfoType* node, QTreeWidget* treeWidget, QTreeWidgetItem* parentItem = nullptr)
+void populateTreeWidgetRecursive(FileBin_DWARF_VarInfoType* node, QTreeWidget* treeWidget, QTreeWidgetItem* parentItem = nullptr, uint32_t base = 0)
 {
     while (node)
     {
@@ -1493,9 +1697,11 @@ void populateTreeWidgetRecursive(FileBin_DWARF_VarInfoType* node, QTreeWidget* t
         {
             // --- Prepare column texts ---
             QString name = extractDisplayName(node); // your function
-            QString addr = QStringLiteral("0x") + QString::number(node->Addr, 16).toUpper();
+            QString addr = QStringLiteral("0x") + QString::number(FileBin_DWARF_SymbolAddr(node, base), 16).toUpper();
             QString size = formatSize(node->Size);   // your function
             QString type = formatType(node->DataType);   // your function
+            if (node->BitField.Bytes != 0)
+                type += QString(" :%1").arg(node->BitField.Width);
 
             // --- Create the tree item ---
             QTreeWidgetItem* item = new QTreeWidgetItem();
@@ -1527,19 +1733,19 @@ void populateTreeWidgetRecursive(FileBin_DWARF_VarInfoType* node, QTreeWidget* t
 
             // --- Recurse into children ---
             if (node->child)
-                populateTreeWidgetRecursive(node->child, treeWidget, item);
+                populateTreeWidgetRecursive(node->child, treeWidget, item, FileBin_DWARF_SymbolChildBase(node, base));
         }
         else if (node->child)
         {
             // Qualifier node: skip row but recurse into children
-            populateTreeWidgetRecursive(node->child, treeWidget, parentItem);
+            populateTreeWidgetRecursive(node->child, treeWidget, parentItem, base);
         }
 
         node = node->next; // move to sibling
     }
 }
 
-void BinCalibToolWidget::populateTreeWidgetRecursive(FileBin_DWARF_VarInfoType* node, QTreeWidgetItem* parentItem)
+void BinCalibToolWidget::populateTreeWidgetRecursive(FileBin_DWARF_VarInfoType* node, QTreeWidgetItem* parentItem, uint32_t base)
 {
     while (node)
     {
@@ -1548,9 +1754,11 @@ void BinCalibToolWidget::populateTreeWidgetRecursive(FileBin_DWARF_VarInfoType*
         {
             // --- Prepare column texts ---
             QString name = extractDisplayName(node); // your function
-            QString addr = QStringLiteral("0x") + QString::number(node->Addr, 16).toUpper();
+            QString addr = QStringLiteral("0x") + QString::number(FileBin_DWARF_SymbolAddr(node, base), 16).toUpper();
             QString size = formatSize(node->Size);   // your function
             QString type = formatType(node->DataType);   // your function
+            if (node->BitField.Bytes != 0)
+                type += QString(" :%1").arg(node->BitField.Width);
 
             // --- Create the tree item ---
             QTreeWidgetItem* item = new QTreeWidgetItem();
@@ -1586,12 +1794,12 @@ void BinCalibToolWidget::populateTreeWidgetRecursive(FileBin_DWARF_VarInfoType*
 
             // --- Recurse into children ---
             if (node->child)
-                populateTreeWidgetRecursive(node->child, item);
+                populateTreeWidgetRecursive(node->child, item, FileBin_DWARF_SymbolChildBase(node, base));
         }
         else if (node->child)
         {
             // Qualifier node: skip row but recurse into children
-            populateTreeWidgetRecursive(node->child, parentItem);
+            populateTreeWidgetRecursive(node->child, parentItem, base);
         }
 
         node = node->next; // move to sibling
@@ -1603,14 +1811,21 @@ void BinCalibToolWidget::onTreeItemClicked(QTreeWidgetItem* item, int column)
     /* Index of the selected Unit (tree row) */
     uint32_t cuIdx = m_treeWidget->indexOfTopLevelItem(item);
 
-    FileBin_DWARF_VarInfoType* node = this->SymbolData;
+    /* Fetch symbol node for the selected Compilation Unit, pinned while it is shown. The new one is
+       acquired before releasing the previous so that re-selecting a CU never evicts it */
+    FileBin_DWARF_VarInfoType* node = this->DWARFData->AcquireCU(cuIdx);
 
-    /* Fetch symbol node for the selected Compilation Unit */
-    while (node && cuIdx--)
+    if (!node)
     {
-        node = node->next;
+        return;
     }
 
+    if (this->selectedCUIdx >= 0)
+    {
+        this->DWARFData->ReleaseCU(this->selectedCUIdx);
+    }
+    this->selectedCUIdx = cuIdx;
+
     m_symbolTree->clear();
 
     // Recursively populate children under invisible root
@@ -1627,8 +1842,47 @@ void BinCalibToolWidget::onTreeItemClicked(QTreeWidgetItem* item, int column)
     }
 }
 
+bool BinCalibToolWidget::Calib_BaseFile_Open(const QString &filename)
+{
+    Lib_FirwareBinType type = FileBin_IntelHex_Memory::TypeFromExtension(filename.toStdString().c_str());
+    uint32_t baseAddr = 0;
+
+    if (type == LIB_FIRMWAREBIN_BIN)
+    {
+        /* A raw image has no addresses, it starts at the ELF load address unless told otherwise */
+        bool isOk = false;
+        QString text = QInputDialog::getText(this, tr("Binary base address"),
+                                             tr("Base address of %1:").arg(QFileInfo(filename).fileName()), QLineEdit::Normal,
+                                             "0x" + QString::number(this->ELFData->GetLoadAddress(), 16).toUpper(), &isOk);
+        if (!isOk)
+        {
+            return false;
+        }
+
+        baseAddr = text.trimmed().toUInt(&isOk, 0);
+        if (!isOk)
+        {
+            std::cout << "[ERROR] Invalid base address: " << text.toStdString() << std::endl;
+            return false;
+        }
+    }
+    else
+    {
+        /* The content decides between Intel HEX and S-record */
+        type = LIB_FIRMWAREBIN__UNKNOWN;
+    }
+
+    FileBin_IntelHex_Memory *newBaseFile = new FileBin_IntelHex_Memory();
+    newBaseFile->Load(filename.toStdString().c_str(), type, baseAddr);
+    this->Calib_BaseFile_AddNew(filename.toStdString(), newBaseFile);
+
+    return true;
+}
+
 void BinCalibToolWidget::Calib_BaseFile_AddNew(std::string filename, FileBin_IntelHex_Memory *newFileBin)
 {
+    FileBin_StatsTimer timer("gui.base_file_model");
+
     SymbolDataInfo *basefile = new SymbolDataInfo();
     basefile->filename = filename;
     basefile->mem = newFileBin;
@@ -1651,8 +1905,11 @@ void BinCalibToolWidget::Calib_BaseFile_AddNew(std::string filename, FileBin_Int
 
 void BinCalibToolWidget::Calib_MasterStruct(FileBin_VarInfoType* node)
 {
+    FileBin_StatsTimer timer("gui.calib_model");
+
     m_treeWidget->clear();  // clear existing items
     this->selectedSymbolData = nullptr;
+    this->selectedCUIdx = -1; // Pins are dropped by a new parse
 
     static QFont italicFont;
     italicFont.setItalic(true);
@@ -1707,4 +1964,145 @@ void BinCalibToolWidget::Calib_MasterStruct(FileBin_VarInfoType* node)
 
     connect(m_treeWidget, &QTreeWidget::itemClicked,
             this, &BinCalibToolWidget::onTreeItemClicked);
+
+    /* Index every symbol path for the search box */
+    {
+        FileBin_StatsTimer timer("index.symbol_paths");
+        this->SymbolIndex.Build(this->DWARFData);
+    }
+    {
+        FileBin_StatsTimer timer("index.leaf_table");
+        this->LeafTable.Build(this->SymbolIndex);
+        this->LeafTable.SortByAddress();
+    }
+    {
+        FileBin_StatsTimer timer("index.address");
+        this->AddrIndex.Build(this->SymbolIndex);
+    }
+
+    FileBin_Stats& stats = FileBin_Stats::Global();
+    stats.CounterSet("index.symbol_paths", this->SymbolIndex.Size());
+    stats.CounterSet("index.leaves", this->LeafTable.Rows());
+    stats.CounterSet("index.leaf_value_bytes", this->LeafTable.ValueBytes());
+    stats.CounterSet("index.address_segments", this->AddrIndex.Segments());
+
+    std::cout << "[INFO] Symbol index: " << this->SymbolIndex.Size() << " paths, " << this->LeafTable.Rows() << " leaves, "
+              << this->AddrIndex.Segments() << " address segments" << std::endl;
+
+    this->SymbolSearchResult.clear();
+    m_searchModel->setStringList(QStringList());
+}
+
+QString BinCalibToolWidget::Calib_SymbolAtAddr(uint32_t Addr) const
+{
+    FileBin_AddrIndex_ResultType hit = this->AddrIndex.Find(Addr);
+    if (hit.Id == FILEBIN_ADDRINDEX_NONE)
+        return QString();
+
+    std::string_view path = this->SymbolIndex.GetPath(hit.Id);
+    QString text = QString::fromUtf8(path.data(), static_cast<int>(path.size()));
+
+    /* Scalar arrays are a single entry, the element is only known here */
+    const FileBin_SymbolIndex_EntryType& entry = this->SymbolIndex.GetEntry(hit.Id);
+    if (entry.IsLeaf && (entry.ElemSize < entry.Size))
+        text += QString("[%1]").arg(hit.ElemIdx);
+    if (hit.Offset > 0)
+        text += QString(" +%1").arg(hit.Offset);
+
+    return text;
+}
+
+#define CALIB_SYMBOL_SEARCH_MAX 50
+
+void BinCalibToolWidget::onSymbolSearchEdited(const QString& text)
+{
+    std::string query = text.trimmed().toStdString();
+    this->SymbolSearchResult.clear();
+
+    if (!query.empty())
+    {
+        /* Qualified paths (cu/var.member) are looked up by prefix, plain names anywhere in the path,
+           typos are covered by the fuzzy lookup when there are not enough exact hits */
+        if (query.find('/') != std::string::npos)
+        {
+            this->SymbolSearchResult = this->SymbolIndex.FindPrefix(query, CALIB_SYMBOL_SEARCH_MAX);
+        }
+        if (this->SymbolSearchResult.empty())
+        {
+            this->SymbolSearchResult = this->SymbolIndex.FindSubstring(query, CALIB_SYMBOL_SEARCH_MAX);
+        }
+        if (this->SymbolSearchResult.size() < CALIB_SYMBOL_SEARCH_MAX)
+        {
+            for (uint32_t id : this->SymbolIndex.FindFuzzy(query, CALIB_SYMBOL_SEARCH_MAX))
+            {
+                if (this->SymbolSearchResult.size() >= CALIB_SYMBOL_SEARCH_MAX)
+                    break;
+                if (std::find(this->SymbolSearchResult.begin(), this->SymbolSearchResult.end(), id) == this->SymbolSearchResult.end())
+                    this->SymbolSearchResult.push_back(id);
+            }
+        }
+    }
+
+    QStringList paths;
+    for (uint32_t id : this->SymbolSearchResult)
+    {
+        std::string_view path = this->SymbolIndex.GetPath(id);
+        paths << QString::fromUtf8(path.data(), static_cast<int>(path.size()));
+    }
+    m_searchModel->setStringList(paths);
+}
+
+/* Child of parent shown as name, anonymous struct/union members are looked through */
+static QTreeWidgetItem* findSymbolItem(QTreeWidgetItem* parent, const QString& name)
+{
+    for (int i = 0; i < parent->childCount(); i++)
+    {
+        if (parent->child(i)->text(0) == name)
+            return parent->child(i);
+    }
+    for (int i = 0; i < parent->childCount(); i++)
+    {
+        if (parent->child(i)->text(0) == QStringLiteral("unnamed"))
+        {
+            QTreeWidgetItem* found = findSymbolItem(parent->child(i), name);
+            if (found)
+                return found;
+        }
+    }
+    return nullptr;
+}
+
+void BinCalibToolWidget::onSymbolSearchActivated(const QString& path)
+{
+    std::string pathStr = path.toStdString();
+    auto it = std::find_if(this->SymbolSearchResult.begin(), this->SymbolSearchResult.end(),
+                           [this, &pathStr](uint32_t id) { return this->SymbolIndex.GetPath(id) == pathStr; });
+    if (it == this->SymbolSearchResult.end())
+        return;
+
+    /* Show the owning CU, then walk its rows member by member. Array elements share the rows of
+       the array, so the indices are dropped from the path */
+    QTreeWidgetItem* cuItem = m_treeWidget->topLevelItem(this->SymbolIndex.GetEntry(*it).CUIdx);
+    if (!cuItem)
+        return;
+    m_treeWidget->setCurrentItem(cuItem);
+    this->onTreeItemClicked(cuItem, 0);
+
+    QString member = path.mid(path.indexOf('/') + 1);
+    member.remove(QRegularExpression("\\[\\d+\\]"));
+
+    QTreeWidgetItem* item = m_symbolTree->invisibleRootItem();
+    for (const QString& name : member.split('.'))
+    {
+        QTreeWidgetItem* child = findSymbolItem(item, name);
+        if (!child)
+            break;
+        item = child;
+    }
+
+    if (item != m_symbolTree->invisibleRootItem())
+    {
+        m_symbolTree->setCurrentItem(item);
+        m_symbolTree->scrollToItem(item, QAbstractItemView::PositionAtCenter);
+    }
 }
@@ -41,8 +41,14 @@
 #include <QSplitter>
 #include <qtreewidget.h>
 #include <qtoolbar.h>
+#include <QLineEdit>
+#include <QCompleter>
+#include <QStringListModel>
 #include "FileBin_DWARF.h"
 #include "FileBin_ELF.h"
+#include "FileBin_SymbolIndex.h"
+#include "FileBin_LeafTable.h"
+#include "FileBin_AddrIndex.h"
 #include "FileBin_IntelHex.hpp"
 #include "WidgetTreeTextBox.hpp"
 
@@ -56,6 +62,7 @@ struct DwarfSymbol {
 typedef struct SymbolData
 {
     FileBin_DWARF_VarInfoType* node;
+    uint32_t Addr; /* Absolute address, node may belong to a shared type layout */
     QWidget *WidgetData;
 } SymbolDataType;
 
@@ -71,7 +78,7 @@ class BinCalibToolWidget : public QWidget
     Q_OBJECT
 
 public:
-    explicit BinCalibToolWidget(QWidget *parent = nullptr, FileBin_ELF * elf = nullptr);
+    explicit BinCalibToolWidget(QWidget *parent = nullptr, FileBin_ELF * elf = nullptr, FileBin_DWARF * dwarf = nullptr);
 
     // Public API to feed the widget data
     void loadSymbols(FileBin_VarInfoType* node);
@@ -83,10 +90,12 @@ public:
 
     void Calib_MasterStruct(FileBin_VarInfoType* node); // Generate master struct of source ifles
     void Calib_MasterSymbolShow(QTreeWidgetItem* item, int column); // Add master symbol list according to selected file
+    bool Calib_BaseFile_Open(const QString &filename); // Load and add a base file, asks for the base address of a .bin
     void Calib_BaseFile_AddNew(std::string filename, FileBin_IntelHex_Memory *newFileBin); // Add new base file
-    void Calib_BaseFile_WidgetPopulate(FileBin_VarInfoType* node, QTreeWidgetItem* item, uint32_t rowIdx); // Add base file widgets
+    void Calib_BaseFile_WidgetPopulate(FileBin_VarInfoType* node, QTreeWidgetItem* item, uint32_t rowIdx, uint32_t BaseAddr = 0); // Add base file widgets
     void Calib_BaseFile_DataParse(FileBin_VarInfoType* node, uint32_t BaseFileIdx, FileBin_IntelHex_Memory *newFileBin); // Parse base file into widgets
     void Calib_BaseFile_Remove(uint32_t BaseFileIdx); // Add new base file
+    QString Calib_SymbolAtAddr(uint32_t Addr) const; // Innermost symbol path holding Addr, empty if none
 
 
 signals:
@@ -97,12 +106,20 @@ signals:
 private slots:
    // void handleApplyPatch();
     void onTreeItemClicked(QTreeWidgetItem* item, int column);
+    void onSymbolSearchEdited(const QString& text);
+    void onSymbolSearchActivated(const QString& path);
 
 private:
 
     FileBin_DWARF_VarInfoType* SymbolData;
     FileBin_DWARF_VarInfoType* selectedSymbolData = nullptr;
     FileBin_ELF* ELFData;
+    FileBin_DWARF* DWARFData;
+    int32_t selectedCUIdx = -1; /* CU pinned while its symbols are shown */
+    FileBin_SymbolIndex SymbolIndex; /* Fully qualified paths of every CU, rebuilt on each parse */
+    std::vector<uint32_t> SymbolSearchResult; /* Index ids of the rows shown by the search completer */
+    FileBin_LeafTable LeafTable; /* Every scalar leaf in address order, gives the array runs Calib_BaseFile_DataParse reads at once */
+    FileBin_AddrIndex AddrIndex; /* Address to innermost symbol of SymbolIndex */
     //std::vector<FileBaseInfo> BaseFile;
     bool IsMasterFileLoaded;
     vector<SymbolDataInfo *> BaseFileData;
@@ -113,13 +130,15 @@ private:
     QString m_hexFilePath;
 
     QToolBar     *m_toolBar;
+    QLineEdit    *m_searchBox;
+    QStringListModel *m_searchModel;
 
     QTableWidget *m_tableWidget;  // Right: Hex/Values
     QSplitter    *m_splitter;     // Resizable divider
 
     QTreeWidgetItem* copyItemWithoutColumn(QTreeWidgetItem* item, int colToRemove);
     void loadSymbolData(FileBin_VarInfoType* node, QTreeWidgetItem* item, uint32_t rowIdx, uint32_t colIdx, uint32_t BaseFileColIdx);
-    void populateTreeWidgetRecursive(FileBin_DWARF_VarInfoType* node, QTreeWidgetItem* parentItem = nullptr);
+    void populateTreeWidgetRecursive(FileBin_DWARF_VarInfoType* node, QTreeWidgetItem* parentItem = nullptr, uint32_t base = 0);
    // void RefreshBaseFile(void);
     void BinMemWrite(FileBin_VarInfoType *InfoNode, uint32_t BinIdx, uint32_t SymbolIdx);
 
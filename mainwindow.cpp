@@ -34,6 +34,8 @@
 #include "./ui_mainwindow.h"
 #include "FileBin_ELF.h"
 #include "FileBin_DWARF.h"
+#include "FileBin_Stats.h"
+#include "FileBin_Trace.h"
 #include <string>
 #include <QStandardItemModel>
 #include <chrono>   // for timing
@@ -53,6 +55,19 @@
 #include <QIcon>
 #include <QTransform>
 #include "FileBin_IntelHex.hpp"
+#include <QProgressDialog>
+#include <QEventLoop>
+#include <thread>
+#include <QTextBlock>
+#include <QDialog>
+#include <QTreeWidget>
+#include <QDialogButtonBox>
+#include <QPushButton>
+#include <QVBoxLayout>
+#include <QApplication>
+#include <QClipboard>
+#include <QHeaderView>
+#include <fstream>
 
 QIcon rotateIcon(const QIcon &icon, qreal angle)
 {
@@ -89,6 +104,9 @@ static std::string TagToString(uint32_t tag)
         case FILEBIN_DWARF_ELEMENT_MEMBER:          return "MEMBER";
         case FILEBIN_DWARF_ELEMENT_VARIABLE:        return "VARIABLE";
         case FILEBIN_DWARF_ELEMENT_CONSTANT:        return "CONSTANT";
+        case FILEBIN_DWARF_ELEMENT_SCOPE:           return "SCOPE";
+        case FILEBIN_DWARF_ELEMENT_UNION:           return "UNION";
+        case FILEBIN_DWARF_ELEMENT_POINTER:         return "POINTER";
         default:                                    return "";
     }
 }
@@ -183,7 +201,7 @@ static QString formatType(uint32_t typeId)
     }
 }
 
-void populateModelRecursiveSymbol(FileBin_VarInfoType* node, QStandardItem* parentItem)
+void populateModelRecursiveSymbol(FileBin_VarInfoType* node, QStandardItem* parentItem, uint32_t base = 0)
 {
     static QFont italicFont;
     italicFont.setItalic(true);
@@ -199,7 +217,8 @@ void populateModelRecursiveSymbol(FileBin_VarInfoType* node, QStandardItem* pare
             QString name = node->data.empty()
             ? "unnamed"
             : QString::fromUtf8(reinterpret_cast<const char*>(node->data.data()), node->data.size());
-            QString addr = QString::asprintf("0x%X", node->Addr);
+            uint32_t addrAbs = FileBin_DWARF_SymbolAddr(node, base);
+            QString addr = QString::asprintf("0x%X", addrAbs);
             QString size = formatSize(node->Size);
             QString type = formatType(node->DataType);
 
@@ -226,6 +245,8 @@ void populateModelRecursiveSymbol(FileBin_VarInfoType* node, QStandardItem* pare
 
             // Store the pointer to this node in Qt::UserRole
             nameItem->setData(QVariant::fromValue(node), Qt::UserRole);
+            // Type layouts are shared between instances, keep the resolved address alongside
+            nameItem->setData(addrAbs, Qt::UserRole + 2);
 
             // Append row to parent
             parentItem->appendRow({ nameItem, addrItem, sizeItem, typeItem });
@@ -233,7 +254,7 @@ void populateModelRecursiveSymbol(FileBin_VarInfoType* node, QStandardItem* pare
 
         // Recursive call for children
         if (node->child)
-            populateModelRecursiveSymbol(node->child, nameItem);
+            populateModelRecursiveSymbol(node->child, nameItem, FileBin_DWARF_SymbolChildBase(node, base));
 
         node = node->next;
     }
@@ -292,11 +313,40 @@ void beautifyTreeView(Ui::MainWindow *ui, QTreeView* view)
 }
 
 
+/* Top level CU rows are filled on expansion, the CU index is used to acquire it from the parser */
+static void addCUPlaceholder(QStandardItem* cuItem, uint32_t cuIdx)
+{
+    QStandardItem* placeholder = new QStandardItem("Loading...");
+    placeholder->setFlags(Qt::ItemIsEnabled);      // must be enabled to show expand arrow
+    placeholder->setData(true, Qt::UserRole + 1);  // mark as placeholder
+    cuItem->appendRow(placeholder);
+
+    cuItem->setData(cuIdx, Qt::UserRole + 3);
+}
+
+/* Collapsing a CU row drops its children and unpins the CU so it can be evicted */
+static void collapseCU(QStandardItem* cuItem)
+{
+    if ((!cuItem) || (!cuItem->data(Qt::UserRole + 3).isValid()) || (cuItem->rowCount() == 0))
+        return;
+
+    if (cuItem->child(0)->data(Qt::UserRole + 1).toBool())
+        return;
+
+    uint32_t cuIdx = cuItem->data(Qt::UserRole + 3).toUInt();
+
+    cuItem->removeRows(0, cuItem->rowCount());
+    addCUPlaceholder(cuItem, cuIdx);
+    dwarf->ReleaseCU(cuIdx);
+}
+
 void populateTopLevel(TreeElementType* node, QStandardItem* parentItem)
 {
     static QFont italicFont;
     italicFont.setItalic(true);
 
+    uint32_t cuIdx = 0;
+
     while (node)
     {
         QString displayName = node->data.empty()
@@ -315,19 +365,11 @@ void populateTopLevel(TreeElementType* node, QStandardItem* parentItem)
 
         parentItem->appendRow({ nameItem, tagItem });
 
-        // If node has children, add a **dummy child** as a placeholder
-        if (node->child)
-        {
-            QStandardItem* placeholder = new QStandardItem("Loading...");
-            placeholder->setFlags(Qt::ItemIsEnabled);      // must be enabled to show expand arrow
-            placeholder->setData(true, Qt::UserRole + 1);  // mark as placeholder
-            nameItem->appendRow(placeholder);
-
-            // Store a pointer to the actual TreeElementType in item data
-            nameItem->setData(QVariant::fromValue(reinterpret_cast<void*>(node->child)), Qt::UserRole);
-        }
+        // CU trees may be evicted, always add a **dummy child** as a placeholder
+        addCUPlaceholder(nameItem, cuIdx);
 
         node = node->next;
+        cuIdx++;
     }
 }
 
@@ -338,6 +380,8 @@ void MainWindow::populateTopLevelSymbol(FileBin_VarInfoType* node, QStandardItem
 
     this->ui_BinCalibWidget->Calib_MasterStruct(node);
 
+    uint32_t cuIdx = 0;
+
     while (node)
     {
         QString displayName = node->data.empty()
@@ -356,19 +400,11 @@ void MainWindow::populateTopLevelSymbol(FileBin_VarInfoType* node, QStandardItem
 
         parentItem->appendRow({ nameItem, tagItem });
 
-        // If node has children, add a **dummy child** as a placeholder
-        if (node->child)
-        {
-            QStandardItem* placeholder = new QStandardItem("Loading...");
-            placeholder->setFlags(Qt::ItemIsEnabled);      // must be enabled to show expand arrow
-            placeholder->setData(true, Qt::UserRole + 1);  // mark as placeholder
-            nameItem->appendRow(placeholder);
-
-            // Store a pointer to the actual TreeElementType in item data
-            nameItem->setData(QVariant::fromValue(reinterpret_cast<void*>(node->child)), Qt::UserRole);
-        }
+        // CU symbols may be evicted, always add a **dummy child** as a placeholder
+        addCUPlaceholder(nameItem, cuIdx);
 
         node = node->next;
+        cuIdx++;
     }
 
 
@@ -504,10 +540,15 @@ QToolButton:checked {
 
     // Apply to the whole main window
     //this->setStyleSheet(buttonStyle);
+    FILEBIN_TRACE_THREAD_NAME("GUI");
+
     elf = new FileBin_ELF();
     dwarf = new FileBin_DWARF();
 
-    this->ui_BinCalibWidget = new BinCalibToolWidget(this, elf);
+    /* Bounded memory mode for very large images, budget in MB (unset or 0: every CU stays resident) */
+    dwarf->SetMemoryBudget(static_cast<uint64_t>(qEnvironmentVariableIntValue("FYNIX_DWARF_BUDGET_MB")) * 1024u * 1024u);
+
+    this->ui_BinCalibWidget = new BinCalibToolWidget(this, elf, dwarf);
 
     // Force the menubar to be strictly the height of its contents
     ui->menubar->setContentsMargins(0, 0, 0, 0);
@@ -546,6 +587,9 @@ QToolButton:checked {
     ui->treeView_2->setFocusPolicy(Qt::NoFocus);
     //ui->->setFocusPolicy(Qt::NoFocus);
 
+    // Clicking a byte of the hex dump names the symbol (variable/member/element) stored there
+    connect(ui->textEdit, &QTextEdit::cursorPositionChanged, this, &MainWindow::onHexViewCursorMoved);
+
     ui->tabWidget_2->addTab(this->ui_BinCalibWidget, "Calibrator");
 
     ui->tabWidget_2->setTabIcon(0, QIcon(":/icon/inspect.svg"));
@@ -602,7 +646,7 @@ MainWindow::~MainWindow()
     delete ui;
 }
 
-void MainWindow::displayBinaryFile(FileBin_VarInfoType *symbol)
+void MainWindow::displayBinaryFile(FileBin_VarInfoType *symbol, uint32_t Addr)
 {
     if (!symbol || !elf)
         return;
@@ -611,7 +655,7 @@ void MainWindow::displayBinaryFile(FileBin_VarInfoType *symbol)
         return;
 
     // Read symbol bytes from ELF
-    std::vector<uint8_t> data = elf->readSymbolFromELF(symbol->Addr, symbol->Size.at(0));
+    std::vector<uint8_t> data = elf->readSymbolFromELF(Addr, symbol->Size.at(0));
 
     const int bytesPerLine = 16;        // 16 bytes per line
     QString hexDump;
@@ -621,7 +665,7 @@ void MainWindow::displayBinaryFile(FileBin_VarInfoType *symbol)
         QString line;
 
         // First column: memory address
-        line += QString("0x%1: ").arg(symbol->Addr, 8, 16, QChar('0')).toUpper();
+        line += QString("0x%1: ").arg(Addr + i, 8, 16, QChar('0')).toUpper();
 
         // Hex bytes column
         for (int j = 0; j < bytesPerLine; ++j)
@@ -656,6 +700,43 @@ void MainWindow::displayBinaryFile(FileBin_VarInfoType *symbol)
     ui->textEdit->setPlainText(hexDump);
 }
 
+void MainWindow::onHexViewCursorMoved()
+{
+    /* Line layout: "0xAAAAAAAA: " then 16 "XX " byte columns, " |" and 16 ASCII columns */
+    const int hexCol = 12;
+    const int asciiCol = hexCol + 16 * 3 + 2;
+
+    QTextCursor cursor = ui->textEdit->textCursor();
+    QString line = cursor.block().text();
+    int col = cursor.positionInBlock();
+
+    bool ok = false;
+    uint32_t lineAddr = line.mid(2, 8).toUInt(&ok, 16);
+    if (!ok)
+        return;
+
+    int byteIdx;
+    if ((col >= hexCol) && (col < hexCol + 16 * 3))
+        byteIdx = (col - hexCol) / 3;
+    else if ((col >= asciiCol) && (col < asciiCol + 16))
+        byteIdx = col - asciiCol;
+    else
+        return;
+
+    uint32_t addr = lineAddr + byteIdx;
+    QString symbol = this->ui_BinCalibWidget->Calib_SymbolAtAddr(addr);
+    QString message = QString("0x%1: %2").arg(addr, 8, 16, QChar('0')).arg(symbol.isEmpty() ? QString("no symbol") : symbol);
+
+    // Code addresses also name the source line they were generated from
+    FileBin_LineTable_ResultType source;
+    if (dwarf->GetLineTable().Find(addr, source))
+    {
+        message += QString("  [%1:%2]").arg(QString::fromStdString(*source.File)).arg(source.Line);
+    }
+
+    this->statusBar()->showMessage(message, 0);
+}
+
 void MainWindow::onTreeSelectionChanged(const QItemSelection &selected, const QItemSelection &deselected)
 {
     Q_UNUSED(deselected);
@@ -682,13 +763,40 @@ void MainWindow::onTreeSelectionChanged(const QItemSelection &selected, const QI
         return;
 
     // Now, you can update your QTextEdit with the binary content
-    displayBinaryFile(node);
+    displayBinaryFile(node, item->data(Qt::UserRole + 2).toUInt());
+
+    // Declaration of variables, decl_file is an index into the line table of the CU row above
+    if (node->DeclLine > 0)
+    {
+        QStandardItem* cuItem = item;
+        while (cuItem && !cuItem->data(Qt::UserRole + 3).isValid())
+            cuItem = cuItem->parent();
+
+        const std::string* file = cuItem ? dwarf->GetLineTable().FileOf(cuItem->data(Qt::UserRole + 3).toUInt(), node->DeclFile) : nullptr;
+        if (file)
+        {
+            this->statusBar()->showMessage(QString("%1 defined at %2:%3")
+                                               .arg(item->text()).arg(QString::fromStdString(*file)).arg(node->DeclLine), 0);
+        }
+    }
 }
 
 void MainWindow::loadElf(std::string file_name)
 {
+    /* The DWARF parse spins a nested event loop, a drop or Open meanwhile must not reparse elf under the worker */
+    if (this->isElfLoading)
+    {
+        this->statusBar()->showMessage("An ELF file is still loading", 0);
+        return;
+    }
+    this->isElfLoading = true;
+
     auto start = std::chrono::high_resolution_clock::now();
 
+    /* Statistics and trace describe the last load only */
+    FileBin_Stats::Global().Reset();
+    FileBin_Trace::Clear();
+
     //delete elf;
     //delete dwarf;
     //elf = nullptr;
@@ -707,14 +815,83 @@ void MainWindow::loadElf(std::string file_name)
 
     if (elf->IsDWARF())
     {
-        dwarf->Parse(
-            file_name,
-            elf->GetAbbrevOffset(),
-            elf->GetAbbrevLen(),
-            elf->GetInfoOffset(),
-            elf->GetInfoLen(),
-            elf->GetStrOffset()
-            );
+        /* Parse in a worker thread so the progress dialog stays responsive and can cancel it */
+        QProgressDialog progressDlg("Parsing DWARF information...", "Cancel", 0, 100, this);
+        progressDlg.setWindowModality(Qt::WindowModal);
+        progressDlg.setMinimumDuration(500);
+        connect(&progressDlg, &QProgressDialog::canceled, this, [] { dwarf->Cancel(); });
+
+        dwarf->SetProgressCallback([&progressDlg](const FileBin_DWARF_ProgressType& progress)
+        {
+            /* First half DIE parsing, second half symbol resolution */
+            int percent = 0;
+            if (progress.InfoBytesTotal > 0)
+            {
+                percent += static_cast<int>(50ull * progress.InfoBytesDone / progress.InfoBytesTotal);
+            }
+            if (progress.CUTotal > 0)
+            {
+                percent += static_cast<int>(50ull * progress.CUDone / progress.CUTotal);
+            }
+
+            QString label = QString("%1 / %2 KB of .debug_info, %3 / %4 CUs, %5 symbols")
+                                .arg(progress.InfoBytesDone / 1024).arg(progress.InfoBytesTotal / 1024)
+                                .arg(progress.CUDone).arg(progress.CUTotal).arg(progress.SymbolCnt);
+
+            // Called from the parser threads, update the dialog from the GUI thread
+            QMetaObject::invokeMethod(&progressDlg, [&progressDlg, percent, label]
+            {
+                progressDlg.setLabelText(label);
+                progressDlg.setValue(percent);
+            }, Qt::QueuedConnection);
+        });
+
+        QEventLoop parseLoop;
+        uint8_t parseResult = 0;
+
+        /* elf is only read on the GUI thread, the worker gets copies of the section offsets */
+        dwarf->SetSymbolTable(elf->GetObjectSymbols());
+        const uint32_t abbrevOffset = elf->GetAbbrevOffset();
+        const uint32_t abbrevLen = elf->GetAbbrevLen();
+        const uint32_t infoOffset = elf->GetInfoOffset();
+        const uint32_t infoLen = elf->GetInfoLen();
+        const uint32_t strOffset = elf->GetStrOffset();
+        const uint32_t lineOffset = elf->GetLineOffset();
+        const uint32_t lineLen = elf->GetLineLen();
+        const uint32_t lineStrOffset = elf->GetLineStrOffset();
+
+        std::thread parseThread([&parseLoop, &parseResult, file_name, abbrevOffset, abbrevLen, infoOffset, infoLen,
+                                 strOffset, lineOffset, lineLen, lineStrOffset]
+        {
+            FILEBIN_TRACE_THREAD_NAME("DWARF parse");
+            parseResult = dwarf->Parse(
+                file_name,
+                abbrevOffset,
+                abbrevLen,
+                infoOffset,
+                infoLen,
+                strOffset,
+                lineOffset,
+                lineLen,
+                lineStrOffset
+                );
+
+            QMetaObject::invokeMethod(&parseLoop, "quit", Qt::QueuedConnection);
+        });
+
+        parseLoop.exec();
+        parseThread.join();
+
+        dwarf->SetProgressCallback(nullptr);
+        progressDlg.reset();
+
+        if (2 == parseResult)
+        {
+            std::cout << "[INFO] Parsing cancelled" << std::endl;
+            this->statusBar()->showMessage("Parsing cancelled", 0);
+            this->isElfLoading = false;
+            return;
+        }
 
 
 
@@ -728,7 +905,10 @@ void MainWindow::loadElf(std::string file_name)
         QStandardItem* rootItem = model->invisibleRootItem();
 
         ui->treeView->setUpdatesEnabled(false);
-        populateTopLevel(rootNode, rootItem);
+        {
+            FileBin_StatsTimer timer("gui.dwarf_model");
+            populateTopLevel(rootNode, rootItem);
+        }
         ui->treeView->setUpdatesEnabled(true);
 
         FileBin_VarInfoType* rootNodeSymbol = dwarf->SymbolRoot;
@@ -741,7 +921,10 @@ void MainWindow::loadElf(std::string file_name)
         QStandardItem* rootItemSymbol = modelSymbol->invisibleRootItem();
 
         ui->treeView_2->setUpdatesEnabled(false);
-        populateTopLevelSymbol(rootNodeSymbol, rootItemSymbol);
+        {
+            FileBin_StatsTimer timer("gui.symbol_model");
+            populateTopLevelSymbol(rootNodeSymbol, rootItemSymbol);
+        }
         ui->treeView_2->setUpdatesEnabled(true);
 
         // In MainWindow constructor
@@ -764,16 +947,25 @@ void MainWindow::loadElf(std::string file_name)
                     {
                         item->removeRow(0);
 
-                        QVariant var = item->data(Qt::UserRole);
-                        if (var.isValid())
+                        // Pinned until the row is collapsed
+                        uint32_t cuIdx = item->data(Qt::UserRole + 3).toUInt();
+                        dwarf->AcquireCU(cuIdx);
+
+                        TreeElementType* cuNode = dwarf->GetCUTree(cuIdx);
+                        if (cuNode)
                         {
-                            auto* childNode =
-                                reinterpret_cast<TreeElementType*>(var.value<void*>());
-                            populateModelRecursive(childNode, item);
-                            item->setData(QVariant(), Qt::UserRole);
+                            FILEBIN_TRACE_SCOPE_ARG("gui.expand_cu", cuIdx);
+                            populateModelRecursive(cuNode->child, item);
                         }
                     }
                 });
+        connect(ui->treeView, &QTreeView::collapsed, this,
+                [this](const QModelIndex& index)
+                {
+                    auto model = qobject_cast<QStandardItemModel*>(ui->treeView->model());
+                    if (model)
+                        collapseCU(model->itemFromIndex(index));
+                });
         // Lazy loading for symbol tree
         connect(ui->treeView_2, &QTreeView::expanded, this,
                 [this](const QModelIndex& index)
@@ -789,16 +981,22 @@ void MainWindow::loadElf(std::string file_name)
                     {
                         item->removeRow(0);
 
-                        QVariant var = item->data(Qt::UserRole);
-                        if (var.isValid())
+                        // Pinned until the row is collapsed, the items keep pointers to its symbols
+                        FileBin_VarInfoType* cuSymbol = dwarf->AcquireCU(item->data(Qt::UserRole + 3).toUInt());
+                        if (cuSymbol)
                         {
-                            auto* childNode =
-                                reinterpret_cast<FileBin_VarInfoType*>(var.value<void*>());
-                            populateModelRecursiveSymbol(childNode, item);
-                            item->setData(QVariant(), Qt::UserRole);
+                            FILEBIN_TRACE_SCOPE("gui.expand_symbol_cu");
+                            populateModelRecursiveSymbol(cuSymbol->child, item);
                         }
                     }
                 });
+        connect(ui->treeView_2, &QTreeView::collapsed, this,
+                [this](const QModelIndex& index)
+                {
+                    auto model = qobject_cast<QStandardItemModel*>(ui->treeView_2->model());
+                    if (model)
+                        collapseCU(model->itemFromIndex(index));
+                });
     }
 
 
@@ -810,6 +1008,33 @@ void MainWindow::loadElf(std::string file_name)
     std::cout << "[INFO] Parsing time: "
               << duration_ms << " ms" << std::endl;
 
+    FileBin_Stats& stats = FileBin_Stats::Global();
+    stats.PhaseAdd(stats.Phase("load.total"), static_cast<uint64_t>(duration_us) * 1000u, 0);
+
+    /* Unattended profiling: FYNIX_STATS_JSON=<file> dumps the statistics of every load */
+    QString statsFile = qEnvironmentVariable("FYNIX_STATS_JSON");
+    if (!statsFile.isEmpty())
+    {
+        std::ofstream out(statsFile.toStdString());
+        if (out)
+        {
+            out << stats.ToJSON();
+        }
+        else
+        {
+            std::cout << "[ERROR] Unable to write statistics to " << statsFile.toStdString() << std::endl;
+        }
+    }
+
+#if defined(FILEBIN_TRACE)
+    /* FYNIX_TRACE_JSON=<file> writes the timeline of the load, open it in the Perfetto UI */
+    QString traceFile = qEnvironmentVariable("FYNIX_TRACE_JSON");
+    if ((!traceFile.isEmpty()) && (!FileBin_Trace::WriteJSON(traceFile.toStdString())))
+    {
+        std::cout << "[ERROR] Unable to write trace to " << traceFile.toStdString() << std::endl;
+    }
+#endif
+
     // Publish parsing time to status bar
     this->statusBar()->showMessage(
         QString("Parsing completed in %1 ms").arg(duration_ms, 0, 'f', 2),
@@ -818,22 +1043,106 @@ void MainWindow::loadElf(std::string file_name)
 
     beautifyTreeView(ui, ui->treeView);
     beautifyTreeView(ui, ui->treeView_2);
+
+    this->isElfLoading = false;
 }
 
 
 
 
+void MainWindow::on_actionLoadStats_triggered(bool checked)
+{
+    Q_UNUSED(checked);
+
+    FileBin_Stats& stats = FileBin_Stats::Global();
+
+    QDialog dialog(this);
+    dialog.setWindowTitle("Load statistics");
+    dialog.resize(640, 480);
+
+    QTreeWidget* tree = new QTreeWidget(&dialog);
+    tree->setColumnCount(5);
+    tree->setHeaderLabels({"Name", "Calls", "Total (ms)", "Max (ms)", "MB/s"});
+    tree->setRootIsDecorated(true);
+
+    QTreeWidgetItem* phaseRoot = new QTreeWidgetItem(tree, {"Phases"});
+    for (const auto& phase : stats.Phases())
+    {
+        if (0 == phase.Calls)
+        {
+            continue;
+        }
+
+        QString rate;
+        if ((phase.Bytes > 0) && (phase.TimeNs > 0))
+        {
+            rate = QString::number((phase.Bytes * 1000.0) / phase.TimeNs, 'f', 1);
+        }
+
+        new QTreeWidgetItem(phaseRoot, {QString::fromStdString(phase.Name),
+                                        QString::number(phase.Calls),
+                                        QString::number(phase.TimeNs / 1e6, 'f', 3),
+                                        QString::number(phase.MaxNs / 1e6, 'f', 3),
+                                        rate});
+    }
+
+    QTreeWidgetItem* counterRoot = new QTreeWidgetItem(tree, {"Counters"});
+    for (const auto& counter : stats.Counters())
+    {
+        new QTreeWidgetItem(counterRoot, {QString::fromStdString(counter.Name), QString::number(counter.Calls)});
+    }
+    new QTreeWidgetItem(counterRoot, {"process.peak_rss_bytes", QString::number(FileBin_Stats::PeakRSSBytes())});
+    if (FileBin_Stats::AllocCount() > 0)
+    {
+        new QTreeWidgetItem(counterRoot, {"process.alloc_count", QString::number(FileBin_Stats::AllocCount())});
+        new QTreeWidgetItem(counterRoot, {"process.alloc_bytes", QString::number(FileBin_Stats::AllocBytes())});
+    }
+
+    tree->expandAll();
+    tree->header()->setSectionResizeMode(0, QHeaderView::ResizeToContents);
+
+    QDialogButtonBox* buttons = new QDialogButtonBox(QDialogButtonBox::Close, &dialog);
+    QPushButton* copyButton = buttons->addButton("Copy JSON", QDialogButtonBox::ActionRole);
+    QPushButton* saveButton = buttons->addButton("Save JSON...", QDialogButtonBox::ActionRole);
+
+    connect(buttons, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+    connect(copyButton, &QPushButton::clicked, &dialog, [&stats]
+    {
+        QApplication::clipboard()->setText(QString::fromStdString(stats.ToJSON()));
+    });
+    connect(saveButton, &QPushButton::clicked, &dialog, [&dialog, &stats]
+    {
+        QString fileName = QFileDialog::getSaveFileName(&dialog, "Save statistics", "fynix_stats.json", "JSON (*.json)");
+        if (fileName.isEmpty())
+        {
+            return;
+        }
+
+        std::ofstream out(fileName.toStdString());
+        out << stats.ToJSON();
+    });
+
+    QVBoxLayout* layout = new QVBoxLayout(&dialog);
+    layout->addWidget(tree);
+    layout->addWidget(buttons);
+
+    dialog.exec();
+}
+
 void MainWindow::AddNewBaseFile(QString Filename)
 {
-    FileBin_IntelHex_Memory *newBaseFile = new FileBin_IntelHex_Memory();
-    newBaseFile->Load(Filename.toStdString().c_str(), LIB_FIRMWAREBIN_HEX);
-    this->ui_BinCalibWidget->Calib_BaseFile_AddNew(Filename.toStdString(), newBaseFile);
+    this->ui_BinCalibWidget->Calib_BaseFile_Open(Filename);
 }
 
 void MainWindow::on_actionOpen_triggered(bool checked)
 {
     Q_UNUSED(checked);
 
+    if (this->isElfLoading)
+    {
+        return;
+    }
+
     QString fileNameQt = QFileDialog::getOpenFileName(
         this,
         tr("Open ELF File"),
@@ -869,6 +1178,13 @@ void MainWindow::dragMoveEvent(QDragMoveEvent *event)
 
 void MainWindow::dropEvent(QDropEvent *event)
 {
+    /* Nothing is loaded while loadElf waits for the DWARF parse */
+    if (this->isElfLoading)
+    {
+        event->ignore();
+        return;
+    }
+
     // Handle the dropped data
     if (event->mimeData()->hasUrls())
     {
@@ -890,7 +1206,7 @@ void MainWindow::dropEvent(QDropEvent *event)
 
                 //IsMasterFileLoaded = true;
             }
-            else if (extension == "hex")
+            else if (FileBin_IntelHex_Memory::TypeFromExtension(filePath.toStdString().c_str()) != LIB_FIRMWAREBIN__UNKNOWN)
             {
                 qDebug() << "Dropped image file:" << filePath;
                 ///if (!Mem2[this->BaseFileCnt].Load(filePath.toStdString().c_str(), LIB_FIRMWAREBIN_HEX))
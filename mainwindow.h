@@ -58,6 +58,7 @@ class MainWindow : public QMainWindow
 
     private slots:
         void on_actionOpen_triggered(bool checked);
+        void on_actionLoadStats_triggered(bool checked);
 
     protected:
         void dragEnterEvent(QDragEnterEvent *event) override;
@@ -68,10 +69,12 @@ class MainWindow : public QMainWindow
     private:
         Ui::MainWindow *ui;
         BinCalibToolWidget *ui_BinCalibWidget;
+        bool isElfLoading = false; /* loadElf is waiting for the DWARF parse thread */
 
         void loadElf(std::string file_name);
         void onTreeSelectionChanged(const QItemSelection &selected, const QItemSelection &deselected);
-        void displayBinaryFile(FileBin_VarInfoType *symbol);
+        void displayBinaryFile(FileBin_VarInfoType *symbol, uint32_t Addr);
+        void onHexViewCursorMoved();
         void populateTopLevelSymbol(FileBin_VarInfoType* node, QStandardItem* parentItem);
         void AddNewBaseFile(QString Filename);
 };